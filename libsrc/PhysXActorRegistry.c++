@@ -0,0 +1,292 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "PhysXActorRegistry.h++"
+
+
+PhysXActorRegistry::PhysXActorRegistry(unsigned int initialCapacity)
+{
+   // Round the requested capacity up to a power of two, so that slot
+   // indices can be computed with a shift and a mask rather than a division
+   slot_capacity = 16;
+   hash_shift = 28;
+   while (slot_capacity < initialCapacity)
+   {
+      slot_capacity <<= 1;
+      hash_shift--;
+   }
+
+   // Allocate the table and mark every slot as empty
+   registry_slots = new RegistrySlot[slot_capacity];
+   for (unsigned int i = 0; i < slot_capacity; i++)
+   {
+      registry_slots[i].actor_id = 0;
+      registry_slots[i].actor = NULL;
+   }
+
+   // The registry starts out empty
+   actor_count = 0;
+
+   // Initialize the lock that guards the registry
+   pthread_rwlock_init(&registry_lock, NULL);
+   write_lock_start = 0;
+}
+
+
+PhysXActorRegistry::~PhysXActorRegistry()
+{
+   // Clean up any actors that are still registered, along with the table
+   clear();
+   delete[] registry_slots;
+
+   // Clean up the registry lock
+   pthread_rwlock_destroy(&registry_lock);
+}
+
+
+unsigned int PhysXActorRegistry::getHomeSlot(unsigned int id)
+{
+   // Use Fibonacci (multiplicative) hashing, which spreads the mostly
+   // sequential identifiers handed out by the simulator across the table;
+   // the slot comes from the high bits of the product, since those depend
+   // on all of the bits of the identifier
+   return (id * 2654435769u) >> hash_shift;
+}
+
+
+unsigned int PhysXActorRegistry::findSlot(unsigned int id)
+{
+   unsigned int   index;
+
+   // Probe linearly from the home slot until either the identifier or an
+   // empty slot is found; the table is never allowed to become full, so this
+   // always terminates
+   index = getHomeSlot(id);
+   while (registry_slots[index].actor != NULL &&
+          registry_slots[index].actor_id != id)
+   {
+      index = (index + 1) & (slot_capacity - 1);
+   }
+
+   // Return the slot that was found
+   return index;
+}
+
+
+void PhysXActorRegistry::grow()
+{
+   RegistrySlot *   oldSlots;
+   unsigned int     oldCapacity;
+   unsigned int     index;
+
+   // Keep track of the old table, so its entries can be re-inserted
+   oldSlots = registry_slots;
+   oldCapacity = slot_capacity;
+
+   // Allocate a table twice the size and mark every slot as empty
+   slot_capacity = oldCapacity * 2;
+   hash_shift--;
+   registry_slots = new RegistrySlot[slot_capacity];
+   for (unsigned int i = 0; i < slot_capacity; i++)
+   {
+      registry_slots[i].actor_id = 0;
+      registry_slots[i].actor = NULL;
+   }
+
+   // Re-insert each of the actors from the old table
+   for (unsigned int i = 0; i < oldCapacity; i++)
+   {
+      if (oldSlots[i].actor != NULL)
+      {
+         index = findSlot(oldSlots[i].actor_id);
+         registry_slots[index] = oldSlots[i];
+      }
+   }
+
+   // Clean up the old table
+   delete[] oldSlots;
+}
+
+
+void PhysXActorRegistry::lockRead()
+{
+   unsigned long long   startTime;
+
+   // Acquire the lock, keeping track of how long that took
+   startTime = PhysXHistogram::getTime();
+   pthread_rwlock_rdlock(&registry_lock);
+   lock_wait_times.addSampleSince(startTime);
+}
+
+
+void PhysXActorRegistry::unlockRead()
+{
+   pthread_rwlock_unlock(&registry_lock);
+}
+
+
+void PhysXActorRegistry::lockWrite()
+{
+   unsigned long long   startTime;
+
+   // Acquire the lock, keeping track of how long that took; the time of
+   // acquisition also starts the hold time, which is safe to keep in a member
+   // since only one thread can hold the write lock
+   startTime = PhysXHistogram::getTime();
+   pthread_rwlock_wrlock(&registry_lock);
+   write_lock_start = lock_wait_times.addSampleSince(startTime);
+}
+
+
+void PhysXActorRegistry::unlockWrite()
+{
+   // Keep track of how long the lock was held, then release it
+   lock_hold_times.addSampleSince(write_lock_start);
+   pthread_rwlock_unlock(&registry_lock);
+}
+
+
+void PhysXActorRegistry::getLockTimes(TimeHistogram * waitTimes,
+   TimeHistogram * holdTimes)
+{
+   // Copy both of the histograms
+   lock_wait_times.read(waitTimes);
+   lock_hold_times.read(holdTimes);
+}
+
+
+void PhysXActorRegistry::resetLockTimes()
+{
+   // Clear both of the histograms
+   lock_wait_times.reset();
+   lock_hold_times.reset();
+}
+
+
+PhysXRigidActor * PhysXActorRegistry::getActor(unsigned int id)
+{
+   // Return the actor held by the slot (NULL if the slot is empty)
+   return registry_slots[findSlot(id)].actor;
+}
+
+
+bool PhysXActorRegistry::containsActor(unsigned int id)
+{
+   // The actor exists if its slot is occupied
+   return (registry_slots[findSlot(id)].actor != NULL);
+}
+
+
+bool PhysXActorRegistry::addActor(unsigned int id, PhysXRigidActor * actor)
+{
+   unsigned int   index;
+
+   // A NULL actor would be indistinguishable from an empty slot
+   if (actor == NULL)
+      return false;
+
+   // Keep the load factor at or below one half, so that probe sequences
+   // stay short
+   if ((actor_count + 1) * 2 > slot_capacity)
+      grow();
+
+   // Find the slot for the actor and make sure it isn't already taken
+   index = findSlot(id);
+   if (registry_slots[index].actor != NULL)
+      return false;
+
+   // Store the actor
+   registry_slots[index].actor_id = id;
+   registry_slots[index].actor = actor;
+   actor_count++;
+   return true;
+}
+
+
+PhysXRigidActor * PhysXActorRegistry::removeActor(unsigned int id)
+{
+   PhysXRigidActor *   result;
+   unsigned int        hole;
+   unsigned int        next;
+   unsigned int        home;
+   unsigned int        mask;
+
+   // Find the slot holding the actor and exit if it isn't registered
+   hole = findSlot(id);
+   result = registry_slots[hole].actor;
+   if (result == NULL)
+      return NULL;
+
+   // Empty the slot
+   registry_slots[hole].actor = NULL;
+   actor_count--;
+
+   // Shift back any entries that follow the new hole in the same probe
+   // sequence, so that lookups never need tombstones
+   mask = slot_capacity - 1;
+   next = (hole + 1) & mask;
+   while (registry_slots[next].actor != NULL)
+   {
+      // Check whether the entry's home slot lies cyclically outside of the
+      // range (hole, next]; if it does, the entry can fill the hole
+      home = getHomeSlot(registry_slots[next].actor_id);
+      if (((next - home) & mask) >= ((next - hole) & mask))
+      {
+         // Move the entry into the hole, which then moves to the entry's
+         // old slot
+         registry_slots[hole] = registry_slots[next];
+         registry_slots[next].actor = NULL;
+         hole = next;
+      }
+
+      // Move onto the next slot
+      next = (next + 1) & mask;
+   }
+
+   // Return the removed actor
+   return result;
+}
+
+
+unsigned int PhysXActorRegistry::getNumActors()
+{
+   return actor_count;
+}
+
+
+void PhysXActorRegistry::clear()
+{
+   // Delete every registered actor and empty its slot
+   for (unsigned int i = 0; i < slot_capacity; i++)
+   {
+      if (registry_slots[i].actor != NULL)
+      {
+         delete registry_slots[i].actor;
+         registry_slots[i].actor = NULL;
+      }
+   }
+
+   // The registry is now empty
+   actor_count = 0;
+}
+
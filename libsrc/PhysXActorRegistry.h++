@@ -0,0 +1,203 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PHYSX_ACTOR_REGISTRY_H
+#define PHYSX_ACTOR_REGISTRY_H
+
+#include "PhysXRigidActor.h++"
+#include "PhysXStatistics.h++"
+
+#include "pthread.h"
+
+
+/// Registry that maps actor identifiers to their rigid actors.
+///
+/// The registry is an open-addressed hash table (linear probing with
+/// backward-shift deletion), so looking up an actor never allocates memory.
+/// Access is guarded by a reader-writer lock: any number of threads may hold
+/// the read lock while looking up and operating on existing actors, while
+/// adding or removing actors requires the write lock. The lock is exposed to
+/// the caller, since it must be held for as long as a fetched actor is in
+/// use (otherwise the actor could be removed and deleted underneath it).
+/// The time spent waiting for the lock is always measured, as is the time
+/// that the write lock is held; read locks can be held by several threads at
+/// once, so their hold time isn't measured.
+
+class PhysXActorRegistry
+{
+   protected:
+      /// A single entry of the hash table; a slot is empty when its actor
+      /// is NULL.
+      ///
+      struct RegistrySlot
+      {
+         unsigned int        actor_id;
+         PhysXRigidActor *   actor;
+      };
+
+      /// The table of slots; the capacity is always a power of two.
+      ///
+      RegistrySlot *       registry_slots;
+
+      /// The number of slots in the table.
+      ///
+      unsigned int         slot_capacity;
+
+      /// The shift that turns a hashed identifier into a slot index, which
+      /// is 32 minus the base two logarithm of the capacity.
+      ///
+      unsigned int         hash_shift;
+
+      /// The number of actors currently held by the table.
+      ///
+      unsigned int         actor_count;
+
+      /// Reader-writer lock that ensures the thread-safety of the registry.
+      ///
+      pthread_rwlock_t     registry_lock;
+
+      /// The time spent waiting to acquire either lock.
+      ///
+      PhysXHistogram       lock_wait_times;
+
+      /// The time that the write lock was held for.
+      ///
+      PhysXHistogram       lock_hold_times;
+
+      /// The time at which the write lock was acquired.
+      ///
+      unsigned long long   write_lock_start;
+
+      /// Computes the home slot of the given identifier.
+      ///
+      /// @param id The actor identifier being hashed.
+      ///
+      /// @return The index of the preferred slot for the identifier.
+      ///
+      unsigned int         getHomeSlot(unsigned int id);
+
+      /// Finds the slot that either holds the given identifier or is the
+      /// empty slot where the identifier would be inserted.
+      ///
+      /// @param id The actor identifier being searched for.
+      ///
+      /// @return The index of the slot.
+      ///
+      unsigned int         findSlot(unsigned int id);
+
+      /// Doubles the capacity of the table and re-inserts all of the actors.
+      ///
+      void                 grow();
+
+   public:
+      /// Constructor.
+      ///
+      /// @param initialCapacity The number of slots initially allocated;
+      /// rounded up to the next power of two.
+      ///
+      PhysXActorRegistry(unsigned int initialCapacity);
+
+      /// Destructor. Any actors still held by the registry are deleted.
+      ///
+      ~PhysXActorRegistry();
+
+      /// Acquires the registry for shared (read-only) access.
+      ///
+      void   lockRead();
+
+      /// Releases shared access to the registry.
+      ///
+      void   unlockRead();
+
+      /// Acquires the registry for exclusive access.
+      ///
+      void   lockWrite();
+
+      /// Releases exclusive access to the registry.
+      ///
+      void   unlockWrite();
+
+      /// Copies the times spent waiting for and holding the locks.
+      ///
+      /// @param waitTimes The struct that receives the wait times.
+      /// @param holdTimes The struct that receives the write hold times.
+      ///
+      void   getLockTimes(TimeHistogram * waitTimes,
+         TimeHistogram * holdTimes);
+
+      /// Removes every sample from the lock times.
+      ///
+      void   resetLockTimes();
+
+      /// Fetches the actor with the given identifier. The caller must hold
+      /// either the read or the write lock.
+      ///
+      /// @param id The unique identifier of the desired actor.
+      ///
+      /// @return The actor with the given identifier or NULL if the actor is
+      /// not in the registry.
+      ///
+      PhysXRigidActor *   getActor(unsigned int id);
+
+      /// Checks whether an actor with the given identifier exists. The caller
+      /// must hold either the read or the write lock.
+      ///
+      /// @param id The unique identifier of the actor.
+      ///
+      /// @return True if the actor is in the registry.
+      ///
+      bool   containsActor(unsigned int id);
+
+      /// Adds an actor to the registry. The caller must hold the write lock.
+      ///
+      /// @param id The unique identifier of the actor.
+      /// @param actor The actor being added.
+      ///
+      /// @return True if the actor was added; false if an actor with the same
+      /// identifier already exists or the given actor is NULL.
+      ///
+      bool   addActor(unsigned int id, PhysXRigidActor * actor);
+
+      /// Removes an actor from the registry without deleting it. The caller
+      /// must hold the write lock.
+      ///
+      /// @param id The unique identifier of the actor being removed.
+      ///
+      /// @return The removed actor or NULL if it was not found.
+      ///
+      PhysXRigidActor *   removeActor(unsigned int id);
+
+      /// Returns the number of actors held by the registry.
+      ///
+      /// @return The number of actors.
+      ///
+      unsigned int   getNumActors();
+
+      /// Removes and deletes all actors held by the registry. The caller must
+      /// hold the write lock.
+      ///
+      void   clear();
+};
+
+#endif
+
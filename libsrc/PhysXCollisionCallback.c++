@@ -26,20 +26,345 @@
 #include "PxPhysicsAPI.h"
 #include "atInt.h++"
 
+#include <string.h>
+
 using namespace physx;
 
 
-CollisionProperties * PhysXCollisionCallback::getCollisions(unsigned int * nbCollisions)
+PhysXCollisionCallback::PhysXCollisionCallback()
+{
+   // No array has been given for the collisions yet
+   collision_array = NULL;
+   memset(&collision_arrays, 0, sizeof(collision_arrays));
+   use_collision_arrays = false;
+   collision_count = 0;
+   max_collisions = 0;
+   dropped_count = 0;
+   pair_count = 0;
+   last_pair_count = 0;
+
+   // Report every contact point by default, as has always been done
+   report_mode = COLLISION_REPORT_POINTS;
+
+   // The pair table is allocated once the maximum number of collisions is
+   // known
+   pair_slots = NULL;
+   pair_capacity = 0;
+   pair_generation = 1;
+
+   // Start with room for a reasonable number of contact points per pair
+   contact_buffer_size = 64;
+   contact_buffer = new PxContactPairPoint[contact_buffer_size];
+}
+
+
+PhysXCollisionCallback::~PhysXCollisionCallback()
+{
+   // Clean up the pair table and the contact buffer
+   delete[] pair_slots;
+   delete[] contact_buffer;
+}
+
+
+void PhysXCollisionCallback::reservePairs()
+{
+   unsigned int   newCapacity;
+
+   // Keep the pair table at most half full, so that probe sequences stay
+   // short
+   newCapacity = 16;
+   while (newCapacity < (unsigned int) max_collisions * 2)
+      newCapacity <<= 1;
+
+   // Grow the pair table if needed; the new slots carry generation zero,
+   // which is never used, so they start out empty
+   if (pair_capacity < newCapacity)
+   {
+      delete[] pair_slots;
+      pair_slots = new PairSlot[newCapacity];
+      memset(pair_slots, 0, newCapacity * sizeof(PairSlot));
+      pair_capacity = newCapacity;
+   }
+}
+
+
+void PhysXCollisionCallback::startRecord(int index, unsigned int actorId1,
+   unsigned int actorId2)
+{
+   // Start out with no points, so that the first point accumulated is the
+   // deepest one
+   if (use_collision_arrays)
+   {
+      collision_arrays.ActorId1[index] = actorId1;
+      collision_arrays.ActorId2[index] = actorId2;
+      collision_arrays.PositionX[index] = 0.0f;
+      collision_arrays.PositionY[index] = 0.0f;
+      collision_arrays.PositionZ[index] = 0.0f;
+      collision_arrays.NormalX[index] = 0.0f;
+      collision_arrays.NormalY[index] = 0.0f;
+      collision_arrays.NormalZ[index] = 0.0f;
+      collision_arrays.Penetration[index] = PX_MAX_F32;
+      if (collision_arrays.Impulse != NULL)
+         collision_arrays.Impulse[index] = 0.0f;
+   }
+   else
+   {
+      collision_array[index].ActorId1 = actorId1;
+      collision_array[index].ActorId2 = actorId2;
+      collision_array[index].PositionX = 0.0f;
+      collision_array[index].PositionY = 0.0f;
+      collision_array[index].PositionZ = 0.0f;
+      collision_array[index].NormalX = 0.0f;
+      collision_array[index].NormalY = 0.0f;
+      collision_array[index].NormalZ = 0.0f;
+      collision_array[index].Penetration = PX_MAX_F32;
+   }
+}
+
+
+void PhysXCollisionCallback::writePoint(int index, unsigned int actorId1,
+   unsigned int actorId2, const PxContactPairPoint & point)
+{
+   // Store the point as it is; its normal is already of unit length
+   if (use_collision_arrays)
+   {
+      collision_arrays.ActorId1[index] = actorId1;
+      collision_arrays.ActorId2[index] = actorId2;
+      collision_arrays.PositionX[index] = point.position.x;
+      collision_arrays.PositionY[index] = point.position.y;
+      collision_arrays.PositionZ[index] = point.position.z;
+      collision_arrays.NormalX[index] = point.normal.x;
+      collision_arrays.NormalY[index] = point.normal.y;
+      collision_arrays.NormalZ[index] = point.normal.z;
+      collision_arrays.Penetration[index] = point.separation;
+      if (collision_arrays.Impulse != NULL)
+         collision_arrays.Impulse[index] = point.impulse.magnitude();
+   }
+   else
+   {
+      collision_array[index].ActorId1 = actorId1;
+      collision_array[index].ActorId2 = actorId2;
+      collision_array[index].PositionX = point.position.x;
+      collision_array[index].PositionY = point.position.y;
+      collision_array[index].PositionZ = point.position.z;
+      collision_array[index].NormalX = point.normal.x;
+      collision_array[index].NormalY = point.normal.y;
+      collision_array[index].NormalZ = point.normal.z;
+      collision_array[index].Penetration = point.separation;
+   }
+}
+
+
+void PhysXCollisionCallback::accumulatePoint(int index,
+   const PxContactPairPoint & point, bool flipNormal)
+{
+   PxVec3   normal;
+
+   // Turn the normal around if the actors were reported the other way round
+   if (flipNormal)
+      normal = -point.normal;
+   else
+      normal = point.normal;
+
+   // Sum the normal and impulse, and keep the deepest point; the impulse is
+   // only kept by the structure of arrays layout, and only if it was asked
+   // for
+   if (use_collision_arrays)
+   {
+      collision_arrays.NormalX[index] += normal.x;
+      collision_arrays.NormalY[index] += normal.y;
+      collision_arrays.NormalZ[index] += normal.z;
+      if (collision_arrays.Impulse != NULL)
+         collision_arrays.Impulse[index] += point.impulse.magnitude();
+      if (point.separation < collision_arrays.Penetration[index])
+      {
+         collision_arrays.Penetration[index] = point.separation;
+         collision_arrays.PositionX[index] = point.position.x;
+         collision_arrays.PositionY[index] = point.position.y;
+         collision_arrays.PositionZ[index] = point.position.z;
+      }
+   }
+   else
+   {
+      collision_array[index].NormalX += normal.x;
+      collision_array[index].NormalY += normal.y;
+      collision_array[index].NormalZ += normal.z;
+      if (point.separation < collision_array[index].Penetration)
+      {
+         collision_array[index].Penetration = point.separation;
+         collision_array[index].PositionX = point.position.x;
+         collision_array[index].PositionY = point.position.y;
+         collision_array[index].PositionZ = point.position.z;
+      }
+   }
+}
+
+
+int PhysXCollisionCallback::findPairRecord(unsigned int actorId1,
+   unsigned int actorId2, bool * swapped)
+{
+   unsigned int   index;
+   unsigned int   lowId;
+   unsigned int   highId;
+   PairSlot *     slot;
+
+   // Nothing can be reported until an array has been given
+   if (pair_slots == NULL)
+      return -1;
+
+   // The same pair may be reported with its actors in either order, so hash
+   // the identifiers in a fixed order
+   if (actorId1 < actorId2)
+   {
+      lowId = actorId1;
+      highId = actorId2;
+   }
+   else
+   {
+      lowId = actorId2;
+      highId = actorId1;
+   }
+
+   // Probe linearly from the home slot until either the pair or a slot left
+   // over from a previous step is found
+   index = (lowId * 2654435769u) ^ (highId * 40503u);
+   index &= (pair_capacity - 1);
+   while (pair_slots[index].generation == pair_generation)
+   {
+      slot = &pair_slots[index];
+      if (slot->actor_id1 == actorId1 && slot->actor_id2 == actorId2)
+      {
+         *swapped = false;
+         return slot->record_index;
+      }
+      else if (slot->actor_id1 == actorId2 && slot->actor_id2 == actorId1)
+      {
+         *swapped = true;
+         return slot->record_index;
+      }
+
+      index = (index + 1) & (pair_capacity - 1);
+   }
+
+   // This is the first contact between the two actors during this step, so
+   // start a new record for them if there is room left
+   if (collision_count >= max_collisions)
+      return -1;
+
+   startRecord(collision_count, actorId1, actorId2);
+
+   // Remember which record belongs to the pair
+   slot = &pair_slots[index];
+   slot->actor_id1 = actorId1;
+   slot->actor_id2 = actorId2;
+   slot->generation = pair_generation;
+   slot->record_index = collision_count;
+
+   // Return the index of the new record, which has the actors in the order
+   // they were given
+   collision_count++;
+   *swapped = false;
+   return slot->record_index;
+}
+
+
+void PhysXCollisionCallback::reportPoint(unsigned int actorId1,
+   unsigned int actorId2, const PxContactPairPoint & point)
 {
-   // Set the number of collisions
+   int    index;
+   bool   swapped;
+
+   // Either accumulate the point into the record of the pair of actors, or
+   // give it a record of its own
+   if (report_mode == COLLISION_REPORT_AGGREGATE)
+   {
+      index = findPairRecord(actorId1, actorId2, &swapped);
+      if (index >= 0)
+      {
+         accumulatePoint(index, point, swapped);
+         return;
+      }
+   }
+   else if (collision_count < max_collisions)
+   {
+      writePoint(collision_count, actorId1, actorId2, point);
+      collision_count++;
+      return;
+   }
+
+   // We are only able to make a certain amount of updates for each
+   // simulation step; keep count of what had to be dropped
+   dropped_count++;
+}
+
+
+CollisionProperties * PhysXCollisionCallback::getCollisions(
+   unsigned int * nbCollisions, unsigned int * nbDropped)
+{
+   PxVec3   normal;
+
+   // The normals of aggregated records are sums, so normalize them to get
+   // the average direction; everything else is already in place
+   if (report_mode == COLLISION_REPORT_AGGREGATE)
+   {
+      for (int i = 0; i < collision_count; i++)
+      {
+         if (use_collision_arrays)
+         {
+            normal = PxVec3(collision_arrays.NormalX[i],
+               collision_arrays.NormalY[i], collision_arrays.NormalZ[i]);
+            normal.normalizeSafe();
+            collision_arrays.NormalX[i] = normal.x;
+            collision_arrays.NormalY[i] = normal.y;
+            collision_arrays.NormalZ[i] = normal.z;
+         }
+         else
+         {
+            normal = PxVec3(collision_array[i].NormalX,
+               collision_array[i].NormalY, collision_array[i].NormalZ);
+            normal.normalizeSafe();
+            collision_array[i].NormalX = normal.x;
+            collision_array[i].NormalY = normal.y;
+            collision_array[i].NormalZ = normal.z;
+         }
+      }
+   }
+
+   // Set the number of collisions and the number of dropped points
    *nbCollisions = (unsigned int) collision_count;
+   if (nbDropped != NULL)
+      *nbDropped = dropped_count;
 
    // Reset the number of collisions that have occurred since they have now
    // been sent
    collision_count = 0;
+   dropped_count = 0;
+
+   // Keep the number of contact pairs of the step around for statistics
+   last_pair_count = pair_count;
+   pair_count = 0;
+
+   // Move onto the next generation, which empties the pair table; skip zero
+   // when wrapping around since empty slots carry it
+   pair_generation++;
+   if (pair_generation == 0)
+   {
+      if (pair_slots != NULL)
+         memset(pair_slots, 0, pair_capacity * sizeof(PairSlot));
+      pair_generation = 1;
+   }
 
    // And return the collision update
-   return collision_array;
+   if (use_collision_arrays)
+      return NULL;
+   else
+      return collision_array;
+}
+
+
+unsigned int PhysXCollisionCallback::getContactPairCount()
+{
+   return last_pair_count;
 }
 
 
@@ -48,13 +373,54 @@ void PhysXCollisionCallback::setCollisionsArray(
 {
    // Save the pinned array for collision updates
    collision_array = collisions;
+   use_collision_arrays = false;
    
-   // Store the max size of the collision array
-   max_collisions = max;
+   // Store the max size of the collision array, which is zero without an
+   // array, and make sure the pair table can hold that many collisions
+   if (collisions != NULL && max > 0)
+      max_collisions = max;
+   else
+      max_collisions = 0;
+   reservePairs();
+
+   // Initialize the number of collisions to zero since no collisions have
+   // occurred 
+   collision_count = 0;
+   dropped_count = 0;
+}
+
+
+void PhysXCollisionCallback::setCollisionsArrays(
+   const CollisionArrays * arrays, int max)
+{
+   // Save the pinned arrays for collision updates
+   collision_arrays = *arrays;
+   use_collision_arrays = true;
+
+   // Store the max size of the arrays, which is zero without the arrays,
+   // and make sure the pair table can hold that many collisions
+   if (arrays->ActorId1 != NULL && max > 0)
+      max_collisions = max;
+   else
+      max_collisions = 0;
+   reservePairs();
 
    // Initialize the number of collisions to zero since no collisions have
    // occurred 
    collision_count = 0;
+   dropped_count = 0;
+}
+
+
+bool PhysXCollisionCallback::setReportMode(int mode)
+{
+   // Only accept the modes that are known
+   if (mode != COLLISION_REPORT_POINTS && mode != COLLISION_REPORT_AGGREGATE)
+      return false;
+
+   // Switch to the new mode
+   report_mode = (CollisionReportMode) mode;
+   return true;
 }
 
 
@@ -85,75 +451,62 @@ void PhysXCollisionCallback::onContact(
    PxU32 nbPairs)
 {
    const PxContactPair *   contactPair;
-   int                     bufferSize;
-   int                     numContacts;
+   PxU32                   numContacts;
    atInt *                 actor1ID;
    atInt *                 actor2ID;
 
-   // Initialize the buffer that will hold the contact points of collisions
-   // (we limit this to a fixed maximum for efficiency)
-   bufferSize = 64;
-   PxContactPairPoint   contactPoints[bufferSize];
-   
-   // Iterate through each of the contact pairs
-   for (int i = 0; i < nbPairs; i++)
+   // Actors that have been removed from the scene no longer have valid
+   // identifiers, so their contacts can't be reported
+   if (pairHeader.flags & (PxContactPairHeaderFlag::eREMOVED_ACTOR_0 |
+       PxContactPairHeaderFlag::eREMOVED_ACTOR_1))
+   {
+      return;
+   }
+
+   // For the actors that are involved in the contact, get their IDs which
+   // are stored in the user data, and check that both were retrieved
+   actor1ID = reinterpret_cast<atInt *>(pairHeader.actors[0]->userData);
+   actor2ID = reinterpret_cast<atInt *>(pairHeader.actors[1]->userData);
+   if (actor1ID == NULL || actor2ID == NULL)
+      return;
+
+   // Iterate through each of the contact pairs (one for each pair of shapes
+   // of the two actors)
+   for (PxU32 i = 0; i < nbPairs; i++)
    {
       // Current contact pair
       contactPair = &pairs[i];
 
-      // Check if contact has begun between the two actors
-      if ((contactPair->events & PxPairFlag::eNOTIFY_TOUCH_FOUND) ||
-          (contactPair->events & PxPairFlag::eNOTIFY_TOUCH_PERSISTS))
+      // Only report pairs where contact has begun or persists, and whose
+      // shapes are still attached
+      if (!(contactPair->events & (PxPairFlag::eNOTIFY_TOUCH_FOUND |
+            PxPairFlag::eNOTIFY_TOUCH_PERSISTS)) ||
+          (contactPair->flags & (PxContactPairFlag::eREMOVED_SHAPE_0 |
+            PxContactPairFlag::eREMOVED_SHAPE_1)))
       {
-         // For the actors that are involved in the contact, get
-         // their IDs which are stored in the user data
-         actor1ID = reinterpret_cast<atInt *>(pairHeader.actors[0]->userData);
-         actor2ID = reinterpret_cast<atInt *>(pairHeader.actors[1]->userData);
+         continue;
+      }
 
-         // Check that both actors IDs have been successfully retrieved
-         if (actor1ID != NULL && actor2ID != NULL)
-         {
-            // Get the number of contacts from the contact pair
-            numContacts =
-               contactPair->extractContacts(contactPoints, bufferSize);
-
-            // Loop through all of the collisions that occurred during the last
-            // time step in PhysX
-            for (int j = 0; j < numContacts; j++)
-            {
-               // We are only able to make a certain amount of updates
-               // for each simulation step
-               if (collision_count >= max_collisions)
-                  break;
-
-               // Store the IDs of the actors involved in the collision
-               collision_array[collision_count].ActorId1 = actor1ID->getValue();
-               collision_array[collision_count].ActorId2 = actor2ID->getValue();
-
-               // Get the position and normal of the contact and store
-               // them in the array of updated contact collisions, so
-               // they may be sent out
-               collision_array[collision_count].Penetration =
-                  contactPoints[j].separation;
-               collision_array[collision_count].PositionX =
-                  contactPoints[j].position.x;
-               collision_array[collision_count].PositionY =
-                  contactPoints[j].position.y;
-               collision_array[collision_count].PositionZ =
-                  contactPoints[j].position.z;
-               collision_array[collision_count].NormalX =
-                  contactPoints[j].normal.x;
-               collision_array[collision_count].NormalY =
-                  contactPoints[j].normal.y;
-               collision_array[collision_count].NormalZ =
-                  contactPoints[j].normal.z;
-
-               // Increment count for total collisions
-               collision_count++;
-            }
-
-            break;
-         }
+      // Make sure that the buffer can hold all of the contact points of the
+      // pair
+      if (contactPair->contactCount > contact_buffer_size)
+      {
+         delete[] contact_buffer;
+         while (contact_buffer_size < contactPair->contactCount)
+            contact_buffer_size *= 2;
+         contact_buffer = new PxContactPairPoint[contact_buffer_size];
+      }
+
+      // Count the pair, whether or not its points fit into the array
+      pair_count++;
+
+      // Get the contact points from the contact pair and report each of them
+      numContacts =
+         contactPair->extractContacts(contact_buffer, contact_buffer_size);
+      for (PxU32 j = 0; j < numContacts; j++)
+      {
+         reportPoint(actor1ID->getValue(), actor2ID->getValue(),
+            contact_buffer[j]);
       }
    }
 }
@@ -44,14 +44,66 @@ struct CollisionProperties
 };
 
 
+/// Struct for storing collision data as a structure of arrays, one array per
+/// field, which can be marshalled in bulk. Each array must be able to hold
+/// the maximum number of collisions; the Impulse array may be NULL.
+struct CollisionArrays
+{
+   unsigned int * ActorId1;
+   unsigned int * ActorId2;
+   float * PositionX;
+   float * PositionY;
+   float * PositionZ;
+   float * NormalX;
+   float * NormalY;
+   float * NormalZ;
+   float * Penetration;
+   float * Impulse;
+};
+
+
+/// Enumeration of the ways that contacts can be reported.
+///
+/// COLLISION_REPORT_POINTS: one record for every contact point.
+/// COLLISION_REPORT_AGGREGATE: one record for every pair of actors in
+/// contact, holding the deepest point, the average normal and the total
+/// impulse of all of the points between the two actors.
+enum CollisionReportMode
+{
+   COLLISION_REPORT_POINTS = 0,
+   COLLISION_REPORT_AGGREGATE = 1
+};
+
+
 /// Child class of the PhysX PxSimulationEventCallback that is used to acquire
 /// collision information for OpenSim PhysXPlugin
 
 class PhysXCollisionCallback : public PxSimulationEventCallback
 {
    private:
+      /// Struct for an entry of the table that maps a pair of actors to its
+      /// aggregated record in the output layout; an entry is only valid
+      /// during the step whose generation it carries. The actors are kept in
+      /// the order of the record, which is the order they were first
+      /// reported in.
+      struct PairSlot
+      {
+         unsigned int   actor_id1;
+         unsigned int   actor_id2;
+         unsigned int   generation;
+         int            record_index;
+      };
+
       /// The array that holds the collision information.
       CollisionProperties * collision_array;
+
+      /// The arrays that hold the collision information when the structure
+      /// of arrays layout is in use.
+      CollisionArrays collision_arrays;
+
+      /// Whether the collisions are written to the structure of arrays
+      /// rather than to the array of collision properties.
+      bool use_collision_arrays;
         
       /// The number of collisions that have occurred during this simulation 
       /// step.
@@ -62,18 +114,136 @@ class PhysXCollisionCallback : public PxSimulationEventCallback
       /// memory, that transfers the collision data.
       int max_collisions;
 
+      /// The number of contact points that could not be reported during this
+      /// simulation step, because the collision array was full.
+      unsigned int dropped_count;
+
+      /// The number of contact pairs reported during this simulation step.
+      unsigned int pair_count;
+
+      /// The number of contact pairs reported during the last completed
+      /// simulation step.
+      unsigned int last_pair_count;
+
+      /// The way in which contacts are reported.
+      CollisionReportMode report_mode;
+
+      /// The table used to find the aggregated record of a pair of actors;
+      /// its capacity is always a power of two.
+      PairSlot * pair_slots;
+
+      /// The number of slots in the pair table.
+      unsigned int pair_capacity;
+
+      /// The generation of the current simulation step, which invalidates
+      /// the pair table entries of previous steps without clearing them.
+      unsigned int pair_generation;
+
+      /// The buffer that contact points are extracted into; it grows to fit
+      /// the largest contact pair seen.
+      PxContactPairPoint * contact_buffer;
+
+      /// The number of points the contact buffer can hold.
+      unsigned int contact_buffer_size;
+
+      /// Makes sure that the pair table can hold the maximum number of
+      /// collisions.
+      void   reservePairs();
+
+      /// Starts a record in the output layout for a pair of actors, with no
+      /// points accumulated into it yet.
+      ///
+      /// @param index The index of the record.
+      /// @param actorId1 The identifier of the first actor.
+      /// @param actorId2 The identifier of the second actor.
+      ///
+      void   startRecord(int index, unsigned int actorId1,
+         unsigned int actorId2);
+
+      /// Writes a single contact point to a record in the output layout.
+      ///
+      /// @param index The index of the record.
+      /// @param actorId1 The identifier of the first actor.
+      /// @param actorId2 The identifier of the second actor.
+      /// @param point The contact point.
+      ///
+      void   writePoint(int index, unsigned int actorId1,
+         unsigned int actorId2, const PxContactPairPoint & point);
+
+      /// Accumulates a contact point into an aggregated record in the output
+      /// layout, summing the normals and impulses and keeping the deepest
+      /// point.
+      ///
+      /// @param index The index of the record.
+      /// @param point The contact point.
+      /// @param flipNormal Indicates whether the point was reported with the
+      /// actors in the opposite order of the record, in which case its normal
+      /// points the other way.
+      ///
+      void   accumulatePoint(int index, const PxContactPairPoint & point,
+         bool flipNormal);
+
+      /// Finds the aggregated record of the given pair of actors, creating
+      /// it if this is the first contact between them during this step. The
+      /// pair is found in either order of the actors.
+      ///
+      /// @param actorId1 The identifier of the first actor.
+      /// @param actorId2 The identifier of the second actor.
+      /// @param swapped Receives whether the record has the actors in the
+      /// opposite order.
+      ///
+      /// @return The index of the record, or -1 if the output is full.
+      ///
+      int   findPairRecord(unsigned int actorId1, unsigned int actorId2,
+         bool * swapped);
+
+      /// Adds a single contact point between two actors to the collisions of
+      /// this step, according to the report mode. Points are written to the
+      /// output layout as they are reported, so that the collisions don't
+      /// have to be copied once the step has finished.
+      ///
+      /// @param actorId1 The identifier of the first actor.
+      /// @param actorId2 The identifier of the second actor.
+      /// @param point The contact point.
+      ///
+      void   reportPoint(unsigned int actorId1, unsigned int actorId2,
+         const PxContactPairPoint & point);
+
    public:
+      /// Constructor.
+      ///
+      PhysXCollisionCallback();
+
+      /// Destructor.
+      ///
+      ~PhysXCollisionCallback();
+
       /// Method to acquire the collisions that occurred during the PhysX 
-      /// simulation.
+      /// simulation. The collisions have already been written to the array,
+      /// or arrays, given to the callback while they were reported; only
+      /// the normals of aggregated records are finished here.
       ///
       /// @param nbCollisions This pointer is being passed by reference in 
       /// order to save the number of collisions that will be returned.
+      /// @param nbDropped This pointer is being passed by reference in order
+      /// to save the number of contact points that had to be dropped because
+      /// the collision array was full; may be NULL.
       /// 
       /// @return An array of collision properties that hold the information
-      /// about the collisions that occurred this frame.
+      /// about the collisions that occurred this frame, or NULL when the
+      /// structure of arrays layout is in use.
       ///
-      CollisionProperties *   getCollisions(unsigned int * nbCollisions);
+      CollisionProperties *   getCollisions(unsigned int * nbCollisions,
+         unsigned int * nbDropped);
+
 
+      /// Method to get the number of contact pairs, one for each pair of
+      /// shapes in contact, that were reported during the last simulation
+      /// step whose collisions were acquired.
+      ///
+      /// @return The number of contact pairs.
+      ///
+      unsigned int   getContactPairCount();
 
       /// Method to store the array of collisions for the collision callback 
       /// class.
@@ -84,6 +254,25 @@ class PhysXCollisionCallback : public PxSimulationEventCallback
       ///
       void   setCollisionsArray(CollisionProperties * collisions, int max);
 
+      /// Method to store the structure of arrays that collisions are written
+      /// to, instead of an array of collision properties.
+      ///
+      /// @param arrays The arrays that have been pinned to memory for
+      /// information transfer between managed and unmanaged code.
+      /// @param max The maximum number of collisions that each array can hold.
+      ///
+      void   setCollisionsArrays(const CollisionArrays * arrays, int max);
+
+      /// Sets the way in which contacts are reported.
+      ///
+      /// @param mode Whether every contact point or one aggregated record per
+      /// pair of actors is reported.
+      ///
+      /// @return False if the mode is not one of CollisionReportMode, in
+      /// which case the mode is left unchanged.
+      ///
+      bool   setReportMode(int mode);
+
       /// Inherited method that is currently not being used.
       ///
       void   onConstraintBreak(PxConstraintInfo * constraints, PxU32 count);
@@ -0,0 +1,208 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "PhysXCommandQueue.h++"
+
+#include <string.h>
+
+
+PhysXCommandQueue::PhysXCommandQueue()
+{
+   // Start out with small buffers; they grow as larger batches are queued
+   pending_capacity = 256;
+   pending_commands = new ActorCommand[pending_capacity];
+   pending_count = 0;
+   taken_capacity = 256;
+   taken_commands = new ActorCommand[taken_capacity];
+
+   // No failure array has been supplied yet
+   failure_array = NULL;
+   failure_count = 0;
+   max_failures = 0;
+
+   // Initialize the mutex that guards the queue
+   pthread_mutex_init(&queue_mutex, NULL);
+}
+
+
+PhysXCommandQueue::~PhysXCommandQueue()
+{
+   // Clean up the command buffers
+   delete[] pending_commands;
+   delete[] taken_commands;
+
+   // Clean up the queue mutex
+   pthread_mutex_destroy(&queue_mutex);
+}
+
+
+int PhysXCommandQueue::validateBuffer(void * buffer, int bufferSize)
+{
+   CommandBufferHeader *   header;
+
+   // The buffer has to be at least large enough to hold its header
+   if (buffer == NULL || bufferSize < (int) sizeof(CommandBufferHeader))
+      return -1;
+
+   // Only buffers of the current layout version are understood
+   header = (CommandBufferHeader *) buffer;
+   if (header->Version != PHYSX_COMMAND_BUFFER_VERSION)
+      return -1;
+
+   // Make sure the buffer actually holds all of the commands it claims to
+   if (header->CommandCount > (bufferSize - sizeof(CommandBufferHeader)) /
+       sizeof(ActorCommand))
+   {
+      return -1;
+   }
+
+   // Return the number of commands in the buffer
+   return (int) header->CommandCount;
+}
+
+
+bool PhysXCommandQueue::appendBuffer(void * buffer, int bufferSize)
+{
+   int              commandCount;
+   unsigned int     newCapacity;
+   ActorCommand *   newCommands;
+
+   // Reject the buffer as a whole if it isn't well-formed
+   commandCount = validateBuffer(buffer, bufferSize);
+   if (commandCount < 0)
+      return false;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&queue_mutex);
+
+   // Grow the pending buffer if the new commands won't fit
+   if (pending_count + commandCount > pending_capacity)
+   {
+      newCapacity = pending_capacity;
+      while (pending_count + commandCount > newCapacity)
+         newCapacity *= 2;
+
+      newCommands = new ActorCommand[newCapacity];
+      memcpy(newCommands, pending_commands,
+         pending_count * sizeof(ActorCommand));
+      delete[] pending_commands;
+      pending_commands = newCommands;
+      pending_capacity = newCapacity;
+   }
+
+   // Copy the commands, which directly follow the header, onto the queue
+   memcpy(&pending_commands[pending_count],
+      (char *) buffer + sizeof(CommandBufferHeader),
+      commandCount * sizeof(ActorCommand));
+   pending_count += commandCount;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&queue_mutex);
+   return true;
+}
+
+
+ActorCommand * PhysXCommandQueue::takeCommands(unsigned int * commandCount)
+{
+   ActorCommand *   result;
+   unsigned int     resultCapacity;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&queue_mutex);
+
+   // Swap the pending buffer with the previously taken one, so that new
+   // commands can be queued while these ones are being applied
+   result = pending_commands;
+   resultCapacity = pending_capacity;
+   *commandCount = pending_count;
+   pending_commands = taken_commands;
+   pending_capacity = taken_capacity;
+   pending_count = 0;
+   taken_commands = result;
+   taken_capacity = resultCapacity;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&queue_mutex);
+
+   // Return the commands that were queued
+   return result;
+}
+
+
+void PhysXCommandQueue::setFailureArray(CommandFailure * failures, int max)
+{
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&queue_mutex);
+
+   // Save the pinned array for failure reports along with its size
+   failure_array = failures;
+   max_failures = max;
+
+   // No failures have been recorded into the new array
+   failure_count = 0;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&queue_mutex);
+}
+
+
+void PhysXCommandQueue::recordFailure(ActorCommand * command,
+   CommandStatus status)
+{
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&queue_mutex);
+
+   // Store the failure, as long as there is room left in the array
+   if (failure_array != NULL && failure_count < max_failures)
+   {
+      failure_array[failure_count].ActorID = command->ActorID;
+      failure_array[failure_count].Opcode = command->Opcode;
+      failure_array[failure_count].Status = (unsigned int) status;
+      failure_count++;
+   }
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&queue_mutex);
+}
+
+
+CommandFailure * PhysXCommandQueue::getFailures(unsigned int * nbFailures)
+{
+   CommandFailure *   result;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&queue_mutex);
+
+   // Report the number of failures and reset it, since they have now been
+   // sent
+   *nbFailures = (unsigned int) failure_count;
+   failure_count = 0;
+   result = failure_array;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&queue_mutex);
+
+   // Return the failures
+   return result;
+}
+
@@ -0,0 +1,218 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PHYSX_COMMAND_QUEUE_H
+#define PHYSX_COMMAND_QUEUE_H
+
+#include "pthread.h"
+
+
+/// The version of the command buffer layout understood by this library;
+/// buffers carrying any other version are rejected as a whole.
+#define PHYSX_COMMAND_BUFFER_VERSION   1
+
+
+/// Enumeration of the operations that can be carried by an actor command.
+/// The meaning of the command payload depends on the operation:
+///
+/// SET_TRANSFORMATION: position (x, y, z) then orientation (x, y, z, w)
+/// SET_POSITION: position (x, y, z)
+/// SET_ROTATION: orientation (x, y, z, w)
+/// SET_LINEAR_VELOCITY, SET_ANGULAR_VELOCITY: velocity (x, y, z)
+/// ADD_FORCE, ADD_TORQUE: vector (x, y, z)
+/// SET_GRAVITY: gravity (x, y, z)
+/// ENABLE_GRAVITY: enabled when the first value is non-zero
+/// SET_LINEAR_DAMPING, SET_ANGULAR_DAMPING: the damping coefficient
+/// CLEAR_ALL_FORCES: no payload
+///
+enum CommandOpcode
+{
+   COMMAND_SET_TRANSFORMATION = 1,
+   COMMAND_SET_POSITION = 2,
+   COMMAND_SET_ROTATION = 3,
+   COMMAND_SET_LINEAR_VELOCITY = 4,
+   COMMAND_SET_ANGULAR_VELOCITY = 5,
+   COMMAND_ADD_FORCE = 6,
+   COMMAND_ADD_TORQUE = 7,
+   COMMAND_SET_GRAVITY = 8,
+   COMMAND_ENABLE_GRAVITY = 9,
+   COMMAND_SET_LINEAR_DAMPING = 10,
+   COMMAND_SET_ANGULAR_DAMPING = 11,
+   COMMAND_CLEAR_ALL_FORCES = 12
+};
+
+
+/// Enumeration of the outcomes of applying a single actor command.
+///
+enum CommandStatus
+{
+   COMMAND_SUCCEEDED = 0,
+   COMMAND_ACTOR_NOT_FOUND = 1,
+   COMMAND_UNKNOWN_OPCODE = 2,
+   COMMAND_ACTOR_NOT_DYNAMIC = 3,
+   COMMAND_QUEUED = 4
+};
+
+
+/// Struct that starts every command buffer; it is immediately followed by
+/// CommandCount ActorCommand records.
+///
+struct CommandBufferHeader
+{
+   unsigned int   Version;
+   unsigned int   CommandCount;
+};
+
+
+/// Struct for a single command that changes the state of an actor.
+///
+struct ActorCommand
+{
+   unsigned int   ActorID;
+   unsigned int   Opcode;
+   float          Data[7];
+};
+
+
+/// Struct for reporting a command that failed to apply.
+///
+struct CommandFailure
+{
+   unsigned int   ActorID;
+   unsigned int   Opcode;
+   unsigned int   Status;
+};
+
+
+/// Queue of actor commands that are waiting to be applied to the scene, along
+/// with the failures of commands that have already been applied from it.
+///
+/// Batches are appended to a pending buffer and handed over to the consumer
+/// by swapping it with a second buffer, so that new batches can be queued
+/// while the previous ones are being applied.
+
+class PhysXCommandQueue
+{
+   protected:
+      /// The commands waiting to be applied.
+      ///
+      ActorCommand *      pending_commands;
+
+      /// The number of commands waiting to be applied.
+      ///
+      unsigned int        pending_count;
+
+      /// The number of commands the pending buffer can hold.
+      ///
+      unsigned int        pending_capacity;
+
+      /// The buffer handed over to the consumer by the last swap.
+      ///
+      ActorCommand *      taken_commands;
+
+      /// The number of commands the taken buffer can hold.
+      ///
+      unsigned int        taken_capacity;
+
+      /// The array, pinned by the caller, that receives command failures.
+      ///
+      CommandFailure *    failure_array;
+
+      /// The number of failures recorded since they were last fetched.
+      ///
+      int                 failure_count;
+
+      /// The maximum number of failures the failure array can hold.
+      ///
+      int                 max_failures;
+
+      /// Mutex object that ensures the thread-safety of the queue.
+      ///
+      pthread_mutex_t     queue_mutex;
+
+   public:
+      /// Constructor.
+      ///
+      PhysXCommandQueue();
+
+      /// Destructor.
+      ///
+      ~PhysXCommandQueue();
+
+      /// Checks that the given buffer is a well-formed command buffer.
+      ///
+      /// @param buffer The command buffer, starting with its header.
+      /// @param bufferSize The size of the buffer in bytes.
+      ///
+      /// @return The number of commands in the buffer, or -1 if the buffer
+      /// is invalid or of an unsupported version.
+      ///
+      static int   validateBuffer(void * buffer, int bufferSize);
+
+      /// Copies the commands of a command buffer to the end of the queue.
+      ///
+      /// @param buffer The command buffer, starting with its header.
+      /// @param bufferSize The size of the buffer in bytes.
+      ///
+      /// @return True if the buffer was valid and queued.
+      ///
+      bool   appendBuffer(void * buffer, int bufferSize);
+
+      /// Hands all of the queued commands over to the caller and empties the
+      /// queue. The returned array remains valid until the next call.
+      ///
+      /// @param commandCount Passed by reference value that returns the
+      /// number of commands in the returned array.
+      ///
+      /// @return The array of commands that were queued.
+      ///
+      ActorCommand *   takeCommands(unsigned int * commandCount);
+
+      /// Stores the array that receives failures of queued commands.
+      ///
+      /// @param failures The array of failures that has been pinned to
+      /// memory for information transfer between managed and unmanaged code.
+      /// @param max The maximum number of failures that the array can hold.
+      ///
+      void   setFailureArray(CommandFailure * failures, int max);
+
+      /// Records that a queued command failed to apply; failures beyond the
+      /// size of the failure array are dropped.
+      ///
+      /// @param command The command that failed.
+      /// @param status The reason that the command failed.
+      ///
+      void   recordFailure(ActorCommand * command, CommandStatus status);
+
+      /// Method to acquire the failures recorded since the last call.
+      ///
+      /// @param nbFailures Passed by reference value that returns the number
+      /// of failures that were written to the failure array.
+      ///
+      /// @return The array of failures.
+      ///
+      CommandFailure *   getFailures(unsigned int * nbFailures);
+};
+
+#endif
+
@@ -0,0 +1,494 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "PhysXHeightField.h++"
+
+#include "pthread.h"
+
+#include <string.h>
+
+
+// The number of posts above which the conversion to samples is split over
+// several threads; below this, starting the threads costs more than it saves
+#define PHYSX_HEIGHT_FIELD_PARALLEL_POSTS   65536
+
+
+// Description of a block of rows of posts to be converted into samples by a
+// single thread
+struct PostConversionJob
+{
+   const float *           posts;
+   int                     post_stride;
+   int                     first_row;
+   int                     last_row;
+   int                     columns;
+   float                   inverse_scale;
+   PxHeightFieldSample *   samples;
+};
+
+
+// Converts the rows of posts described by the given job into samples; used
+// as the entry point of the conversion threads
+static void * convertPostRows(void * jobData)
+{
+   PostConversionJob *     job;
+   const float *           postRow;
+   PxHeightFieldSample *   sampleRow;
+   float                   height;
+
+   // Go through each row of the job
+   job = (PostConversionJob *) jobData;
+   for (int row = job->first_row; row < job->last_row; row++)
+   {
+      postRow = job->posts + row * job->post_stride;
+      sampleRow = job->samples + row * job->columns;
+
+      for (int column = 0; column < job->columns; column++)
+      {
+         // Scale the post to the 16 bit sample height, multiplying by the
+         // reciprocal of the scale rather than dividing, and clamp it to the
+         // range of the sample rather than letting it wrap around
+         // NOTE: The posts are scaled to match PhysX data, but as this can
+         // cause a loss of precision, an expanding scale is used to preserve
+         // as much precision as possible
+         height = postRow[column] * job->inverse_scale;
+         if (height > 32767.0f)
+            height = 32767.0f;
+         if (height < -32768.0f)
+            height = -32768.0f;
+         sampleRow[column].height = (PxI16) height;
+
+         // For now, differing materials are not supported in the height
+         // field, so the default material indices are used
+         sampleRow[column].materialIndex0 = 1;
+         sampleRow[column].materialIndex1 = 1;
+      }
+   }
+
+   return NULL;
+}
+
+
+PhysXHeightField::PhysXHeightField(PxPhysics * physics, PxCooking * cooking,
+   int maxThreads)
+{
+   // Set the name of this class for notifications
+   setName("[PhysXHeightField] ");
+
+   // Keep reference to the objects used to create the terrain
+   px_physics = physics;
+   px_cooking = cooking;
+
+   // Create the material once, so that it is shared by every tile
+   // TODO: Allow this to be passed in rather than assuming the default for
+   // OpenSim
+   terrain_material = px_physics->createMaterial(0.2f, 0.2f, 0.0f);
+
+   // The terrain is empty until it is built
+   tiles = NULL;
+   tile_count = 0;
+   first_shape_id = 0;
+   tile_size = 0;
+   nb_rows = 0;
+   nb_columns = 0;
+   row_spacing = 0.0f;
+   column_spacing = 0.0f;
+   height_scale = 1.0f;
+
+   // No patches are waiting to be applied
+   queued_patches = NULL;
+   last_queued_patch = NULL;
+
+   // Always use at least the calling thread for conversions
+   if (maxThreads > 0)
+      max_threads = maxThreads;
+   else
+      max_threads = 1;
+}
+
+
+PhysXHeightField::~PhysXHeightField()
+{
+   QueuedPatch *   patch;
+
+   // Release the height fields; the shapes are released by the actor that
+   // they were attached to
+   for (int i = 0; i < tile_count; i++)
+      tiles[i].height_field->release();
+   delete[] tiles;
+
+   // Clean up the memory used by the material
+   terrain_material->release();
+
+   // Discard any patches that were never applied
+   while (queued_patches != NULL)
+   {
+      patch = queued_patches;
+      queued_patches = patch->next;
+      delete[] patch->posts;
+      delete patch;
+   }
+}
+
+
+void PhysXHeightField::convertPosts(const float * posts, int postStride,
+   int blockRows, int blockColumns, PxHeightFieldSample * samples)
+{
+   PostConversionJob   jobs[16];
+   pthread_t           threads[16];
+   int                 threadCount;
+   int                 rowsPerThread;
+
+   // Split the block into bands of rows, using a single band unless the block
+   // is large enough to be worth the threads
+   threadCount = 1;
+   if (blockRows * blockColumns >= PHYSX_HEIGHT_FIELD_PARALLEL_POSTS)
+   {
+      threadCount = max_threads;
+      if (threadCount > 16)
+         threadCount = 16;
+      if (threadCount > blockRows)
+         threadCount = blockRows;
+   }
+   rowsPerThread = (blockRows + threadCount - 1) / threadCount;
+
+   // Describe the band of each thread
+   for (int i = 0; i < threadCount; i++)
+   {
+      jobs[i].posts = posts;
+      jobs[i].post_stride = postStride;
+      jobs[i].first_row = i * rowsPerThread;
+      jobs[i].last_row = (i + 1) * rowsPerThread;
+      if (jobs[i].last_row > blockRows)
+         jobs[i].last_row = blockRows;
+      jobs[i].columns = blockColumns;
+      jobs[i].inverse_scale = 1.0f / height_scale;
+      jobs[i].samples = samples;
+   }
+
+   // Start a thread for every band but the first, which is converted on the
+   // calling thread; if a thread can't be started, convert its band here
+   for (int i = 1; i < threadCount; i++)
+   {
+      if (pthread_create(&threads[i], NULL, convertPostRows, &jobs[i]) != 0)
+      {
+         convertPostRows(&jobs[i]);
+         jobs[i].samples = NULL;
+      }
+   }
+   convertPostRows(&jobs[0]);
+
+   // Wait for the other threads to finish
+   for (int i = 1; i < threadCount; i++)
+   {
+      if (jobs[i].samples != NULL)
+         pthread_join(threads[i], NULL);
+   }
+}
+
+
+bool PhysXHeightField::build(int rows, int columns, float rowSpacing,
+   float columnSpacing, float heightScale, int tileSize, float * posts)
+{
+   PxHeightFieldDesc         heightFieldDescription;
+   PxHeightFieldSample *     samples;
+   HeightFieldTile *         tile;
+   int                       step;
+   int                       tilesPerColumn;
+   int                       tilesPerRow;
+
+   // Store the layout of the terrain
+   nb_rows = rows;
+   nb_columns = columns;
+   row_spacing = rowSpacing;
+   column_spacing = columnSpacing;
+   height_scale = heightScale;
+
+   // Only split the terrain into tiles if they are smaller than the terrain
+   if (tileSize >= 2 && (tileSize < rows || tileSize < columns))
+      tile_size = tileSize;
+   else
+      tile_size = 0;
+
+   // Neighbouring tiles share the posts along their common edge, so each tile
+   // starts one post before the previous one ends
+   if (tile_size > 0)
+      step = tile_size - 1;
+   else
+      step = (rows > columns ? rows : columns);
+   tilesPerColumn = (rows - 2) / step + 1;
+   tilesPerRow = (columns - 2) / step + 1;
+
+   // Lay out the tiles
+   tile_count = tilesPerColumn * tilesPerRow;
+   tiles = new HeightFieldTile[tile_count];
+   for (int i = 0; i < tilesPerColumn; i++)
+   {
+      for (int j = 0; j < tilesPerRow; j++)
+      {
+         tile = &tiles[i * tilesPerRow + j];
+         tile->first_row = i * step;
+         tile->first_column = j * step;
+         tile->nb_rows = rows - tile->first_row;
+         if (tile_size > 0 && tile->nb_rows > tile_size)
+            tile->nb_rows = tile_size;
+         tile->nb_columns = columns - tile->first_column;
+         if (tile_size > 0 && tile->nb_columns > tile_size)
+            tile->nb_columns = tile_size;
+         tile->height_field = NULL;
+         tile->shape = NULL;
+      }
+   }
+
+   // Create the height field and shape of each tile
+   for (int i = 0; i < tile_count; i++)
+   {
+      tile = &tiles[i];
+
+      // Convert the tile's posts into samples
+      samples = new PxHeightFieldSample[tile->nb_rows * tile->nb_columns];
+      convertPosts(posts + tile->first_row * columns + tile->first_column,
+         columns, tile->nb_rows, tile->nb_columns, samples);
+
+      // Describe the tile's height field, using 16 bit integer heights
+      // For now, add a default thickness of 10 units to handle odd collision
+      // cases
+      heightFieldDescription.nbRows = tile->nb_rows;
+      heightFieldDescription.nbColumns = tile->nb_columns;
+      heightFieldDescription.thickness = -10.0f;
+      heightFieldDescription.format = PxHeightFieldFormat::eS16_TM;
+      heightFieldDescription.samples.data = samples;
+      heightFieldDescription.samples.stride = sizeof(PxHeightFieldSample);
+
+      // Cook the height field using the description that was just created
+      tile->height_field = px_cooking->createHeightField(
+         heightFieldDescription, px_physics->getPhysicsInsertionCallback());
+      delete[] samples;
+
+      // Check that the height field was successfully created
+      if (tile->height_field == NULL)
+      {
+         notify(AT_ERROR, "Failed to create height field.\n");
+         break;
+      }
+
+      // Use the height field, scale and spacing of posts to create the shape
+      tile->shape = px_physics->createShape(
+         PxHeightFieldGeometry(tile->height_field, PxMeshGeometryFlags(),
+            height_scale, row_spacing, column_spacing),
+         *terrain_material, true);
+
+      // Rotate the height field to the correct world orientation and move it
+      // to where the tile's first post lies, because the height field is just
+      // a list of heights and doesn't include the position or orientation
+      tile->shape->setLocalPose(PxTransform(
+         PxVec3(tile->first_column * column_spacing,
+            tile->first_row * row_spacing, 0.0f),
+         PxQuat(0.5f, 0.5f, 0.5f, 0.5f)));
+   }
+
+   // If any tile failed, clean up the ones that were created, leaving an
+   // empty terrain
+   if (tile_count > 0 && tiles[tile_count - 1].shape == NULL)
+   {
+      for (int i = 0; i < tile_count; i++)
+      {
+         if (tiles[i].shape != NULL)
+            tiles[i].shape->release();
+         if (tiles[i].height_field != NULL)
+            tiles[i].height_field->release();
+      }
+      delete[] tiles;
+      tiles = NULL;
+      tile_count = 0;
+      return false;
+   }
+
+   // The terrain was built
+   return true;
+}
+
+
+void PhysXHeightField::attachTo(PhysXRigidActor * actor,
+   unsigned int firstShapeID)
+{
+   // Remember where the tile identifiers start, so they can be recognized
+   first_shape_id = firstShapeID;
+
+   // Add the shape of each tile to the actor (use a 0 density, as it will not
+   // matter for the static height field)
+   for (int i = 0; i < tile_count; i++)
+      actor->addShape(firstShapeID + i, tiles[i].shape, 0.0f);
+}
+
+
+bool PhysXHeightField::ownsShape(unsigned int shapeID)
+{
+   // The tiles use consecutive identifiers, starting at the first one
+   return (shapeID >= first_shape_id &&
+      shapeID - first_shape_id < (unsigned int) tile_count);
+}
+
+
+bool PhysXHeightField::hasLayout(int rows, int columns, float rowSpacing,
+   float columnSpacing, float heightScale, int tileSize)
+{
+   // Tile sizes that don't split the terrain amount to a single tile
+   if (tileSize < 2 || (tileSize >= rows && tileSize >= columns))
+      tileSize = 0;
+
+   // Compare against the layout of this terrain
+   return (tile_count > 0 && rows == nb_rows && columns == nb_columns &&
+      rowSpacing == row_spacing && columnSpacing == column_spacing &&
+      heightScale == height_scale && tileSize == tile_size);
+}
+
+
+bool PhysXHeightField::containsRectangle(int startRow, int startColumn,
+   int rows, int columns)
+{
+   // The rectangle has to be non-empty and end within the rows and columns
+   // of the terrain
+   return (startRow >= 0 && startColumn >= 0 && rows > 0 && columns > 0 &&
+      startRow + rows <= nb_rows && startColumn + columns <= nb_columns);
+}
+
+
+bool PhysXHeightField::update(int startRow, int startColumn, int rows,
+   int columns, float * posts, int postStride)
+{
+   PxHeightFieldDesc       heightFieldDescription;
+   PxHeightFieldSample *   samples;
+   HeightFieldTile *       tile;
+   int                     firstRow;
+   int                     lastRow;
+   int                     firstColumn;
+   int                     lastColumn;
+
+   // Make sure that the rectangle lies within the terrain
+   if (!containsRectangle(startRow, startColumn, rows, columns))
+      return false;
+
+   // The samples of any single tile fit into a buffer the size of the
+   // rectangle
+   samples = new PxHeightFieldSample[rows * columns];
+
+   // Go through the tiles that overlap the rectangle
+   for (int i = 0; i < tile_count; i++)
+   {
+      // Find the part of the rectangle that lies within the tile, skipping
+      // the tile if there is none
+      tile = &tiles[i];
+      firstRow = PxMax(startRow, tile->first_row);
+      lastRow = PxMin(startRow + rows, tile->first_row + tile->nb_rows);
+      firstColumn = PxMax(startColumn, tile->first_column);
+      lastColumn =
+         PxMin(startColumn + columns, tile->first_column + tile->nb_columns);
+      if (firstRow >= lastRow || firstColumn >= lastColumn)
+         continue;
+
+      // Convert the overlapping posts into samples
+      convertPosts(posts + (firstRow - startRow) * postStride +
+         (firstColumn - startColumn), postStride, lastRow - firstRow,
+         lastColumn - firstColumn, samples);
+
+      // Patch the samples into the tile's height field, shrinking its bounds
+      // if the terrain was lowered
+      heightFieldDescription.nbRows = lastRow - firstRow;
+      heightFieldDescription.nbColumns = lastColumn - firstColumn;
+      heightFieldDescription.format = PxHeightFieldFormat::eS16_TM;
+      heightFieldDescription.samples.data = samples;
+      heightFieldDescription.samples.stride = sizeof(PxHeightFieldSample);
+      tile->height_field->modifySamples(firstColumn - tile->first_column,
+         firstRow - tile->first_row, heightFieldDescription, true);
+
+      // Set the geometry of the shape again, so that PhysX picks up the new
+      // bounds of the height field
+      tile->shape->setGeometry(PxHeightFieldGeometry(tile->height_field,
+         PxMeshGeometryFlags(), height_scale, row_spacing, column_spacing));
+   }
+
+   // Clean up the sample buffer
+   delete[] samples;
+   return true;
+}
+
+
+bool PhysXHeightField::queueUpdate(int startRow, int startColumn, int rows,
+   int columns, float * posts, int postStride)
+{
+   QueuedPatch *   patch;
+
+   // Make sure that the rectangle lies within the terrain
+   if (!containsRectangle(startRow, startColumn, rows, columns))
+      return false;
+
+   // Copy the posts of the rectangle, since the caller's array may change
+   // before the patch is applied
+   patch = new QueuedPatch;
+   patch->start_row = startRow;
+   patch->start_column = startColumn;
+   patch->nb_rows = rows;
+   patch->nb_columns = columns;
+   patch->posts = new float[rows * columns];
+   patch->next = NULL;
+   for (int row = 0; row < rows; row++)
+   {
+      memcpy(&patch->posts[row * columns], &posts[row * postStride],
+         columns * sizeof(float));
+   }
+
+   // Add the patch to the end of the queue, so that overlapping patches are
+   // applied in the order that they were made
+   if (last_queued_patch != NULL)
+      last_queued_patch->next = patch;
+   else
+      queued_patches = patch;
+   last_queued_patch = patch;
+   return true;
+}
+
+
+int PhysXHeightField::applyQueuedUpdates()
+{
+   QueuedPatch *   patch;
+   int             patchCount;
+
+   // Apply each of the patches in turn and clean it up
+   patchCount = 0;
+   while (queued_patches != NULL)
+   {
+      patch = queued_patches;
+      queued_patches = patch->next;
+      update(patch->start_row, patch->start_column, patch->nb_rows,
+         patch->nb_columns, patch->posts, patch->nb_columns);
+      delete[] patch->posts;
+      delete patch;
+      patchCount++;
+   }
+
+   // The queue is now empty
+   last_queued_patch = NULL;
+   return patchCount;
+}
+
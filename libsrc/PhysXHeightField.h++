@@ -0,0 +1,253 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PHYSX_HEIGHT_FIELD_H
+#define PHYSX_HEIGHT_FIELD_H
+
+#include "PxPhysicsAPI.h"
+
+#include "PhysXRigidActor.h++"
+
+#include "atNotifier.h++"
+
+
+using namespace physx;
+
+
+/// Terrain built from one or more PhysX height fields.
+///
+/// The posts of the terrain can be split into square tiles, each with a
+/// height field and shape of its own, so that large regions don't end up in a
+/// single huge height field. Neighbouring tiles share the posts along their
+/// common edge, so there are no gaps between them. Changes to the posts can
+/// be patched into the existing height fields in place, which keeps the
+/// terrain actor, its shapes and the contacts resting on them intact.
+
+class PhysXHeightField : public atNotifier
+{
+   protected:
+      /// A single tile of the terrain.
+      ///
+      struct HeightFieldTile
+      {
+         PxHeightField *   height_field;
+         PxShape *         shape;
+         int               first_row;
+         int               first_column;
+         int               nb_rows;
+         int               nb_columns;
+      };
+
+      /// A patch that was queued while a simulation step was in flight,
+      /// with its own copy of the posts.
+      ///
+      struct QueuedPatch
+      {
+         int               start_row;
+         int               start_column;
+         int               nb_rows;
+         int               nb_columns;
+         float *           posts;
+         QueuedPatch *     next;
+      };
+
+      /// The physics object that creates the shapes.
+      ///
+      PxPhysics *          px_physics;
+
+      /// The cooking library that creates the height fields.
+      ///
+      PxCooking *          px_cooking;
+
+      /// The material shared by every tile of the terrain.
+      ///
+      PxMaterial *         terrain_material;
+
+      /// The tiles of the terrain.
+      ///
+      HeightFieldTile *    tiles;
+
+      /// The number of tiles.
+      ///
+      int                  tile_count;
+
+      /// The shape identifier of the first tile, once the shapes have been
+      /// attached to an actor.
+      ///
+      unsigned int         first_shape_id;
+
+      /// The number of posts along a tile edge, or zero for a single tile.
+      ///
+      int                  tile_size;
+
+      /// The number of rows of posts in the terrain.
+      ///
+      int                  nb_rows;
+
+      /// The number of columns of posts in the terrain.
+      ///
+      int                  nb_columns;
+
+      /// The distance between rows of posts.
+      ///
+      float                row_spacing;
+
+      /// The distance between columns of posts.
+      ///
+      float                column_spacing;
+
+      /// The factor that converts the stored sample heights back to posts.
+      ///
+      float                height_scale;
+
+      /// The maximum number of threads used to convert posts to samples.
+      ///
+      int                  max_threads;
+
+      /// The patches waiting to be applied, oldest first.
+      ///
+      QueuedPatch *        queued_patches;
+
+      /// The most recently queued patch.
+      ///
+      QueuedPatch *        last_queued_patch;
+
+      /// Checks whether a rectangle of posts lies within the terrain.
+      ///
+      /// @return True if the rectangle is inside of the terrain.
+      ///
+      bool   containsRectangle(int startRow, int startColumn, int rows,
+         int columns);
+
+      /// Converts a block of posts into height field samples, splitting the
+      /// work over several threads when the block is large.
+      ///
+      /// @param posts The first post of the block.
+      /// @param postStride The number of posts between consecutive rows.
+      /// @param blockRows The number of rows in the block.
+      /// @param blockColumns The number of columns in the block.
+      /// @param samples The array that receives the samples, row by row.
+      ///
+      void   convertPosts(const float * posts, int postStride,
+         int blockRows, int blockColumns, PxHeightFieldSample * samples);
+
+   public:
+      /// Constructor.
+      ///
+      /// @param physics The physics object that creates the shapes.
+      /// @param cooking The cooking library that creates the height fields.
+      /// @param maxThreads The maximum number of threads used to convert
+      /// posts to samples.
+      ///
+      PhysXHeightField(PxPhysics * physics, PxCooking * cooking,
+         int maxThreads);
+
+      /// Destructor. The shapes belong to the actor they were attached to,
+      /// but the height fields and material are released here.
+      ///
+      ~PhysXHeightField();
+
+      /// Builds the height fields and shapes of the terrain.
+      ///
+      /// @param rows The number of rows of posts.
+      /// @param columns The number of columns of posts.
+      /// @param rowSpacing The distance between rows of posts.
+      /// @param columnSpacing The distance between columns of posts.
+      /// @param heightScale The factor that converts posts to sample heights.
+      /// @param tileSize The number of posts along a tile edge, or zero to
+      /// build a single height field.
+      /// @param posts The heights of the posts, row by row.
+      ///
+      /// @return True if all of the tiles were built.
+      ///
+      bool   build(int rows, int columns, float rowSpacing,
+         float columnSpacing, float heightScale, int tileSize, float * posts);
+
+      /// Attaches the shapes of the terrain to an actor. Each tile uses its
+      /// own shape identifier, counting up from the given one.
+      ///
+      /// @param actor The static actor that holds the terrain.
+      /// @param firstShapeID The shape identifier of the first tile.
+      ///
+      void   attachTo(PhysXRigidActor * actor, unsigned int firstShapeID);
+
+      /// Checks whether a shape identifier belongs to one of the tiles that
+      /// were attached to the terrain actor.
+      ///
+      /// @param shapeID The shape identifier to check.
+      ///
+      /// @return True if the shape is one of the terrain's tiles.
+      ///
+      bool   ownsShape(unsigned int shapeID);
+
+      /// Checks whether the terrain has the given layout, in which case its
+      /// posts can be replaced in place.
+      ///
+      /// @return True if the layout is the same.
+      ///
+      bool   hasLayout(int rows, int columns, float rowSpacing,
+         float columnSpacing, float heightScale, int tileSize);
+
+      /// Replaces the heights of a rectangle of posts in place. The caller
+      /// must hold the scene's write lock, and no simulation step may be in
+      /// flight.
+      ///
+      /// @param startRow The first row of the rectangle.
+      /// @param startColumn The first column of the rectangle.
+      /// @param rows The number of rows in the rectangle.
+      /// @param columns The number of columns in the rectangle.
+      /// @param posts The new heights of the rectangle's posts.
+      /// @param postStride The number of posts between consecutive rows of
+      /// the posts array.
+      ///
+      /// @return True if the rectangle was inside of the terrain and the
+      /// posts were updated.
+      ///
+      bool   update(int startRow, int startColumn, int rows, int columns,
+         float * posts, int postStride);
+
+      /// Queues a patch of the heights of a rectangle of posts, to be applied
+      /// by applyQueuedUpdates. This is how patches are made while a
+      /// simulation step is in flight, since the height fields can't be
+      /// modified until the step has finished. The posts are copied, and
+      /// the caller must hold the scene's write lock.
+      ///
+      /// The parameters are the same as those of update.
+      ///
+      /// @return True if the rectangle was inside of the terrain and the
+      /// patch was queued.
+      ///
+      bool   queueUpdate(int startRow, int startColumn, int rows,
+         int columns, float * posts, int postStride);
+
+      /// Applies the queued patches in the order that they were queued. The
+      /// caller must hold the scene's write lock, and no simulation step may
+      /// be in flight.
+      ///
+      /// @return The number of patches that were applied.
+      ///
+      int    applyQueuedUpdates();
+};
+
+#endif
+
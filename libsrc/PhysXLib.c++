@@ -22,19 +22,29 @@
 
 
 #include <iostream>
+#include <string.h>
 #include "PhysXLib.h++"
+#include "PhysXActorRegistry.h++"
+#include "PhysXCommandQueue.h++"
+#include "PhysXHeightField.h++"
+#include "PhysXMeshCache.h++"
+#include "PhysXRecorder.h++"
+#include "PhysXSceneQuery.h++"
+#include "PhysXStatistics.h++"
 
 #include "atMap.h++"
 #include "atNotifier.h++"
 
-#ifdef LIB_PHYSX_DEBUG
-   #include "atTimer.h++"
-#endif
+#include "atTimer.h++"
 
 #include "cuda.h"
 
 #include "pthread.h"
 
+#ifdef _WIN32
+   #include <windows.h>
+#endif
+
 
 #ifdef _WIN32
 #define PHYSX_API extern "C" __declspec(dllexport)
@@ -46,51 +56,420 @@ using namespace std;
 using namespace physx;
 
 
+// The largest number of scenes that can exist at the same time
+#define PHYSX_MAX_SCENES 64
+
+
+// The statistics that are gathered for a single scene; the counters are only
+// written while the scene's write lock is held
+struct SceneStatistics
+{
+   PhysXHistogram         simulate_times;
+   PhysXHistogram         fetch_times;
+   PhysXHistogram         update_times;
+   PhysXHistogram         collision_times;
+   PhysXHistogram         lock_wait_times;
+   PhysXHistogram         lock_hold_times;
+   PhysXHistogram         cook_times;
+   unsigned long long     write_lock_start;
+
+   unsigned int           active_actors;
+   unsigned int           contact_pairs;
+   unsigned int           truncated_updates;
+   unsigned int           truncated_collisions;
+};
+
+
+// The state of a single scene; everything that the simulation of one scene
+// touches lives here, so that separate scenes can be stepped concurrently
+struct PhysXScene
+{
+   PxScene *                  px_scene;
+   PxDefaultCpuDispatcher *   cpu_dispatcher;
+   bool                       uses_shared_dispatcher;
+   int                        cpu_threads;
+   bool                       scene_initialized;
+
+   PhysXActorRegistry *       actor_registry;
+   atMap *                    joint_map;
+   PhysXCommandQueue *        command_queue;
+   PhysXCollisionCallback *   px_collisions;
+
+   PxRigidStatic *            ground_plane;
+
+   PhysXHeightField *         terrain;
+   unsigned int               terrain_actor_id;
+   int                        terrain_tile_size;
+
+   int                        max_updates;
+   int                        max_collisions;
+   EntityProperties *         update_buffers[2];
+   CollisionProperties *      collision_buffers[2];
+   CollisionArrays            collision_array_buffers[2];
+   bool                       use_collision_arrays;
+   unsigned int               dropped_collisions;
+   int                        current_buffer;
+   bool                       simulation_running;
+
+   atTimer *                  step_timer;
+   StepTimings                step_timings;
+   SceneStatistics *          statistics;
+
+   unsigned int               reference_count;
+};
+
+
+// A reference to a scene that is held for the duration of a call, so that
+// the scene can't be destroyed while the call still uses it; the reference
+// is taken by getScene and released when the call returns
+class SceneReference
+{
+   protected:
+      PhysXScene *   scene_pointer;
+
+   private:
+      // References can't be copied, since each one is released exactly once
+      SceneReference(const SceneReference & other);
+      SceneReference & operator=(const SceneReference & other);
+
+   public:
+      SceneReference();
+      ~SceneReference();
+
+      SceneReference & operator=(PhysXScene * scene);
+
+      operator PhysXScene * () const;
+      PhysXScene * operator->() const;
+};
+
+
 static PxFoundation *                    px_foundation;
 static PxPhysics *                       px_physics;
-static PxScene *                         px_scene;
 static PxCooking *                       px_cooking;
+static PhysXMeshCache *                  mesh_cache = NULL;
 
-static PxDefaultCpuDispatcher *          cpu_dispatcher = NULL;
+static PxDefaultCpuDispatcher *          shared_dispatcher = NULL;
+static int                               shared_threads = 0;
 
 static PxDefaultErrorCallback            error_callback;
 static PxDefaultAllocator                allocator_callback;
-static PhysXCollisionCallback *          px_collisions;
 
-static PxRigidStatic *                   ground_plane;
+static PhysXScene *                      scenes[PHYSX_MAX_SCENES];
+static unsigned int                      default_scene_id = 0;
+static pthread_rwlock_t                  scenes_lock =
+                                            PTHREAD_RWLOCK_INITIALIZER;
 
-static bool                              scene_initialized = false;
+static debugger::comm::PvdConnection *   theConnection = NULL;
 
-static int                               max_updates;
+static PhysXRecorder                     recorder;
 
-static atMap *                           actor_map = new atMap();
-static atMap *                           joint_map = new atMap();
+static float                             default_height_field_scale;
 
-static pthread_mutex_t                   actor_map_mutex;
+static atNotifier *                      logger;
 
-static debugger::comm::PvdConnection *   theConnection = NULL;
+//-----------------------------------------------------------------------------
 
-static float                             default_height_field_scale;
 
-static atNotifier *                      logger;
+// Finds the scene with the given handle and takes a reference to it, which
+// has to be handed to a SceneReference so that it is released again;
+// returns NULL, after warning the user, if there is no such scene
+PhysXScene * getScene(unsigned int sceneID)
+{
+   PhysXScene *   scene;
 
-static EntityProperties * update_array;
-static CollisionProperties * collisions_array;
+   // Look the scene up and take a reference to it while the table can't
+   // change, so that the scene can't be destroyed in between
+   pthread_rwlock_rdlock(&scenes_lock);
+   if (sceneID == 0 || sceneID > PHYSX_MAX_SCENES)
+   {
+      // Handles count up from one, so that zero is never a valid handle
+      scene = NULL;
+   }
+   else
+   {
+      scene = scenes[sceneID - 1];
+      if (scene != NULL)
+      {
+         #ifdef _WIN32
+            InterlockedIncrement((volatile LONG *) &scene->reference_count);
+         #else
+            __sync_fetch_and_add(&scene->reference_count, 1);
+         #endif
+      }
+   }
+   pthread_rwlock_unlock(&scenes_lock);
 
-#ifdef LIB_PHYSX_DEBUG
-   static atTimer * profiling_timer = new atTimer();
-#endif
+   // Let the user know that the call has nothing to operate on
+   if (scene == NULL)
+      logger->notify(AT_WARN, "Scene %u not found.\n", sceneID);
 
-//-----------------------------------------------------------------------------
+   return scene;
+}
 
 
-PhysXRigidActor * createRigidActor(unsigned int id,
-   char * name, float x, float y, float z, bool isDynamic,
+// Acquires the write lock of a scene, keeping track of how long it took to
+// acquire; the time of acquisition is kept in the scene, which is safe since
+// only one thread can hold the write lock, so that the hold time can be
+// measured as well
+void lockSceneWrite(PhysXScene * scene)
+{
+   unsigned long long   startTime;
+
+   // Acquire the lock and record how long that took
+   startTime = PhysXHistogram::getTime();
+   scene->px_scene->lockWrite();
+   scene->statistics->write_lock_start =
+      scene->statistics->lock_wait_times.addSampleSince(startTime);
+}
+
+
+// Releases the write lock of a scene, keeping track of how long it was held
+void unlockSceneWrite(PhysXScene * scene)
+{
+   // Record how long the lock was held, then release it
+   scene->statistics->lock_hold_times.addSampleSince(
+      scene->statistics->write_lock_start);
+   scene->px_scene->unlockWrite();
+}
+
+
+// Acquires the read lock of a scene, keeping track of how long it took to
+// acquire; read locks can be held by several threads at once, so their hold
+// time isn't measured
+void lockSceneRead(PhysXScene * scene)
+{
+   unsigned long long   startTime;
+
+   // Acquire the lock and record how long that took
+   startTime = PhysXHistogram::getTime();
+   scene->px_scene->lockRead();
+   scene->statistics->lock_wait_times.addSampleSince(startTime);
+}
+
+
+// Releases the read lock of a scene
+void unlockSceneRead(PhysXScene * scene)
+{
+   scene->px_scene->unlockRead();
+}
+
+
+// Starts a new window of statistics for a scene, removing the samples and
+// totals gathered so far
+void resetStatistics(PhysXScene * scene)
+{
+   // Clear the histograms of the scene and of its registry
+   scene->statistics->simulate_times.reset();
+   scene->statistics->fetch_times.reset();
+   scene->statistics->update_times.reset();
+   scene->statistics->collision_times.reset();
+   scene->statistics->lock_wait_times.reset();
+   scene->statistics->lock_hold_times.reset();
+   scene->statistics->cook_times.reset();
+   scene->actor_registry->resetLockTimes();
+
+   // Clear the totals; the counts of the last step are kept
+   scene->statistics->truncated_updates = 0;
+   scene->statistics->truncated_collisions = 0;
+}
+
+
+// Reserves a handle and sets up the state of a new scene, apart from the
+// PhysX scene itself, which is created by createScene; the caller must hold
+// the write lock of the table of scenes
+unsigned int reserveScene()
+{
+   PhysXScene *   scene;
+   unsigned int   sceneID;
+
+   // Look for an unused handle
+   sceneID = 0;
+   for (unsigned int i = 0; i < PHYSX_MAX_SCENES && sceneID == 0; i++)
+   {
+      if (scenes[i] == NULL)
+         sceneID = i + 1;
+   }
+
+   // Give up if every handle is in use
+   if (sceneID == 0)
+   {
+      logger->notify(AT_ERROR, "Failed to create scene! Too many scenes.\n");
+      return 0;
+   }
+
+   // Start out with an empty scene that has no update buffers yet
+   scene = new PhysXScene;
+   memset(scene, 0, sizeof(PhysXScene));
+   scene->cpu_threads = 1;
+
+   // The table of scenes holds the first reference to the scene
+   scene->reference_count = 1;
+
+   // Give the scene its own registry, joints, command queue and collision
+   // callback, so that it never contends with other scenes for them
+   scene->actor_registry = new PhysXActorRegistry(1024);
+   scene->joint_map = new atMap();
+   scene->command_queue = new PhysXCommandQueue();
+   scene->px_collisions = new PhysXCollisionCallback();
+   scene->step_timer = new atTimer();
+
+   // Start gathering statistics from scratch
+   scene->statistics = new SceneStatistics;
+   scene->statistics->write_lock_start = 0;
+   scene->statistics->active_actors = 0;
+   scene->statistics->contact_pairs = 0;
+   resetStatistics(scene);
+
+   // Publish the scene under its handle
+   scenes[sceneID - 1] = scene;
+   return sceneID;
+}
+
+
+// Releases a scene along with everything in it; the scene must already have
+// been removed from the table of scenes
+void destroySceneState(PhysXScene * scene)
+{
+   if (scene->scene_initialized)
+   {
+      // A scene can't be released in the middle of a step, so wait for any
+      // step in flight to finish and discard its results
+      lockSceneWrite(scene);
+      if (scene->simulation_running)
+      {
+         scene->px_scene->fetchResults(true);
+         scene->simulation_running = false;
+      }
+
+      // Clean up the joints and the terrain while their scene still exists
+      delete scene->joint_map;
+      delete scene->terrain;
+      unlockSceneWrite(scene);
+   }
+   else
+   {
+      // Nothing was ever added to the scene
+      delete scene->joint_map;
+   }
+
+   // Clean up the actors, which removes them from the scene
+   delete scene->actor_registry;
+
+   // Release all remaining objects in the scene and then the scene itself
+   if (scene->scene_initialized)
+      scene->px_scene->release();
+
+   // Release the dispatcher, unless it is shared with other scenes
+   if (scene->cpu_dispatcher != NULL && !scene->uses_shared_dispatcher)
+      scene->cpu_dispatcher->release();
+
+   // Clean up the rest of the memory used by the scene
+   delete scene->command_queue;
+   delete scene->px_collisions;
+   delete scene->step_timer;
+   delete scene->statistics;
+   delete scene;
+}
+
+
+// Releases a reference to a scene; the scene is destroyed along with its
+// last reference, which only happens once destroyScene has removed it from
+// the table of scenes
+void releaseSceneReference(PhysXScene * scene)
+{
+   unsigned int   remaining;
+
+   // Drop the reference, using an atomic operation since other calls may
+   // be releasing theirs at the same time
+   #ifdef _WIN32
+      remaining = (unsigned int) InterlockedDecrement(
+         (volatile LONG *) &scene->reference_count);
+   #else
+      remaining = __sync_sub_and_fetch(&scene->reference_count, 1);
+   #endif
+
+   // Nothing can reach the scene anymore, so release it
+   if (remaining == 0)
+      destroySceneState(scene);
+}
+
+
+SceneReference::SceneReference()
+{
+   // Nothing is referenced yet
+   scene_pointer = NULL;
+}
+
+
+SceneReference::~SceneReference()
+{
+   // Release the scene, now that the call is done with it
+   if (scene_pointer != NULL)
+      releaseSceneReference(scene_pointer);
+}
+
+
+SceneReference & SceneReference::operator=(PhysXScene * scene)
+{
+   // Take over the reference that getScene took, releasing the scene that
+   // was referenced before, if any
+   if (scene_pointer != NULL)
+      releaseSceneReference(scene_pointer);
+   scene_pointer = scene;
+   return *this;
+}
+
+
+SceneReference::operator PhysXScene * () const
+{
+   return scene_pointer;
+}
+
+
+PhysXScene * SceneReference::operator->() const
+{
+   return scene_pointer;
+}
+
+
+// Returns the handle of the scene that the single-scene API operates on,
+// reserving it the first time around
+unsigned int getDefaultScene()
+{
+   unsigned int   sceneID;
+
+   // Read the handle under the lock of the table of scenes, since
+   // destroyScene clears it when the default scene is destroyed
+   pthread_rwlock_rdlock(&scenes_lock);
+   sceneID = default_scene_id;
+   pthread_rwlock_unlock(&scenes_lock);
+   if (sceneID != 0)
+      return sceneID;
+
+   // Reserve the default scene, unless another thread just did
+   pthread_rwlock_wrlock(&scenes_lock);
+   if (default_scene_id == 0)
+   {
+      default_scene_id = reserveScene();
+
+      // The replay tool has to reserve the scene at the same point
+      if (recorder.isRecording())
+         recorder.record(CALL_RESERVE_DEFAULT_SCENE, "u", default_scene_id);
+   }
+   sceneID = default_scene_id;
+   pthread_rwlock_unlock(&scenes_lock);
+
+   // Return the handle of the default scene
+   return sceneID;
+}
+
+
+PhysXRigidActor * createRigidActor(PhysXScene * scene, unsigned int id,
+   const char * name, float x, float y, float z, bool isDynamic,
    bool reportCollisions)
 {
    PhysXRigidActor *   actor;
    ActorType           actorType;
-   atInt *             actorKey;
 
    // Determine whether the actor to be created is dynamic or static
    if (isDynamic)
@@ -107,20 +486,18 @@ PhysXRigidActor * createRigidActor(unsigned int id,
       reportCollisions);
    actor->setName(name);
 
-   // Keep track of the actor in the map and then return it
-   actorKey = new atInt(id);
-   actor_map->addEntry(actorKey, actor);
+   // Keep track of the actor in the registry and then return it
+   scene->actor_registry->addActor(id, actor);
    return actor;
 }
 
 
-PhysXRigidActor * createRigidActor(unsigned int id,
-   char * name, float x, float y, float z, PxQuat Rot, bool isDynamic,
+PhysXRigidActor * createRigidActor(PhysXScene * scene, unsigned int id,
+   const char * name, float x, float y, float z, PxQuat Rot, bool isDynamic,
    bool reportCollisions)
 {
    PhysXRigidActor *   actor;
    ActorType           actorType;
-   atInt *             actorKey;
 
    // Determine whether the actor to be created is dynamic or static
    if (isDynamic)
@@ -137,35 +514,141 @@ PhysXRigidActor * createRigidActor(unsigned int id,
       reportCollisions);
    actor->setName(name);
 
-   // Keep track of the actor in the map and then return it
-   actorKey = new atInt(id);
-   actor_map->addEntry(actorKey, actor);
+   // Keep track of the actor in the registry and then return it
+   scene->actor_registry->addActor(id, actor);
    return actor;
 }
 
 
-PhysXRigidActor * getActor(unsigned int id)
+PhysXRigidActor * getActor(PhysXScene * scene, unsigned int id)
 {
-   atInt *             searchID;
-   PhysXRigidActor *   rigidActor;
+   // Find the actor, with the specified ID, in the registry, and then
+   // return it if found; otherwise, return NULL
+   return scene->actor_registry->getActor(id);
+}
+
 
-   // Find the actor, with the specified ID, in the map, and then
+PhysXRigidActor * getActor(PhysXScene * scene, atInt * id)
+{
+   // Find the actor, with the spcified id, in the registry, and then
    // return it if found; otherwise, return NULL
-   searchID = new atInt(id);
-   rigidActor = (PhysXRigidActor *)actor_map->getValue(searchID);
-   delete searchID;
-   return rigidActor;
+   return scene->actor_registry->getActor(id->getValue());
 }
 
 
-PhysXRigidActor * getActor(atInt * id)
+// Applies a single command from a command buffer; the caller must hold the
+// registry's read lock as well as the scene's write lock
+CommandStatus applyActorCommand(PhysXScene * scene, ActorCommand * command)
 {
    PhysXRigidActor *   rigidActor;
+   ActorPosition       position;
+   ActorOrientation    orientation;
+   float *             data;
 
-   // Find the actor, with the spcified id, in the map, and then
-   // return it if found; otherwise, return NULL
-   rigidActor = (PhysXRigidActor *) actor_map->getValue(id);
-   return rigidActor;
+   // Get the actor that the command operates on
+   rigidActor = getActor(scene, command->ActorID);
+   if (rigidActor == NULL)
+      return COMMAND_ACTOR_NOT_FOUND;
+
+   // Changes to the motion of an actor only make sense for dynamic actors
+   if (command->Opcode >= COMMAND_SET_LINEAR_VELOCITY &&
+       command->Opcode <= COMMAND_CLEAR_ALL_FORCES &&
+       command->Opcode != COMMAND_SET_GRAVITY &&
+       command->Opcode != COMMAND_ENABLE_GRAVITY &&
+       !rigidActor->isDynamic())
+   {
+      return COMMAND_ACTOR_NOT_DYNAMIC;
+   }
+
+   // Perform the operation requested by the command using its payload
+   data = command->Data;
+   switch (command->Opcode)
+   {
+      case COMMAND_SET_TRANSFORMATION:
+         rigidActor->setTransformation(data[0], data[1], data[2],
+            data[3], data[4], data[5], data[6]);
+         break;
+
+      case COMMAND_SET_POSITION:
+         position.x = data[0];
+         position.y = data[1];
+         position.z = data[2];
+         rigidActor->setPosition(position);
+         break;
+
+      case COMMAND_SET_ROTATION:
+         orientation.x = data[0];
+         orientation.y = data[1];
+         orientation.z = data[2];
+         orientation.w = data[3];
+         rigidActor->setRotation(orientation);
+         break;
+
+      case COMMAND_SET_LINEAR_VELOCITY:
+         rigidActor->setLinearVelocity(data[0], data[1], data[2]);
+         break;
+
+      case COMMAND_SET_ANGULAR_VELOCITY:
+         rigidActor->setAngularVelocity(data[0], data[1], data[2]);
+         break;
+
+      case COMMAND_ADD_FORCE:
+         rigidActor->addForce(PxVec3(data[0], data[1], data[2]));
+         break;
+
+      case COMMAND_ADD_TORQUE:
+         rigidActor->addTorque(PxVec3(data[0], data[1], data[2]));
+         break;
+
+      case COMMAND_SET_GRAVITY:
+         rigidActor->setGravity(data[0], data[1], data[2]);
+         break;
+
+      case COMMAND_ENABLE_GRAVITY:
+         rigidActor->enableGravity(data[0] != 0.0f);
+         break;
+
+      case COMMAND_SET_LINEAR_DAMPING:
+         rigidActor->setLinearDamping(data[0]);
+         break;
+
+      case COMMAND_SET_ANGULAR_DAMPING:
+         rigidActor->setAngularDamping(data[0]);
+         break;
+
+      case COMMAND_CLEAR_ALL_FORCES:
+         rigidActor->clearAllForces();
+         break;
+
+      default:
+         return COMMAND_UNKNOWN_OPCODE;
+   }
+
+   // The command was applied
+   return COMMAND_SUCCEEDED;
+}
+
+
+// Applies all of the commands that have been queued since the last call; the
+// caller must hold the registry's read lock as well as the scene's write lock
+void applyQueuedCommands(PhysXScene * scene)
+{
+   ActorCommand *   commands;
+   unsigned int     commandCount;
+   CommandStatus    status;
+
+   // Take the queued commands, leaving the queue free for new batches
+   commands = scene->command_queue->takeCommands(&commandCount);
+   if (commandCount == 0)
+      return;
+
+   // Apply each command, recording the ones that failed
+   for (unsigned int i = 0; i < commandCount; i++)
+   {
+      status = applyActorCommand(scene, &commands[i]);
+      if (status != COMMAND_SUCCEEDED)
+         scene->command_queue->recordFailure(&commands[i], status);
+   }
 }
 
 
@@ -244,6 +727,29 @@ void startVisualDebugger()
 
 //-----------------------------------------------------------------------------
 
+// Points the collision callback at the buffer, in whichever layout is in
+// use, that the next simulation step will fill
+void setCollisionTarget(PhysXScene * scene)
+{
+   // Nothing to do until the callback has been created
+   if (scene->px_collisions == NULL)
+      return;
+
+   if (scene->use_collision_arrays)
+   {
+      scene->px_collisions->setCollisionsArrays(
+         &scene->collision_array_buffers[scene->current_buffer],
+         scene->max_collisions);
+   }
+   else
+   {
+      scene->px_collisions->setCollisionsArray(
+         scene->collision_buffers[scene->current_buffer],
+         scene->max_collisions);
+   }
+}
+
+
 PHYSX_API int initialize()
 {
    // Initialize the logger and set the name of this class
@@ -253,9 +759,6 @@ PHYSX_API int initialize()
    logger->setNotifyLevel(AT_ERROR);
 #endif
 
-   // Initialize the mutex that will ensure the thread-safety of the actor map
-   pthread_mutex_init(&actor_map_mutex, NULL);
-   
    // Create and initialize the PhysX foundation
    px_foundation = PxCreateFoundation(
       PX_PHYSICS_VERSION, allocator_callback, error_callback);
@@ -284,8 +787,8 @@ PHYSX_API int initialize()
       logger->notify(AT_WARN, "Cooking utilities failed to initialize!\n");
    }
 
-   // Create the collision callback
-   px_collisions = new PhysXCollisionCallback();
+   // Create the cache that shares cooked meshes between shapes
+   mesh_cache = new PhysXMeshCache(px_physics, px_cooking);
 
    // Initialize the visual debugger
    startVisualDebugger();
@@ -297,14 +800,26 @@ PHYSX_API int initialize()
 
 PHYSX_API void release()
 {
-   // Clean up the memory that was used
-   delete actor_map;
-   delete joint_map;
+   // Clean up every scene that is still around, by releasing the reference
+   // that the table of scenes holds to it
+   pthread_rwlock_wrlock(&scenes_lock);
+   for (unsigned int i = 0; i < PHYSX_MAX_SCENES; i++)
+   {
+      if (scenes[i] != NULL)
+      {
+         releaseSceneReference(scenes[i]);
+         scenes[i] = NULL;
+      }
+   }
+   default_scene_id = 0;
+   pthread_rwlock_unlock(&scenes_lock);
 
-   // Clean up the timer for profiling if it was initialized
-   #ifdef LIB_PHYSX_DEBUG
-      delete profiling_timer;
-   #endif
+   // Release the dispatcher that was shared between scenes, if any
+   if (shared_dispatcher != NULL)
+   {
+      shared_dispatcher->release();
+      shared_dispatcher = NULL;
+   }
 
    // Close the visual debugger if it's currently running
    if (theConnection)
@@ -312,76 +827,307 @@ PHYSX_API void release()
       theConnection->release();
    }
 
+   // Release the cached meshes before the physics they belong to
+   delete mesh_cache;
+   mesh_cache = NULL;
+
+   // Finish the session being recorded, if any
+   recorder.stop();
+
    // Shut down the physics entirely
    px_cooking->release();
    px_physics->release();
    px_foundation->release();
+}
+
+
+PHYSX_API bool createSharedDispatcher(int cpuMaxThreads)
+{
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_SHARED_DISPATCHER, "i", cpuMaxThreads);
+
+   // There can only be one shared dispatcher
+   if (shared_dispatcher != NULL)
+   {
+      logger->notify(AT_WARN, "Failed to create shared CPU dispatcher! "
+         "Dispatcher already exists.\n");
+      return false;
+   }
+
+   // Create the dispatcher that the scenes created from now on will share,
+   // and return whether that succeeded
+   shared_dispatcher = PxDefaultCpuDispatcherCreate(cpuMaxThreads);
+   shared_threads = cpuMaxThreads;
+   return shared_dispatcher != NULL;
+}
 
-   // Clean-up callback
-   delete px_collisions;
 
-   // Clean up the actor map mutex
-   pthread_mutex_destroy(&actor_map_mutex);
+PHYSX_API bool startRecording(char * path)
+{
+   // Record every call from now on to the given file
+   return recorder.start(path);
 }
 
 
-PHYSX_API void initEntityUpdate(EntityProperties * updateArray, int maxUpdates)
+PHYSX_API void stopRecording()
+{
+   // Finish the session and write out the remaining calls
+   recorder.stop();
+}
+
+
+PHYSX_API void initEntityUpdateInScene(unsigned int sceneID,
+   EntityProperties * updateArray, int maxUpdates)
+{
+   // Use the same array for both buffers, so that every step writes its
+   // updates to the given array
+   initEntityUpdateBuffersInScene(sceneID, updateArray, updateArray,
+      maxUpdates);
+}
+
+
+PHYSX_API void initEntityUpdateBuffersInScene(unsigned int sceneID,
+   EntityProperties * firstArray, EntityProperties * secondArray,
+   int maxUpdates)
 {
-   // Keep reference to the given array for entity property updates and
-   // the max number of updates allowed
-   update_array = updateArray;
-   max_updates = maxUpdates;
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_INIT_ENTITY_UPDATE_BUFFERS, "ubi", sceneID,
+         firstArray == secondArray, maxUpdates);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Keep reference to the given arrays for entity property updates and
+   // the max number of updates allowed in each
+   scene->update_buffers[0] = firstArray;
+   scene->update_buffers[1] = secondArray;
+   scene->max_updates = maxUpdates;
 }
 
 
-PHYSX_API void initCollisionUpdate(
+PHYSX_API void initCollisionUpdateInScene(unsigned int sceneID,
    CollisionProperties * collisionArray, int maxCollisions)
 {
-   // Set the collisions array to the pointer given
-   collisions_array = collisionArray;
+   // Use the same array for both buffers, so that every step writes its
+   // collisions to the given array
+   initCollisionUpdateBuffersInScene(sceneID, collisionArray,
+      collisionArray, maxCollisions);
+}
+
+
+PHYSX_API void initCollisionUpdateBuffersInScene(unsigned int sceneID,
+   CollisionProperties * firstArray, CollisionProperties * secondArray,
+   int maxCollisions)
+{
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_INIT_COLLISION_UPDATE_BUFFERS, "ubi", sceneID,
+         firstArray == secondArray, maxCollisions);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
-   if (px_collisions)
+   // Ensure that the following operations are thread-safe; the callback
+   // writes to the buffers while a step is in flight, so they can't be
+   // changed until the step has ended
+   if (scene->scene_initialized)
    {
-       px_collisions->setCollisionsArray(collisions_array, maxCollisions);
+      lockSceneWrite(scene);
+      if (scene->simulation_running)
+      {
+         unlockSceneWrite(scene);
+         logger->notify(AT_WARN, "Unable to set collision buffers. A "
+            "simulation step is in flight.\n");
+         return;
+      }
    }
+
+   // Keep reference to the given arrays for collision updates and the max
+   // number of collisions allowed in each
+   scene->collision_buffers[0] = firstArray;
+   scene->collision_buffers[1] = secondArray;
+   scene->max_collisions = maxCollisions;
+   scene->use_collision_arrays = false;
+
+   // Point the collision callback at the buffer the next step will fill
+   setCollisionTarget(scene);
+
+   // Release the scene
+   if (scene->scene_initialized)
+      unlockSceneWrite(scene);
 }
 
 
-PHYSX_API int createScene(bool gpuEnabled, bool cpuEnabled, int cpuMaxThreads)
+PHYSX_API void initCollisionArraysUpdateInScene(unsigned int sceneID,
+   CollisionArrays * firstArrays, CollisionArrays * secondArrays,
+   int maxCollisions)
 {
-   PxCudaContextManagerDesc   cudaManagerDesc;
-   PxCudaContextManager *     cudaContextManager;
-   PxProfileZoneManager *     profileZoneManager;
-   CUresult                   cudaResult;
-   int                        deviceCount;
-   CUdevice                   cudaDevice;
-   CUcontext                  cudaContext;
+   SceneReference   scene;
 
-   // TODO: include support for setting gravity normal rather than
-   // assume z-axis as OpenSim does (normal should be passed in)
+   // Both sets of arrays are copied, so they have to be given
+   if (firstArrays == NULL || secondArrays == NULL)
+   {
+      logger->notify(AT_WARN, "Unable to set collision arrays. Both sets "
+         "of arrays must be given.\n");
+      return;
+   }
 
-   // Create the descriptor class for the scene with the default tolerance
-   // parameters for the simulation and real-world gravity
-   PxSceneDesc sceneDesc = PxSceneDesc(px_physics->getTolerancesScale());
-   sceneDesc.gravity = PxVec3(0.0f, 0.0f, -9.8f);
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_INIT_COLLISION_ARRAYS_UPDATE, "ubbi", sceneID,
+         firstArrays->ActorId1 == secondArrays->ActorId1,
+         firstArrays->Impulse != NULL, maxCollisions);
 
-   // Set flags to configure the properties for the scene; will enable:
-   // active transform notifications,
-   // continuous collosion detection,
-   // contact pair filtering between kinematic rigid bodies,
-   // contact pair filtering between kinematic and static rigid bodies
-   sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVETRANSFORMS;
-   sceneDesc.flags |= PxSceneFlag::eENABLE_CCD;
-   sceneDesc.flags |= PxSceneFlag::eENABLE_KINEMATIC_PAIRS;
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
-   // Check that the user wants PhysX to run on the GPU
-   if (gpuEnabled)
+   // Ensure that the following operations are thread-safe; the callback
+   // writes to the buffers while a step is in flight, so they can't be
+   // changed until the step has ended
+   if (scene->scene_initialized)
    {
-      // Change the gpu enabled to false in case initialization of the gpu
-      // dispatcher fails
-      gpuEnabled = false;
+      lockSceneWrite(scene);
+      if (scene->simulation_running)
+      {
+         unlockSceneWrite(scene);
+         logger->notify(AT_WARN, "Unable to set collision arrays. A "
+            "simulation step is in flight.\n");
+         return;
+      }
+   }
+   // Keep a copy of the given sets of arrays for collision updates and the
+   // max number of collisions allowed in each; the same set may be given
+   // twice
+   scene->collision_array_buffers[0] = *firstArrays;
+   scene->collision_array_buffers[1] = *secondArrays;
+   scene->max_collisions = maxCollisions;
+   scene->use_collision_arrays = true;
+
+   // Point the collision callback at the arrays the next step will fill
+   setCollisionTarget(scene);
+
+   // Release the scene
+   if (scene->scene_initialized)
+      unlockSceneWrite(scene);
+}
 
-      // Confirm that the machine supports PhysX GPU
+
+PHYSX_API void setCollisionReportModeInScene(unsigned int sceneID, int mode)
+{
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_COLLISION_REPORT_MODE, "ui", sceneID, mode);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Only the known modes can be used
+   if (mode != COLLISION_REPORT_POINTS && mode != COLLISION_REPORT_AGGREGATE)
+   {
+      logger->notify(AT_WARN, "Unable to set collision report mode. Mode %d "
+         "is not known.\n", mode);
+      return;
+   }
+
+   // Ensure that the following operations are thread-safe; the callback
+   // writes to the buffers while a step is in flight, so they can't be
+   // changed until the step has ended
+   if (scene->scene_initialized)
+   {
+      lockSceneWrite(scene);
+      if (scene->simulation_running)
+      {
+         unlockSceneWrite(scene);
+         logger->notify(AT_WARN, "Unable to set collision report mode. A "
+            "simulation step is in flight.\n");
+         return;
+      }
+   }
+
+   // Switch between reporting every contact point and one record per pair
+   // of actors
+   if (scene->px_collisions)
+   {
+      scene->px_collisions->setReportMode(mode);
+   }
+
+   // Release the scene
+   if (scene->scene_initialized)
+      unlockSceneWrite(scene);
+}
+
+
+PHYSX_API unsigned int getDroppedCollisionCountInScene(unsigned int sceneID)
+{
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_GET_DROPPED_COLLISION_COUNT, "u", sceneID);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return 0;
+
+   // Return the number of contact points dropped during the last step
+   return scene->dropped_collisions;
+}
+
+
+// Creates the PhysX scene of a reserved scene, using the given dispatchers
+bool initializeScene(PhysXScene * scene, bool gpuEnabled, bool,
+   int cpuMaxThreads)
+{
+   PxCudaContextManagerDesc   cudaManagerDesc;
+   PxCudaContextManager *     cudaContextManager;
+   PxProfileZoneManager *     profileZoneManager;
+   CUresult                   cudaResult;
+   int                        deviceCount;
+   CUdevice                   cudaDevice;
+   CUcontext                  cudaContext;
+
+   // TODO: include support for setting gravity normal rather than
+   // assume z-axis as OpenSim does (normal should be passed in)
+
+   // Create the descriptor class for the scene with the default tolerance
+   // parameters for the simulation and real-world gravity
+   PxSceneDesc sceneDesc = PxSceneDesc(px_physics->getTolerancesScale());
+   sceneDesc.gravity = PxVec3(0.0f, 0.0f, -9.8f);
+
+   // Set flags to configure the properties for the scene; will enable:
+   // active transform notifications,
+   // continuous collosion detection,
+   // contact pair filtering between kinematic rigid bodies,
+   // contact pair filtering between kinematic and static rigid bodies
+   sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVETRANSFORMS;
+   sceneDesc.flags |= PxSceneFlag::eENABLE_CCD;
+   sceneDesc.flags |= PxSceneFlag::eENABLE_KINEMATIC_PAIRS;
+
+   // Check that the user wants PhysX to run on the GPU
+   if (gpuEnabled)
+   {
+      // Change the gpu enabled to false in case initialization of the gpu
+      // dispatcher fails
+      gpuEnabled = false;
+
+      // Confirm that the machine supports PhysX GPU
       #if PX_SUPPORT_GPU_PHYSX
          // Create the profiler zone manager for the cuda context to send
          // profile updates to the visual debugger
@@ -476,26 +1222,37 @@ PHYSX_API int createScene(bool gpuEnabled, bool cpuEnabled, int cpuMaxThreads)
       #endif
    }
 
+   // Use the shared CPU dispatcher, if there is one, so that the worker
+   // threads are shared with the other scenes instead of competing with them
+   if (shared_dispatcher != NULL)
+   {
+      scene->cpu_dispatcher = shared_dispatcher;
+      scene->cpu_threads = shared_threads;
+      scene->uses_shared_dispatcher = true;
+      sceneDesc.cpuDispatcher = shared_dispatcher;
+   }
+
    // The CPU dispatcher is needed for interfacing with the application's
    // thread pool; check if the scene description already has one
    if (sceneDesc.cpuDispatcher == NULL)
    {
       // No dispatcher found so create a new one with one worker thread to
       // start
-      cpu_dispatcher = PxDefaultCpuDispatcherCreate(cpuMaxThreads);
+      scene->cpu_dispatcher = PxDefaultCpuDispatcherCreate(cpuMaxThreads);
+      scene->cpu_threads = cpuMaxThreads;
 
-      // Return 0 (false) if CPU dispatcher failed to create
-      if (cpu_dispatcher == NULL)
+      // Return false if CPU dispatcher failed to create
+      if (scene->cpu_dispatcher == NULL)
       {
-         return 0;
+         return false;
       }
-      else if (cpu_dispatcher != NULL)
+      else if (scene->cpu_dispatcher != NULL)
       {
          // Notify the user that the CPU is currently in use
          logger->notify(AT_INFO, "CPU enabled.\n");
 
          // Assign the created dispatcher to the scene description
-         sceneDesc.cpuDispatcher = cpu_dispatcher;
+         sceneDesc.cpuDispatcher = scene->cpu_dispatcher;
       }
    }
 
@@ -503,67 +1260,161 @@ PHYSX_API int createScene(bool gpuEnabled, bool cpuEnabled, int cpuMaxThreads)
    sceneDesc.filterShader = contactFilterShader;
 
    // Create the physics scene
-   px_scene = px_physics->createScene(sceneDesc);
+   scene->px_scene = px_physics->createScene(sceneDesc);
 
-   // Print error and return 0 (false) if the scene failed to be created
-   if (px_scene == NULL)
+   // Print error and return false if the scene failed to be created
+   if (scene->px_scene == NULL)
    {
       logger->notify(AT_ERROR, "Failed to create PhysX scene.\n");
-      return 0;
+
+      // Release the dispatcher of the scene, since it will never be used
+      if (!scene->uses_shared_dispatcher)
+         scene->cpu_dispatcher->release();
+      scene->cpu_dispatcher = NULL;
+      scene->uses_shared_dispatcher = false;
+      return false;
    }
 
    // Set the custom collisions callback to receive simulation
    // events related to collisions
-   px_scene->setSimulationEventCallback(px_collisions);
+   scene->px_scene->setSimulationEventCallback(scene->px_collisions);
 
    // Successfully created the scene
-   scene_initialized = true;
-   return 1;
+   scene->scene_initialized = true;
+   return true;
 }
 
 
-PHYSX_API void releaseScene()
+PHYSX_API unsigned int createScene(bool gpuEnabled, bool cpuEnabled,
+   int cpuMaxThreads)
+{
+   unsigned int   sceneID;
+   bool           reserved;
+
+   // Ensure that scenes are created one at a time
+   pthread_rwlock_wrlock(&scenes_lock);
+
+   // The first scene created becomes the default scene, which may already
+   // have been reserved by calls to the single-scene API; otherwise, reserve
+   // a new handle for the scene
+   reserved = (default_scene_id != 0 &&
+      !scenes[default_scene_id - 1]->scene_initialized);
+   if (reserved)
+      sceneID = default_scene_id;
+   else
+      sceneID = reserveScene();
+
+   // Create the PhysX scene for the handle
+   if (sceneID != 0 && !initializeScene(scenes[sceneID - 1], gpuEnabled,
+       cpuEnabled, cpuMaxThreads))
+   {
+      // Give the handle back, unless it is the reserved default scene, which
+      // keeps the state that was set up for it
+      if (!reserved)
+      {
+         destroySceneState(scenes[sceneID - 1]);
+         scenes[sceneID - 1] = NULL;
+      }
+      sceneID = 0;
+   }
+
+   // Calls to the single-scene API operate on the first scene from now on
+   if (default_scene_id == 0)
+      default_scene_id = sceneID;
+
+   // Capture the call, along with the handle it returned, if a session is
+   // being recorded
+   if (recorder.isRecording())
+   {
+      recorder.record(CALL_CREATE_SCENE, "bbiu", gpuEnabled, cpuEnabled,
+         cpuMaxThreads, sceneID);
+   }
+
+   // Now that the operations are complete, unlock the scenes
+   pthread_rwlock_unlock(&scenes_lock);
+
+   // Return the handle of the scene, or 0 if it could not be created
+   return sceneID;
+}
+
+
+PHYSX_API void destroyScene(unsigned int sceneID)
 {
-   // Release all objects in the scene
-   px_scene->release();
+   PhysXScene *   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_DESTROY_SCENE, "u", sceneID);
+
+   // Ensure that the following operations are thread-safe
+   pthread_rwlock_wrlock(&scenes_lock);
+
+   // Take the scene out of the table, so that it can't be found anymore
+   scene = NULL;
+   if (sceneID != 0 && sceneID <= PHYSX_MAX_SCENES)
+      scene = scenes[sceneID - 1];
+   if (scene != NULL)
+   {
+      scenes[sceneID - 1] = NULL;
+
+      // The single-scene API operates on the next scene that is created
+      if (sceneID == default_scene_id)
+         default_scene_id = 0;
+   }
+
+   // Now that the operations are complete, unlock the scenes
+   pthread_rwlock_unlock(&scenes_lock);
 
-   // Release the dispatcher
-   cpu_dispatcher->release();
+   // Release the reference of the table; the scene, along with everything
+   // in it, is released right away unless calls that are still in progress
+   // use it, in which case the last of them releases it
+   if (scene != NULL)
+      releaseSceneReference(scene);
+   else
+      logger->notify(AT_WARN, "Scene %u not found.\n", sceneID);
 }
 
 
-PHYSX_API void createActor(
-   unsigned int id, char * name, float x, float y, float z, bool isDynamic,
+PHYSX_API void createActorInScene(unsigned int sceneID, unsigned int id,
+   char * name, float x, float y, float z, bool isDynamic,
    bool reportCollisions)
 {
+   SceneReference      scene;
    PhysXRigidActor *   actor;
-   atInt *             checkID;
 
-   // Create a new key that will be used to search the map for a duplicate
-   // actor
-   checkID = new atInt(id);
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_ACTOR, "uusfffbb", sceneID, id, name, x, y, z,
+         isDynamic, reportCollisions);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
    // Check that the scene has been initialized an that the actor doesn't
    // exist
-   if (scene_initialized == true && !actor_map->containsKey(checkID))
+   if (scene->scene_initialized == true &&
+       !scene->actor_registry->containsActor(id))
    {
       // Lock writing to the scene, in order to make the following operations
       // thead-safe
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Create the rigid actor
-      actor = createRigidActor(id, name, x, y, z, isDynamic, reportCollisions);
+      actor = createRigidActor(scene, id, name, x, y, z, isDynamic,
+         reportCollisions);
 
       // Add the newly created actor to the scene
-      px_scene->addActor(*(actor->getActor()));
+      scene->px_scene->addActor(*(actor->getActor()));
 
       // Now that the actor has been added, unlock writing on other threads
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
-   else if (scene_initialized)
+   else if (scene->scene_initialized)
    {
       // Notify that an actor with the given ID already exists
       logger->notify(AT_WARN, "Failed to create actor! Actor already "
@@ -576,27 +1427,35 @@ PHYSX_API void createActor(
          "initialized.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean-up
-   delete checkID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 }
 
 
-PHYSX_API void attachSphere(unsigned int id, unsigned int shapeId,
-   float staticFriction, float dynamicFriction, float restitution,
-   float radius, float x, float y, float z, float density)
+PHYSX_API void attachSphereInScene(unsigned int sceneID, unsigned int id,
+   unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float radius, float x, float y, float z, float density)
 {
+   SceneReference      scene;
    PhysXRigidActor *   actor;
    PxMaterial *        material;
    PxSphereGeometry    geometry;
    PxShape *           shape;
-   atInt *             actorID;
    PxTransform         localPose;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ATTACH_SPHERE, "uuuffffffff", sceneID, id, shapeId,
+         staticFriction, dynamicFriction, restitution, radius, x, y, z,
+         density);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
    // Check to see if the scene has not been initialized
-   if (!scene_initialized)
+   if (!scene->scene_initialized)
    {
       // The scene hasn't been initialized, so display a warning and exit out
       logger->notify(AT_WARN, "Failed to attach sphere! Scene not "
@@ -604,14 +1463,11 @@ PHYSX_API void attachSphere(unsigned int id, unsigned int shapeId,
       return;
    }
 
-   // Create a temporary ID for map lookup
-   actorID = new atInt(id);
-
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to fetch the actor with the given ID
-   actor = (PhysXRigidActor *) actor_map->getValue(actorID);
+   actor = scene->actor_registry->getActor(id);
 
    // Check to see if an actor was found with the given ID
    if (actor != NULL)
@@ -632,13 +1488,13 @@ PHYSX_API void attachSphere(unsigned int id, unsigned int shapeId,
       shape->setLocalPose(localPose);
 
       // Ensure that the following changes to the scene are thread-safe
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Add the newly-created shape to the given actor
       actor->addShape(shapeId, shape, density);
 
       // Now that the shape has been added, unlock writing on other threads
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -649,28 +1505,36 @@ PHYSX_API void attachSphere(unsigned int id, unsigned int shapeId,
       logger->notify(AT_WARN, "Failed to attach sphere! Actor not found.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the temporary ID created to look up the actor
-   delete actorID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void attachBox(unsigned int id, unsigned int shapeId,
-   float staticFriction, float dynamicFriction, float restitution, float halfX,
-   float halfY, float halfZ, float x, float y, float z, float rotX, float rotY,
-   float rotZ, float rotW, float density)
+PHYSX_API void attachBoxInScene(unsigned int sceneID, unsigned int id,
+   unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float halfX, float halfY, float halfZ, float x, float y,
+   float z, float rotX, float rotY, float rotZ, float rotW, float density)
 {
+   SceneReference      scene;
    PhysXRigidActor *   actor;
    PxMaterial *        material;
    PxBoxGeometry       geometry;
    PxShape *           shape;
-   atInt *             actorID;
    PxTransform         localPose;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ATTACH_BOX, "uuuffffffffffffff", sceneID, id,
+         shapeId, staticFriction, dynamicFriction, restitution, halfX, halfY,
+         halfZ, x, y, z, rotX, rotY, rotZ, rotW, density);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
    // Check to see if the scene has not been initialized
-   if (!scene_initialized)
+   if (!scene->scene_initialized)
    {
       // The scene hasn't been initialized, so display a warning and exit out
       logger->notify(AT_WARN, "Failed to attach box! Scene not "
@@ -678,14 +1542,11 @@ PHYSX_API void attachBox(unsigned int id, unsigned int shapeId,
       return;
    }
 
-   // Create a temporary ID for map lookup
-   actorID = new atInt(id);
-
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to fetch the actor with the given ID
-   actor = (PhysXRigidActor *) actor_map->getValue(actorID);
+   actor = scene->actor_registry->getActor(id);
 
    // Check to see if an actor was found with the given ID
    if (actor != NULL)
@@ -706,13 +1567,13 @@ PHYSX_API void attachBox(unsigned int id, unsigned int shapeId,
       shape->setLocalPose(localPose);
 
       // Ensure that the following changes to the scene are thread-safe
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Add the newly-created shape to the given actor
       actor->addShape(shapeId, shape, density);
 
       // Now that the shape has been added, unlock writing on other threads
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -723,28 +1584,36 @@ PHYSX_API void attachBox(unsigned int id, unsigned int shapeId,
       logger->notify(AT_WARN, "Failed to attach box! Actor not found.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the temporary ID created to look up the actor
-   delete actorID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void attachCapsule(unsigned int id, unsigned shapeId,
-   float staticFriction, float dynamicFriction, float restitution,
-   float halfHeight, float radius, float x, float y, float z, float rotX,
-   float rotY, float rotZ, float rotW, float density)
+PHYSX_API void attachCapsuleInScene(unsigned int sceneID, unsigned int id,
+   unsigned shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float halfHeight, float radius, float x, float y, float z,
+   float rotX, float rotY, float rotZ, float rotW, float density)
 {
+   SceneReference      scene;
    PhysXRigidActor *   actor;
    PxMaterial *        material;
    PxCapsuleGeometry   geometry;
    PxShape *           shape;
    PxTransform         localPose;
-   atInt *             actorID;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ATTACH_CAPSULE, "uuufffffffffffff", sceneID, id,
+         shapeId, staticFriction, dynamicFriction, restitution, halfHeight,
+         radius, x, y, z, rotX, rotY, rotZ, rotW, density);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Check to see if the scene has not been initialized
-   if (!scene_initialized)
+   if (!scene->scene_initialized)
    {
       // The scene hasn't been initialized, so display a warning and exit out
       logger->notify(AT_WARN, "Failed to attach capsule! Scene not "
@@ -752,14 +1621,11 @@ PHYSX_API void attachCapsule(unsigned int id, unsigned shapeId,
       return;
    }
 
-   // Create a temporary ID for map lookup
-   actorID = new atInt(id);
-
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to fetch the actor with the given ID
-   actor = (PhysXRigidActor *) actor_map->getValue(actorID);
+   actor = scene->actor_registry->getActor(id);
 
    // Check to see if an actor was found with the given ID
    if (actor != NULL)
@@ -780,13 +1646,13 @@ PHYSX_API void attachCapsule(unsigned int id, unsigned shapeId,
       shape->setLocalPose(localPose);
 
       // Ensure that the following changes to the scene are thread-safe
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Add the newly-created shape to the given actor
       actor->addShape(shapeId, shape, density);
 
       // Now that the shape has been added, unlock writing on other threads
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -797,33 +1663,42 @@ PHYSX_API void attachCapsule(unsigned int id, unsigned shapeId,
       logger->notify(AT_WARN, "Failed to attach capsule! Actor not found.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the temporary ID created to look up the actor
-   delete actorID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void attachTriangleMesh(unsigned int id, unsigned int shapeId,
-   float staticFriction, float dynamicFriction, float restitution,
-   float * vertices, int * indices, int vertexCount, int indexCount, float x,
-   float y, float z, float rotX, float rotY, float rotZ, float rotW)
+PHYSX_API void attachTriangleMeshInScene(unsigned int sceneID, unsigned int id,
+   unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float * vertices, int * indices, int vertexCount,
+   int indexCount, float x, float y, float z, float rotX, float rotY,
+   float rotZ, float rotW)
 {
+   SceneReference           scene;
    PhysXRigidActor *        actor;
    PxMaterial *             material;
    PxTriangleMeshGeometry   geometry;
    PxShape *                shape;
-   PxVec3 *                 vertexArray;
-   PxU32 *                  indexArray;
    PxTriangleMesh *         triangleMesh;
-   PxTriangleMeshDesc       meshDesc;
+   MeshKey                  meshKey;
+   bool                     meshCooked;
    PxMeshScale              meshScale;
-   atInt *                  actorID;
    PxTransform              localPose;
+   unsigned long long       startTime;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ATTACH_TRIANGLE_MESH, "uuufffFIfffffff", sceneID, id,
+         shapeId, staticFriction, dynamicFriction, restitution, vertices,
+         vertexCount * 3, indices, indexCount, x, y, z, rotX, rotY, rotZ, rotW);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Check to see if the scene has not been initialized
-   if (!scene_initialized)
+   if (!scene->scene_initialized)
    {
       // The scene hasn't been initialized, so display a warning and exit out
       logger->notify(AT_WARN, "Failed to attach triangle mesh! Scene not "
@@ -831,14 +1706,27 @@ PHYSX_API void attachTriangleMesh(unsigned int id, unsigned int shapeId,
       return;
    }
 
-   // Create a temporary ID for map lookup
-   actorID = new atInt(id);
+   // Fetch the cooked mesh for the given data from the cache, which only
+   // cooks it if it hasn't been seen before; this happens before the
+   // registry is locked, so cooking doesn't hold up other threads (only
+   // actual cooking counts towards the time spent cooking)
+   startTime = PhysXHistogram::getTime();
+   triangleMesh = mesh_cache->acquireTriangleMesh(vertices, vertexCount,
+      indices, indexCount, &meshKey, &meshCooked);
+   if (meshCooked)
+      scene->statistics->cook_times.addSampleSince(startTime);
+   if (triangleMesh == NULL)
+   {
+      logger->notify(AT_WARN, "Failed to attach triangle mesh! Unable to "
+         "cook mesh.\n");
+      return;
+   }
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to fetch the actor with the given ID
-   actor = (PhysXRigidActor *) actor_map->getValue(actorID);
+   actor = scene->actor_registry->getActor(id);
 
    // Check to see if an actor was found with the given ID and that it is
    // static
@@ -849,77 +1737,36 @@ PHYSX_API void attachTriangleMesh(unsigned int id, unsigned int shapeId,
       material = px_physics->createMaterial(staticFriction, dynamicFriction,
          restitution);
 
-      // Convert the given array of vertex points to an array of PhysX vectors,
-      // for use by PhysX
-      vertexArray = new PxVec3[vertexCount];
-      for (int i = 0; i < vertexCount; i++)
-      {
-         vertexArray[i] =
-            PxVec3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
-      }
+      // Create the geometry for the mesh
+      meshScale.scale = PxVec3(1.0f, 1.0f, 1.0f);
+      meshScale.rotation = PxQuat::createIdentity();
+      geometry = PxTriangleMeshGeometry(
+         triangleMesh, meshScale, PxMeshGeometryFlag::eDOUBLE_SIDED);
+
+      // Create the shape based on the given geometry and material
+      shape = px_physics->createShape(geometry, *material, true);
 
-      // Convert the given array of indices into an array of PhysX unsigned
-      // integers
-      indexArray = new PxU32[indexCount];
-      for (int i = 0; i < indexCount; i++)
+      // Check to see if a valid shape was constructed
+      if (shape != NULL)
       {
-         indexArray[i] = (PxU32) indices[i];
-      }
+         // Set the position and orientation of the mesh relative to
+         // the actor using the given parameters
+         localPose.p = PxVec3(x, y, z);
+         localPose.q = PxQuat(rotX, rotY, rotZ, rotW);
+         shape->setLocalPose(localPose);
 
-      // Constuct a description of the actor mesh
-      meshDesc.points.count = vertexCount;
-      meshDesc.points.stride = sizeof(PxVec3);
-      meshDesc.points.data = vertexArray;
-      meshDesc.triangles.count = indexCount / 3;
-      meshDesc.triangles.stride = sizeof(PxU32) * 3;
-      meshDesc.triangles.data = indexArray;
+         // Ensure that the following changes to the scene are thread-safe
+         lockSceneWrite(scene);
 
-      // Check to see if the mesh description forms a valid mesh
-      if (px_cooking->validateTriangleMesh(meshDesc))
-      {
-         // Create the triangle mesh using the cooking library
-         triangleMesh = px_cooking->createTriangleMesh(
-            meshDesc, px_physics->getPhysicsInsertionCallback());
- 
-         // Check to see if the newly-created mesh is valid
-         if (triangleMesh != NULL)
-         {
-            // Create the geometry for the mesh
-            meshScale.scale = PxVec3(1.0f, 1.0f, 1.0f);
-            meshScale.rotation = PxQuat::createIdentity();
-            geometry = PxTriangleMeshGeometry(
-               triangleMesh, meshScale, PxMeshGeometryFlag::eDOUBLE_SIDED);
-  
-            // Create the shape based on the given geometry and material
-            shape = px_physics->createShape(geometry, *material, true);
-  
-            // Check to see if a valid shape was constructed
-            if (shape != NULL)
-            {
-               // Set the position and orientation of the mesh relative to
-               // the actor using the given parameters
-               localPose.p = PxVec3(x, y, z);
-               localPose.q = PxQuat(rotX, rotY, rotZ, rotW);
-               shape->setLocalPose(localPose);
-     
-               // Ensure that the following changes to the scene are thread-safe
-               px_scene->lockWrite();
-     
-               // Add the newly-created shape to the given actor
-               // (use a 0 density as this density will not be used due to
-               // the actor being static)
-               actor->addShape(shapeId, shape, 0.0f);
-
-               // Now that the shape has been added, unlock writing on
-               // other threads
-               px_scene->unlockWrite();
-            }
-         }
-      }
+         // Add the newly-created shape to the given actor
+         // (use a 0 density as this density will not be used due to
+         // the actor being static)
+         actor->addShape(shapeId, shape, 0.0f);
 
-      // Clean-up arrays
-      delete[] vertexArray;
-      delete[] indexArray;
+         // Now that the shape has been added, unlock writing on
+         // other threads
+         unlockSceneWrite(scene);
+      }
 
       // Clean up the memory used by the material
       material->release();
@@ -938,35 +1785,44 @@ PHYSX_API void attachTriangleMesh(unsigned int id, unsigned int shapeId,
          "found.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 
-   // Clean up the temporary ID created to look up the actor
-   delete actorID;
+   // The shape (if any) now holds its own reference to the mesh
+   mesh_cache->releaseMesh(meshKey);
 }
 
 
-PHYSX_API void attachConvexMesh(unsigned int id, unsigned int shapeId,
-   float staticFriction, float dynamicFriction, float restitution,
-   float * vertices, int vertexCount, float x, float y, float z, float rotX,
-   float rotY, float rotZ, float rotW, float density)
+PHYSX_API void attachConvexMeshInScene(unsigned int sceneID, unsigned int id,
+   unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float * vertices, int vertexCount, float x, float y,
+   float z, float rotX, float rotY, float rotZ, float rotW, float density)
 {
-   PhysXRigidActor *             actor;
-   PxMaterial *                  material;
-   PxConvexMeshGeometry          geometry;
-   PxShape *                     shape;
-   PxVec3 *                      vertexArray;
-   PxConvexMesh *                convexMesh;
-   PxConvexMeshGeometry          meshGeom;
-   PxConvexMeshDesc              meshDesc;
-   PxMeshScale                   meshScale;
-   PxDefaultMemoryOutputStream   buffer;
-   PxDefaultMemoryInputData*     inputData;
-   atInt *                       actorID;
-   PxTransform                   localPose;
+   SceneReference         scene;
+   PhysXRigidActor *      actor;
+   PxMaterial *           material;
+   PxConvexMeshGeometry   meshGeom;
+   PxShape *              shape;
+   PxConvexMesh *         convexMesh;
+   MeshKey                meshKey;
+   bool                   meshCooked;
+   PxMeshScale            meshScale;
+   PxTransform            localPose;
+   unsigned long long     startTime;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ATTACH_CONVEX_MESH, "uuufffFffffffff", sceneID, id,
+         shapeId, staticFriction, dynamicFriction, restitution, vertices,
+         vertexCount * 3, x, y, z, rotX, rotY, rotZ, rotW, density);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Check to see if the scene has not been initialized
-   if (!scene_initialized)
+   if (!scene->scene_initialized)
    {
       // The scene hasn't been initialized, so display a warning and exit out
       logger->notify(AT_WARN, "Failed to attach convex mesh! Scene not "
@@ -974,14 +1830,26 @@ PHYSX_API void attachConvexMesh(unsigned int id, unsigned int shapeId,
       return;
    }
 
-   // Create a new atInt that will be used to find the actor with the given ID
-   actorID = new atInt(id);
+   // Fetch the cooked mesh for the given data from the cache, which only
+   // cooks it if it hasn't been seen before; this happens before the
+   // registry is locked, so cooking doesn't hold up other threads (only
+   // actual cooking counts towards the time spent cooking)
+   startTime = PhysXHistogram::getTime();
+   convexMesh = mesh_cache->acquireConvexMesh(vertices, vertexCount,
+      &meshKey, &meshCooked);
+   if (meshCooked)
+      scene->statistics->cook_times.addSampleSince(startTime);
+   if (convexMesh == NULL)
+   {
+      logger->notify(AT_WARN, "Unable to cook convex mesh!\n");
+      return;
+   }
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to fetch the actor with the given ID
-   actor = (PhysXRigidActor *) actor_map->getValue(actorID);
+   actor = scene->actor_registry->getActor(id);
 
    // Check to see if an actor was found with the given ID
    if (actor != NULL)
@@ -991,61 +1859,28 @@ PHYSX_API void attachConvexMesh(unsigned int id, unsigned int shapeId,
       material = px_physics->createMaterial(staticFriction, dynamicFriction,
          restitution);
 
-      // Convert the given array of vertex points to an array of PhysX
-      // vectors, for use by PhysX
-      vertexArray = new PxVec3[vertexCount];
-      for (int i = 0; i < vertexCount; i++)
-      {
-         vertexArray[i] =
-            PxVec3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
-      }
+      // Create the geometry for the mesh
+      meshScale.scale = PxVec3(1.0f, 1.0f, 1.0f);
+      meshScale.rotation = PxQuat::createIdentity();
+      meshGeom = PxConvexMeshGeometry(convexMesh, meshScale);
 
-      // Construct a description of the convex mesh
-      meshDesc.points.count = vertexCount;
-      meshDesc.points.stride = sizeof(PxVec3);
-      meshDesc.points.data = vertexArray;
-      meshDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
-      meshDesc.flags |= PxConvexFlag::eINFLATE_CONVEX;
-      meshDesc.vertexLimit = 256;
-
-      // Attempt to 'cook' the mesh data into a form which allows PhysX to
-      // perform efficient collision detection; results are written to
-      // the stream buffer
-      if (px_cooking->cookConvexMesh(meshDesc, buffer))
-      {
-         // Sucessfully cooked the convex mesh so create the input stream
-         // from the resulting data and use it to create the convex mesh
-         inputData =
-            new PxDefaultMemoryInputData(buffer.getData(), buffer.getSize());
-         convexMesh = px_physics->createConvexMesh(*inputData);
-
-         // Create the geometry for the mesh
-         meshScale.scale = PxVec3(1.0f, 1.0f, 1.0f);
-         meshScale.rotation = PxQuat::createIdentity();
-         meshGeom = PxConvexMeshGeometry(convexMesh, meshScale);
-
-         // Create a new shape for the mesh
-         shape = px_physics->createShape(meshGeom, *material, true);
-
-         // Set the position and orientation of the mesh relative to the actor
-         // using the given parameters
-         localPose.p = PxVec3(x, y, z);
-         localPose.q = PxQuat(rotX, rotY, rotZ, rotW);
-         shape->setLocalPose(localPose);
+      // Create a new shape for the mesh
+      shape = px_physics->createShape(meshGeom, *material, true);
 
-         // Ensure that the following changes to the scene are thread-safe
-         px_scene->lockWrite();
+      // Set the position and orientation of the mesh relative to the actor
+      // using the given parameters
+      localPose.p = PxVec3(x, y, z);
+      localPose.q = PxQuat(rotX, rotY, rotZ, rotW);
+      shape->setLocalPose(localPose);
 
-         // Add the newly-created shape to the given actor
-         actor->addShape(shapeId, shape, density);
+      // Ensure that the following changes to the scene are thread-safe
+      lockSceneWrite(scene);
 
-         // Now that the shape has been added, unlock writing on other threads
-         px_scene->unlockWrite();
+      // Add the newly-created shape to the given actor
+      actor->addShape(shapeId, shape, density);
 
-         // Clean-up arrays and other data
-         delete[] vertexArray;
-         delete inputData;
-      }
+      // Now that the shape has been added, unlock writing on other threads
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -1057,21 +1892,68 @@ PHYSX_API void attachConvexMesh(unsigned int id, unsigned int shapeId,
          "found.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 
-   // Clean up the temporary atInt created to look up the actor
-   delete actorID;
+   // The shape (if any) now holds its own reference to the mesh
+   mesh_cache->releaseMesh(meshKey);
 }
 
 
-PHYSX_API void removeShape(unsigned int id, unsigned int shapeId)
+PHYSX_API void setMeshCacheDirectory(char * path)
+{
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_MESH_CACHE_DIRECTORY, "s", path);
+
+   // Persist cooked meshes to the given directory, or stop persisting them
+   // if no directory is given
+   if (mesh_cache != NULL)
+      mesh_cache->setCacheDirectory(path);
+}
+
+
+PHYSX_API void getMeshCacheStatistics(MeshCacheStatistics * stats)
 {
+   // Report how effective the cache has been so far
+   if (mesh_cache != NULL)
+      mesh_cache->getStatistics(stats);
+   else
+      memset(stats, 0, sizeof(MeshCacheStatistics));
+}
+
+
+PHYSX_API unsigned int purgeMeshCache()
+{
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_PURGE_MESH_CACHE, "");
+
+   // Release the cached meshes that are no longer used by any shape
+   if (mesh_cache != NULL)
+      return mesh_cache->purge();
+   else
+      return 0;
+}
+
+
+PHYSX_API void removeShapeInScene(unsigned int sceneID, unsigned int id,
+   unsigned int shapeId)
+{
+   SceneReference      scene;
    PhysXRigidActor *   actor;
-   atInt *             actorID;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_REMOVE_SHAPE, "uuu", sceneID, id, shapeId);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Check to see if the scene has not been initialized
-   if (!scene_initialized)
+   if (!scene->scene_initialized)
    {
       // The scene hasn't been initialized, so display a warning and exit out
       logger->notify(AT_WARN, "Failed to detach shape! Scene not "
@@ -1080,23 +1962,29 @@ PHYSX_API void removeShape(unsigned int id, unsigned int shapeId)
    }
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to fetch the actor with the given ID
-   actorID = new atInt(id);
-   actor = (PhysXRigidActor *) actor_map->getValue(actorID);
+   actor = scene->actor_registry->getActor(id);
 
-   // Check to see if an actor was found with the given ID
-   if (actor)
+   // The tiles of the terrain are owned by its height field, so they can only
+   // be removed along with the whole terrain actor
+   if (actor != NULL && scene->terrain != NULL &&
+       id == scene->terrain_actor_id && scene->terrain->ownsShape(shapeId))
+   {
+      logger->notify(AT_WARN, "Failed to remove shape! Terrain tiles can only "
+         "be removed with the terrain actor.\n");
+   }
+   else if (actor)
    {
       // Ensure that the following changes to the scene are thread-safe
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Detach the shape with the give shape ID attached to the given actor
       actor->detachShape(shapeId);
 
       // Now that the shape has been removed, unlock writing on other threads
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
    else
    {
@@ -1104,40 +1992,46 @@ PHYSX_API void removeShape(unsigned int id, unsigned int shapeId)
       logger->notify(AT_WARN, "Failed to remove shape! Actor not found.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the temporary ID created to look up the actor
-   delete actorID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void createActorSphere(unsigned int id, char * name, float x,
-   float y, float z, unsigned int shapeId, float staticFriction,
-   float dynamicFriction, float restitution, float radius, float density,
-   bool isDynamic, bool reportCollisions)
+PHYSX_API void createActorSphereInScene(unsigned int sceneID, unsigned int id,
+   char * name, float x, float y, float z, unsigned int shapeId,
+   float staticFriction, float dynamicFriction, float restitution, float radius,
+   float density, bool isDynamic, bool reportCollisions)
 {
+   SceneReference       scene;
    PhysXRigidActor *    actor;
    PxMaterial *         material;
    PxSphereGeometry     geometry;
    PxShape *            shape;
-   atInt *              checkID;
 
-   // Create a new ID that will be used to search the map for a duplicate
-   // actor
-   checkID = new atInt(id);
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_ACTOR_SPHERE, "uusfffufffffbb", sceneID, id,
+         name, x, y, z, shapeId, staticFriction, dynamicFriction, restitution,
+         radius, density, isDynamic, reportCollisions);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
    // Check that the scene has been initialized and that the actor doesn't
    // already exist
-   if (scene_initialized == true && !actor_map->containsKey(checkID))
+   if (scene->scene_initialized == true &&
+       !scene->actor_registry->containsActor(id))
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Create the rigid actor and add it to the scene
-      actor = createRigidActor(id, name, x, y, z, isDynamic, reportCollisions);
+      actor = createRigidActor(scene, id, name, x, y, z, isDynamic,
+         reportCollisions);
 
       // Create a new material; used to resolve collisions
       material = px_physics->createMaterial(
@@ -1152,9 +2046,9 @@ PHYSX_API void createActorSphere(unsigned int id, char * name, float x,
       actor->addShape(shapeId, shape, density);
 
       // Add the newly created actor to the scene
-      px_scene->addActor(*(actor->getActor()));
+      scene->px_scene->addActor(*(actor->getActor()));
 
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
       
       // Clean up the memory used by the material
       material->release();
@@ -1166,40 +2060,47 @@ PHYSX_API void createActorSphere(unsigned int id, char * name, float x,
          "initialized or actor already existed.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the memory holding the id
-   delete checkID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 }
 
 
-PHYSX_API void createActorBox(unsigned int id, char * name, float posX,
-   float posY, float posZ, unsigned int shapeId, float staticFriction,
-   float dynamicFriction, float restitution, float halfX, float halfY,
-   float halfZ, float density, bool isDynamic, bool reportCollisions)
+PHYSX_API void createActorBoxInScene(unsigned int sceneID, unsigned int id,
+   char * name, float posX, float posY, float posZ, unsigned int shapeId,
+   float staticFriction, float dynamicFriction, float restitution, float halfX,
+   float halfY, float halfZ, float density, bool isDynamic,
+   bool reportCollisions)
 {
+   SceneReference      scene;
    PhysXRigidActor *   actor;
    PxMaterial *        material;
    PxBoxGeometry       geometry;
    PxShape *           shape;
-   atInt *             checkID;
 
-   // Create a new ID that will be used to search the map for a duplicate
-   // actor
-   checkID = new atInt(id);
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_ACTOR_BOX, "uusfffufffffffbb", sceneID, id,
+         name, posX, posY, posZ, shapeId, staticFriction, dynamicFriction,
+         restitution, halfX, halfY, halfZ, density, isDynamic,
+         reportCollisions);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
    // Check that the scene has been initialized and that the actor doesn't
    // already exist
-   if (scene_initialized == true && !actor_map->containsKey(checkID))
+   if (scene->scene_initialized == true &&
+       !scene->actor_registry->containsActor(id))
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Create the rigid actor and add it to the scene
-      actor = createRigidActor(id, name, posX, posY, posZ, isDynamic,
+      actor = createRigidActor(scene, id, name, posX, posY, posZ, isDynamic,
                                reportCollisions);
 
       // Create a new material; used to resolve collisions
@@ -1215,9 +2116,9 @@ PHYSX_API void createActorBox(unsigned int id, char * name, float posX,
       actor->addShape(shapeId, shape, density);
 
       // Add the newly created actor to the scene
-      px_scene->addActor(*(actor->getActor()));
+      scene->px_scene->addActor(*(actor->getActor()));
 
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -1229,42 +2130,49 @@ PHYSX_API void createActorBox(unsigned int id, char * name, float posX,
          "initialized or actor already existed.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the memory used by the id
-   delete checkID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 }
 
 
-PHYSX_API void createActorCapsule(unsigned int id, char * name, float x,
-   float y, float z, float rotX, float rotY, float rotZ, float rotW,
-   unsigned int shapeId, float staticFriction, float dynamicFriction,
-   float restitution, float halfHeight, float radius, float density,
-   bool isDynamic, bool reportCollisions)
+PHYSX_API void createActorCapsuleInScene(unsigned int sceneID, unsigned int id,
+   char * name, float x, float y, float z, float rotX, float rotY, float rotZ,
+   float rotW, unsigned int shapeId, float staticFriction,
+   float dynamicFriction, float restitution, float halfHeight, float radius,
+   float density, bool isDynamic, bool reportCollisions)
 {
+   SceneReference        scene;
    PhysXRigidActor *     actor;
    PxMaterial *          material;
    PxCapsuleGeometry     geometry;
    PxShape *             shape;
    PxTransform           relativePose;
-   atInt *               checkID;
 
-   // Create a new ID that will be used to search the map for a duplicate
-   // actor
-   checkID = new atInt(id);
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_ACTOR_CAPSULE, "uusfffffffuffffffbb", sceneID,
+         id, name, x, y, z, rotX, rotY, rotZ, rotW, shapeId, staticFriction,
+         dynamicFriction, restitution, halfHeight, radius, density, isDynamic,
+         reportCollisions);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
    // Check that the scene has been initialized and that the actor doesn't
    // already exist
-   if (scene_initialized == true && !actor_map->containsKey(checkID))
+   if (scene->scene_initialized == true &&
+       !scene->actor_registry->containsActor(id))
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Create the rigid actor and add it to the scene
-      actor = createRigidActor(id, name, x, y, z, isDynamic, reportCollisions);
+      actor = createRigidActor(scene, id, name, x, y, z, isDynamic,
+         reportCollisions);
 
       // Create a new material; used to resolve collisions
       material = px_physics->createMaterial(
@@ -1286,9 +2194,9 @@ PHYSX_API void createActorCapsule(unsigned int id, char * name, float x,
       actor->addShape(shapeId, shape, density);
 
       // Add the newly created actor to the scene
-      px_scene->addActor(*(actor->getActor()));
+      scene->px_scene->addActor(*(actor->getActor()));
 
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -1300,80 +2208,80 @@ PHYSX_API void createActorCapsule(unsigned int id, char * name, float x,
          "initialized or actor already existed.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the memory used by the id
-   delete checkID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 }
 
 
-PHYSX_API void createActorTriangleMesh(unsigned int id, char * name, float x,
-   float y, float z, unsigned int shapeId, float staticFriction,
-   float dynamicFriction, float restitution, float* vertices, int* indices,
-   int vertexCount, int indexCount, bool isDynamic, bool reportCollisions)
+PHYSX_API void createActorTriangleMeshInScene(unsigned int sceneID,
+   unsigned int id, char * name, float x, float y, float z,
+   unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float* vertices, int* indices, int vertexCount,
+   int indexCount, bool isDynamic, bool reportCollisions)
 {
+   SceneReference           scene;
    PhysXRigidActor *        actor;
    PxMaterial *             material;
    PxShape *                meshShape;
-   PxVec3 *                 vertexArray;
-   PxU32 *                  indexArray;
    PxTriangleMesh *         triangleMesh;
+   MeshKey                  meshKey;
+   bool                     meshCooked;
    PxTriangleMeshGeometry   meshGeom;
-   PxTriangleMeshDesc       meshDesc;
    PxMeshScale              meshScale;
-   atInt *                  checkID;
+   unsigned long long       startTime;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_ACTOR_TRIANGLE_MESH, "uusfffufffFIbb",
+         sceneID, id, name, x, y, z, shapeId, staticFriction, dynamicFriction,
+         restitution, vertices, vertexCount * 3, indices, indexCount, isDynamic,
+         reportCollisions);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Check that the scene has been initialized
+   if (scene->scene_initialized == false)
+   {
+      logger->notify(AT_WARN, "Unable to create triangle mesh for actor, "
+         "because the scene wasn't initialized.\n");
+      return;
+   }
 
-   // Create a new ID that will be used to search the map for a duplicate
-   // actor
-   checkID = new atInt(id);
+   // Fetch the cooked mesh for the given data from the cache, which only
+   // cooks it if it hasn't been seen before; this happens before the
+   // registry is locked, so cooking doesn't hold up other threads (only
+   // actual cooking counts towards the time spent cooking)
+   startTime = PhysXHistogram::getTime();
+   triangleMesh = mesh_cache->acquireTriangleMesh(vertices, vertexCount,
+      indices, indexCount, &meshKey, &meshCooked);
+   if (meshCooked)
+      scene->statistics->cook_times.addSampleSince(startTime);
+   if (triangleMesh == NULL)
+   {
+      logger->notify(AT_WARN, "Unable to cook triangle mesh!\n");
+      return;
+   }
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
-   // Check that the scene has been initialized and that the actor doesn't
-   // already exist
-   if (scene_initialized == true && !actor_map->containsKey(checkID))
+   // Check that the actor doesn't already exist
+   if (!scene->actor_registry->containsActor(id))
    {
       // Prevent scene from being written to while actor is being created
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Create the rigid actor for this mesh and add it to the scene
-      actor = createRigidActor(id, name, x, y, z, isDynamic, reportCollisions);
+      actor = createRigidActor(scene, id, name, x, y, z, isDynamic,
+         reportCollisions);
 
       // Create a new material; used to resolve collisions
       material = px_physics->createMaterial(staticFriction, dynamicFriction,
          restitution);
 
-      // Convert the given array of vertex points to an array of PhysX vectors,
-      // for use by PhysX
-      vertexArray = new PxVec3[vertexCount];
-      for (int i = 0; i < vertexCount; i++)
-      {
-         vertexArray[i] =
-            PxVec3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
-      }
-
-      // Convert the given array of indices into an array of PhysX unsigned
-      // integers
-      indexArray = new PxU32[indexCount];
-      for (int i = 0; i < indexCount; i++)
-      {
-         indexArray[i] = (PxU32) indices[i];
-      }
-
-      // Constuct a description of the actor mesh
-      meshDesc.points.count = vertexCount;
-      meshDesc.points.stride = sizeof(PxVec3);
-      meshDesc.points.data = vertexArray;
-      meshDesc.triangles.count = indexCount / 3;
-      meshDesc.triangles.stride = sizeof(PxU32) * 3;
-      meshDesc.triangles.data = indexArray;
-
-      // Create the triangle mesh using the cooking library
-      triangleMesh = px_cooking->createTriangleMesh(
-         meshDesc, px_physics->getPhysicsInsertionCallback());
- 
       // Create a geometry
       meshScale.scale = PxVec3(1.0f, 1.0f, 1.0f);
       meshScale.rotation = PxQuat::createIdentity();
@@ -1386,14 +2294,10 @@ PHYSX_API void createActorTriangleMesh(unsigned int id, char * name, float x,
       actor->addShape(shapeId, meshShape, 0.0f);
  
       // Add the newly created actor to the scene
-      px_scene->addActor(*(actor->getActor()));
+      scene->px_scene->addActor(*(actor->getActor()));
 
       // Finished creating new mesh actor
-      px_scene->unlockWrite();
-
-      // Clean-up arrays
-      delete[] vertexArray;
-      delete[] indexArray;
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -1402,50 +2306,80 @@ PHYSX_API void createActorTriangleMesh(unsigned int id, char * name, float x,
    {
       // Let the user know that the triangle mesh could not be created
       logger->notify(AT_WARN, "Unable to create triangle mesh for actor, "
-         "because the scene wasn't initialized or actor already existed.\n");
+         "because the actor already existed.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 
-   // Clean up the memory used by the id
-   delete checkID;
+   // The shape (if any) now holds its own reference to the mesh
+   mesh_cache->releaseMesh(meshKey);
 }
 
 
-PHYSX_API void createActorConvexMesh(unsigned int id, char * name, float x,
-   float y, float z, unsigned int shapeId, float staticFriction,
-   float dynamicFriction, float restitution, float* vertices, int vertexCount,
-   float density, bool isDynamic, bool reportCollisions)
+PHYSX_API void createActorConvexMeshInScene(unsigned int sceneID,
+   unsigned int id, char * name, float x, float y, float z,
+   unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float* vertices, int vertexCount, float density,
+   bool isDynamic, bool reportCollisions)
 {
-   PhysXRigidActor *             actor;
-   PxMaterial *                  material;
-   PxShape *                     meshShape;
-   PxVec3 *                      vertexArray;
-   PxConvexMesh *                convexMesh;
-   PxConvexMeshGeometry          meshGeom;
-   PxConvexMeshDesc              meshDesc;
-   PxMeshScale                   meshScale;
-   PxDefaultMemoryOutputStream   buffer;
-   PxDefaultMemoryInputData*     inputData;
-   atInt *                       checkID;
-
-   // Create a new ID that will be used to search the map for a duplicate
-   // actor
-   checkID = new atInt(id);
+   SceneReference         scene;
+   PhysXRigidActor *      actor;
+   PxMaterial *           material;
+   PxShape *              meshShape;
+   PxConvexMesh *         convexMesh;
+   MeshKey                meshKey;
+   bool                   meshCooked;
+   PxConvexMeshGeometry   meshGeom;
+   PxMeshScale            meshScale;
+   unsigned long long     startTime;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_ACTOR_CONVEX_MESH, "uusfffufffFfbb", sceneID,
+         id, name, x, y, z, shapeId, staticFriction, dynamicFriction,
+         restitution, vertices, vertexCount * 3, density, isDynamic,
+         reportCollisions);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Check that the scene has been initialized
+   if (scene->scene_initialized == false)
+   {
+      logger->notify(AT_WARN, "Unable to create convex mesh for actor, "
+         "because the scene wasn't initialized.\n");
+      return;
+   }
+
+   // Fetch the cooked mesh for the given data from the cache, which only
+   // cooks it if it hasn't been seen before; this happens before the
+   // registry is locked, so cooking doesn't hold up other threads (only
+   // actual cooking counts towards the time spent cooking)
+   startTime = PhysXHistogram::getTime();
+   convexMesh = mesh_cache->acquireConvexMesh(vertices, vertexCount,
+      &meshKey, &meshCooked);
+   if (meshCooked)
+      scene->statistics->cook_times.addSampleSince(startTime);
+   if (convexMesh == NULL)
+   {
+      logger->notify(AT_WARN, "Unable to cook convex mesh!\n");
+      return;
+   }
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
-   // Check that the scene has been initialized and that the actor doesn't
-   // already exist
-   if (scene_initialized == true && !actor_map->containsKey(checkID))
+   // Check that the actor doesn't already exist
+   if (!scene->actor_registry->containsActor(id))
    {
       // Prevent scene from being written to while actor is being created
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Create the rigid actor for this mesh and add it to the scene
-      actor = createRigidActor(id, name, x, y, z, isDynamic,
+      actor = createRigidActor(scene, id, name, x, y, z, isDynamic,
                                reportCollisions);
 
       // Create a new material; used to resolve collisions
@@ -1453,56 +2387,20 @@ PHYSX_API void createActorConvexMesh(unsigned int id, char * name, float x,
          px_physics->createMaterial(staticFriction, dynamicFriction,
             restitution);
 
-      // Convert the given array of vertex points to an array of PhysX
-      // vectors, for use by PhysX
-      vertexArray = new PxVec3[vertexCount];
-      for (int i = 0; i < vertexCount; i++)
-      {
-         vertexArray[i] =
-            PxVec3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
-      }
+      // Create the geometry for the mesh
+      meshScale.scale = PxVec3(1.0f, 1.0f, 1.0f);
+      meshScale.rotation = PxQuat::createIdentity();
+      meshGeom = PxConvexMeshGeometry(convexMesh, meshScale);
 
-      // Construct a description of the actor mesh
-      meshDesc.points.count = vertexCount;
-      meshDesc.points.stride = sizeof(PxVec3);
-      meshDesc.points.data = vertexArray;
-      meshDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
-      meshDesc.flags |= PxConvexFlag::eINFLATE_CONVEX;
-      meshDesc.vertexLimit = 256;
-
-      // Attempt to 'cook' the mesh data into a form which allows PhysX to
-      // perform efficient collision detection; results are written to
-      // the stream buffer
-      if (px_cooking->cookConvexMesh(meshDesc, buffer))
-      {
-         // Sucessfully cooked the convex mesh so create the input stream
-         // from the resulting data and use it to create the convex mesh
-         inputData =
-            new PxDefaultMemoryInputData(buffer.getData(), buffer.getSize());
-         convexMesh = px_physics->createConvexMesh(*inputData);
-
-         // Create the geometry for the mesh
-         meshScale.scale = PxVec3(1.0f, 1.0f, 1.0f);
-         meshScale.rotation = PxQuat::createIdentity();
-         meshGeom = PxConvexMeshGeometry(convexMesh, meshScale);
-
-         // Create a new shape for the mesh and add it to the associated actor
-         meshShape = px_physics->createShape(meshGeom, *material, true);
-         actor->addShape(shapeId, meshShape, density);
-
-         // Add the newly created actor to the scene
-         px_scene->addActor(*(actor->getActor()));
-      }
-      else
-      {
-         logger->notify(AT_WARN, "Unable to cook convex mesh!\n");
-      }
+      // Create a new shape for the mesh and add it to the associated actor
+      meshShape = px_physics->createShape(meshGeom, *material, true);
+      actor->addShape(shapeId, meshShape, density);
 
-      // Finished creating new mesh actor
-      px_scene->unlockWrite();
+      // Add the newly created actor to the scene
+      scene->px_scene->addActor(*(actor->getActor()));
 
-      // Clean-up arrays
-      delete[] vertexArray;
+      // Finished creating new mesh actor
+      unlockSceneWrite(scene);
 
       // Clean up the memory used by the material
       material->release();
@@ -1510,38 +2408,45 @@ PHYSX_API void createActorConvexMesh(unsigned int id, char * name, float x,
    else
    {
       // Let the user know that the convex mesh could not be created
-      logger->notify(AT_WARN, "Unable to create convex mesh due to scene "
-         "initialization or actor already exists.\n");
+      logger->notify(AT_WARN, "Unable to create convex mesh because the "
+         "actor already exists.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 
-   // Clean up the memory used by the id
-   delete checkID;
+   // The shape (if any) now holds its own reference to the mesh
+   mesh_cache->releaseMesh(meshKey);
 }
 
 
-PHYSX_API void removeActor(unsigned int id)
+PHYSX_API void removeActorInScene(unsigned int sceneID, unsigned int id)
 {
-   atInt *             searchID;
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
    PxActor *           actor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_REMOVE_ACTOR, "uu", sceneID, id);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
    // Can't remove actor if scene has not been initialized yet
-   if (scene_initialized == false)
+   if (scene->scene_initialized == false)
    {
       return;
    }
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
-   // Try and remove the given actor from the map and check to see
+   // Try and remove the given actor from the registry and check to see
    // if the actor exists
-   searchID = new atInt(id);
-   rigidActor = (PhysXRigidActor *)actor_map->removeEntry(searchID);
-   delete searchID;
+   rigidActor = scene->actor_registry->removeActor(id);
    if (rigidActor == NULL)
    {
       // Alert that the given actor name could not be found
@@ -1550,34 +2455,52 @@ PHYSX_API void removeActor(unsigned int id)
    }
    else
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
  
       // Remove the desired actor from the scene and specify that all
       // touching objects should be updated (woken up)
       actor = rigidActor->getActor();
-      px_scene->removeActor(*actor, true);
+      scene->px_scene->removeActor(*actor, true);
  
       // Finalize removal by removing the actor data
       delete rigidActor;
+
+      // The terrain's height fields are no longer used once its actor is gone
+      if (scene->terrain != NULL && id == scene->terrain_actor_id)
+      {
+         delete scene->terrain;
+         scene->terrain = NULL;
+      }
  
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 }
 
 
-PHYSX_API void updateMaterialProperties(unsigned int id, unsigned int shapeId,
-   float staticFriction, float dynamicFriction, float restitution)
+PHYSX_API void updateMaterialPropertiesInScene(unsigned int sceneID,
+   unsigned int id, unsigned int shapeId, float staticFriction,
+   float dynamicFriction, float restitution)
 {
+   SceneReference      scene;
    PhysXRigidActor *   actor;
    PxShape *           shape;
    PxMaterial *        material;
-   atInt *             actorID;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_UPDATE_MATERIAL_PROPERTIES, "uuufff", sceneID, id,
+         shapeId, staticFriction, dynamicFriction, restitution);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Check to see if the scene has been initialized
-   if (!scene_initialized)
+   if (!scene->scene_initialized)
    {
       // Notify the user that the update failed, because the scene has not been
       // initialized, and exit
@@ -1586,14 +2509,11 @@ PHYSX_API void updateMaterialProperties(unsigned int id, unsigned int shapeId,
       return;
    }
 
-   // Create a temporary ID for map lookup
-   actorID = new atInt(id);
-
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to find an actor with the given ID
-   actor = (PhysXRigidActor *) actor_map->getValue(actorID);
+   actor = scene->actor_registry->getActor(id);
 
    // Check to see if an actor was found
    if (actor)
@@ -1610,9 +2530,9 @@ PHYSX_API void updateMaterialProperties(unsigned int id, unsigned int shapeId,
  
          // Assign the new material to the actor's shape and make sure the
          // operation is thread-safe
-         px_scene->lockWrite();
+         lockSceneWrite(scene);
          shape->setMaterials(&material, 1);
-         px_scene->unlockWrite();
+         unlockSceneWrite(scene);
       }
       else
       {
@@ -1627,32 +2547,43 @@ PHYSX_API void updateMaterialProperties(unsigned int id, unsigned int shapeId,
       logger->notify(AT_WARN, "Failed to update material. Actor not found.\n");
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
-
-   // Clean up the temporary atInt used for looking up the actor
-   delete actorID;
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API float getActorMass(unsigned int id)
+PHYSX_API float getActorMassInScene(unsigned int sceneID, unsigned int id)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
    float               result;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_GET_ACTOR_MASS, "uu", sceneID, id);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return 0.0f;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return 0.0f;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Fetch the physx actor by the given id
-   rigidActor = getActor(id);
+   rigidActor = getActor(scene, id);
 
    // If the actor is not null, and is dynamic
    // Return the mass
    if (rigidActor != NULL && rigidActor->isDynamic())
    {
-      px_scene->lockRead();
+      lockSceneRead(scene);
       result = rigidActor->getMass();
-      px_scene->unlockRead();
+      unlockSceneRead(scene);
    }
    else
    {
@@ -1660,145 +2591,222 @@ PHYSX_API float getActorMass(unsigned int id)
       result = 0.0f;
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
    
    // Otherwise, return 0.0f
    return result;
 }
 
 
-PHYSX_API void clearAllForces(unsigned int id)
+PHYSX_API void clearAllForcesInScene(unsigned int sceneID, unsigned int id)
 {
+    SceneReference      scene;
     PhysXRigidActor *   rigidActor;
-    
+
+    // Capture the call if a session is being recorded
+    if (recorder.isRecording())
+       recorder.record(CALL_CLEAR_ALL_FORCES, "uu", sceneID, id);
+
+    // Find the scene that the call operates on
+    scene = getScene(sceneID);
+    if (scene == NULL)
+        return;
+
+    // There is nothing to operate on until the scene has been created
+    if (!scene->scene_initialized)
+        return;
+
     // Ensure that the following operations are thread-safe
-    pthread_mutex_lock(&actor_map_mutex);
+    scene->actor_registry->lockRead();
 
     // Get the actor that was requested
-    rigidActor = getActor(id);
+    rigidActor = getActor(scene, id);
 
     // Make sure that the actor was found before clearing the forces
     if (rigidActor != NULL)
     {
         // Clear all the forces and movement from the physical actor
-        px_scene->lockWrite();
+        lockSceneWrite(scene);
         rigidActor->clearAllForces();
-        px_scene->unlockWrite();
+        unlockSceneWrite(scene);
     }
 
-    // Now that the operations are complete, unlock the mutex
-    pthread_mutex_unlock(&actor_map_mutex);
+    // Now that the operations are complete, unlock the registry
+    scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API bool addForce(unsigned int id, float forceX, float forceY, float forceZ)
+PHYSX_API bool addForceInScene(unsigned int sceneID, unsigned int id,
+   float forceX, float forceY, float forceZ)
 {
+   SceneReference    scene;
    PxVec3            force;
    PhysXRigidActor * rigidActor;
    bool              result;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ADD_FORCE, "uufff", sceneID, id, forceX, forceY,
+         forceZ);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return false;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return false;
+
    // We assume the result is false, until otherwise
    result = false;
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Create the force vector and get the actor
    force = PxVec3(forceX, forceY, forceZ);
-   rigidActor = getActor(id);
+   rigidActor = getActor(scene, id);
 
    // If the actor is not null, apply the force, and
    // set the returned boolean as the result
    if (rigidActor != NULL)
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       result = rigidActor->addForce(force);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
    
    // Finally, return the result of adding the force
    return result;
 }
 
 
-PHYSX_API bool addTorque(unsigned int id, float torqueX, float torqueY,
-   float torqueZ)
+PHYSX_API bool addTorqueInScene(unsigned int sceneID, unsigned int id,
+   float torqueX, float torqueY, float torqueZ)
 {
+   SceneReference      scene;
    PxVec3              force;
    PhysXRigidActor *   rigidActor;
    bool                result;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ADD_TORQUE, "uufff", sceneID, id, torqueX, torqueY,
+         torqueZ);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return false;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return false;
+
    // We assume the result is false, until otherwise
    result = false;
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Create the torque vector and get the actor
    force = PxVec3(torqueX, torqueY, torqueZ);
-   rigidActor = getActor(id);
+   rigidActor = getActor(scene, id);
 
    // If the actor is not null, apply the torque, and
    // set the returned boolean as the result
    if (rigidActor != NULL)
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->addTorque(force);
       result = true;
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 
    // Finally, return the result of adding the torque
    return result;
 }
 
 
-PHYSX_API void setTransformation(unsigned int id, float posX, float posY,
-   float posZ, float rotX, float rotY, float rotZ, float rotW)
+PHYSX_API void setTransformationInScene(unsigned int sceneID, unsigned int id,
+   float posX, float posY, float posZ, float rotX, float rotY, float rotZ,
+   float rotW)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_TRANSFORMATION, "uufffffff", sceneID, id, posX,
+         posY, posZ, rotX, rotY, rotZ, rotW);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Attempt to get the specified actor by its id
-   rigidActor = getActor(id);
+   rigidActor = getActor(scene, id);
 
    // If we have succesfully retrieved the actor
    // set the translation
    if (rigidActor != NULL)
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setTransformation(posX, posY, posZ, rotX, rotY, rotZ, rotW);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void setPosition(unsigned int id, ActorPosition pos)
+PHYSX_API void setPositionInScene(unsigned int sceneID, unsigned int id,
+   ActorPosition pos)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_POSITION, "uufff", sceneID, id, pos.x, pos.y,
+         pos.z);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Update the position of the given actor, if found
-   rigidActor = getActor(id);
+   rigidActor = getActor(scene, id);
    if (rigidActor != NULL)
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setPosition(pos);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
    else
    {
@@ -1806,29 +2814,46 @@ PHYSX_API void setPosition(unsigned int id, ActorPosition pos)
          "not found.\n", id);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API ActorPosition getPosition(unsigned int id)
+PHYSX_API ActorPosition getPositionInScene(unsigned int sceneID,
+   unsigned int id)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
    ActorPosition       result;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_GET_POSITION, "uu", sceneID, id);
+
+   // Find the scene that the call operates on; there is nothing to report
+   // until the scene has been created
+   scene = getScene(sceneID);
+   if (scene == NULL || !scene->scene_initialized)
+   {
+      result.x = 0.0;
+      result.y = 0.0;
+      result.z = 0.0;
+      return result;
+   }
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Return the current position of this actor in a thread-safe manner
-      px_scene->lockRead();
+      lockSceneRead(scene);
       result = rigidActor->getPosition();
-      px_scene->unlockRead();
+      unlockSceneRead(scene);
    }
    else
    {
@@ -1840,31 +2865,47 @@ PHYSX_API ActorPosition getPosition(unsigned int id)
       result.z = 0.0;
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 
    // Return the position
    return result;
 }
 
 
-PHYSX_API void setRotation(unsigned int id, ActorOrientation orient)
+PHYSX_API void setRotationInScene(unsigned int sceneID, unsigned int id,
+   ActorOrientation orient)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_ROTATION, "uuffff", sceneID, id, orient.x,
+         orient.y, orient.z, orient.w);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Update the orientation of the actor
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setRotation(orient);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
    else
    {
@@ -1873,29 +2914,47 @@ PHYSX_API void setRotation(unsigned int id, ActorOrientation orient)
          "not found.\n", id);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API ActorOrientation getRotation(unsigned int id)
+PHYSX_API ActorOrientation getRotationInScene(unsigned int sceneID,
+   unsigned int id)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
    ActorOrientation    result;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_GET_ROTATION, "uu", sceneID, id);
+
+   // Find the scene that the call operates on; there is nothing to report
+   // until the scene has been created
+   scene = getScene(sceneID);
+   if (scene == NULL || !scene->scene_initialized)
+   {
+      result.x = 0.0;
+      result.y = 0.0;
+      result.z = 0.0;
+      result.w = 1.0;
+      return result;
+   }
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Return the current orientation of the actor in a thread-safe manner
-      px_scene->lockRead();
+      lockSceneRead(scene);
       result = rigidActor->getRotation();
-      px_scene->unlockRead();
+      unlockSceneRead(scene);
    }
    else
    {
@@ -1908,79 +2967,124 @@ PHYSX_API ActorOrientation getRotation(unsigned int id)
       result.w = 1.0;
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 
    // Return the orientation
    return result;
 }
 
 
-PHYSX_API void setLinearVelocity(unsigned int id, float x, float y, float z)
+PHYSX_API void setLinearVelocityInScene(unsigned int sceneID, unsigned int id,
+   float x, float y, float z)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_LINEAR_VELOCITY, "uufff", sceneID, id, x, y, z);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Update the linear velocity of the actor
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setLinearVelocity(x, y, z);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void setAngularVelocity(unsigned int id, float x, float y, float z)
+PHYSX_API void setAngularVelocityInScene(unsigned int sceneID, unsigned int id,
+   float x, float y, float z)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_ANGULAR_VELOCITY, "uufff", sceneID, id, x, y, z);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Update the angular velocity of the actor
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setAngularVelocity(x, y, z);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void setGravity(unsigned int id, float x, float y, float z)
+PHYSX_API void setGravityInScene(unsigned int sceneID, unsigned int id, float x,
+   float y, float z)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_GRAVITY, "uufff", sceneID, id, x, y, z);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Update the gravity to the new values
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setGravity(x, y, z);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
    else
    {
@@ -1989,130 +3093,205 @@ PHYSX_API void setGravity(unsigned int id, float x, float y, float z)
          "found.\n", id);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void enableGravity(unsigned int id, bool enabled)
+PHYSX_API void enableGravityInScene(unsigned int sceneID, unsigned int id,
+   bool enabled)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ENABLE_GRAVITY, "uub", sceneID, id, enabled);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Update the gravity of the actor
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->enableGravity(enabled);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void setLinearDamping(unsigned int id, float damping)
+PHYSX_API void setLinearDampingInScene(unsigned int sceneID, unsigned int id,
+   float damping)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_LINEAR_DAMPING, "uuf", sceneID, id, damping);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Set the linear damping coefficient
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setLinearDamping(damping);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void setAngularDamping(unsigned int id, float damping)
+PHYSX_API void setAngularDampingInScene(unsigned int sceneID, unsigned int id,
+   float damping)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_ANGULAR_DAMPING, "uuf", sceneID, id, damping);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
-   // Get the actor associated with the identifier from the map of actors
-   rigidActor = getActor(id);
+   // Get the actor associated with the identifier from the registry of actors
+   rigidActor = getActor(scene, id);
 
    // Make sure the actor was found
    if (rigidActor != NULL)
    {
       // Set the angular damping coefficient
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       rigidActor->setAngularDamping(damping);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API void updateShapeDensity(unsigned int id, unsigned int shapeID,
-   float density)
+PHYSX_API void updateShapeDensityInScene(unsigned int sceneID, unsigned int id,
+   unsigned int shapeID, float density)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_UPDATE_SHAPE_DENSITY, "uuuf", sceneID, id, shapeID,
+         density);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Fetch the actor based on the given ID
-   rigidActor = getActor(id);
+   rigidActor = getActor(scene, id);
 
    // Check to see if the desired actor was found
    if (rigidActor != NULL)
    {
       // Ensure the following operation is thread-safe
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
 
       // Update the density of the given shape
       rigidActor->setShapeDensity(shapeID, density);
 
       // Now that the operation is complete, unlocking writing to the scene
       // from other threads
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 }
 
 
-PHYSX_API bool updateActorMass(unsigned int id, float mass)
+PHYSX_API bool updateActorMassInScene(unsigned int sceneID, unsigned int id,
+   float mass)
 {
+   SceneReference      scene;
    PhysXRigidActor *   rigidActor;
    bool                result;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_UPDATE_ACTOR_MASS, "uuf", sceneID, id, mass);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return false;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return false;
+
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockRead();
 
    // Fetch the actor by the given id
-   rigidActor = getActor(id);
+   rigidActor = getActor(scene, id);
 
    // Update the mass for the actor if it is dynamic
    if (rigidActor != NULL && rigidActor->isDynamic())
    {
-      px_scene->lockWrite();
+      lockSceneWrite(scene);
       result = rigidActor->setMass(mass);
-      px_scene->unlockWrite();
+      unlockSceneWrite(scene);
    }
    else
    {
@@ -2120,18 +3299,34 @@ PHYSX_API bool updateActorMass(unsigned int id, float mass)
       result = false;
    }
 
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockRead();
 
    // Return whether the operaton was successful
    return result;
 }
 
 
-PHYSX_API void createGroundPlane(float x, float y, float z)
+PHYSX_API void createGroundPlaneInScene(unsigned int sceneID, float x, float y,
+   float z)
 {
-   PxTransform    planePos;
-   PxMaterial *   material;
+   SceneReference   scene;
+   PxTransform      planePos;
+   PxMaterial *     material;
+   PxShape *        planeShape;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_CREATE_GROUND_PLANE, "ufff", sceneID, x, y, z);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
 
    // Create the position for the plane and rotate it along the z-axis
    // by 90 degrees (used in second parameter)
@@ -2146,65 +3341,100 @@ PHYSX_API void createGroundPlane(float x, float y, float z)
    // Create a rigid static actor to represent the terrain and create
    // the plane geometry to define its shape
    // TODO: Allow normals to be passed in rather than assume OpenSim axes
-   ground_plane = PxCreatePlane(*px_physics, PxPlane(PxVec3(0,0,1),0),
+   scene->ground_plane = PxCreatePlane(*px_physics, PxPlane(PxVec3(0,0,1),0),
       *material);
 
+   // Place the plane in the static group of scene queries, like the shapes
+   // of static actors
+   scene->ground_plane->getShapes(&planeShape, 1);
+   planeShape->setQueryFilterData(PxFilterData(QUERY_GROUP_STATIC, 0, 0, 0));
+
    // Add the plane to the scene
-   px_scene->lockWrite();
-   px_scene->addActor(*ground_plane);
-   px_scene->unlockWrite();
+   lockSceneWrite(scene);
+   scene->px_scene->addActor(*scene->ground_plane);
+   unlockSceneWrite(scene);
 
    // Clean up the memory used by the material
    material->release();
 }
 
 
-PHYSX_API void releaseGroundPlane()
+PHYSX_API void releaseGroundPlaneInScene(unsigned int sceneID)
+{
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_RELEASE_GROUND_PLANE, "u", sceneID);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
+   // Remove the ground plane from the scene, if it has one
+   lockSceneWrite(scene);
+   if (scene->ground_plane != NULL)
+   {
+      scene->px_scene->removeActor(*scene->ground_plane);
+      scene->ground_plane = NULL;
+   }
+   unlockSceneWrite(scene);
+}
+
+
+PHYSX_API void setHeightFieldTileSizeInScene(unsigned int sceneID, int tileSize)
 {
-   // Remove the ground plane from the scene
-   px_scene->lockWrite();
-   px_scene->removeActor(*ground_plane);
-   ground_plane = NULL;
-   px_scene->unlockWrite();
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_HEIGHT_FIELD_TILE_SIZE, "ui", sceneID, tileSize);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Save the tile size used the next time the terrain is built; a size
+   // smaller than two keeps the terrain in a single height field
+   scene->terrain_tile_size = tileSize;
 }
 
 
-PHYSX_API void setHeightField(unsigned terrainActorID,
-   unsigned int terrainShapeID, int regionSizeX, int regionSizeY,
-   float rowSpacing, float columnSpacing, float * posts,
+PHYSX_API void setHeightFieldInScene(unsigned int sceneID,
+   unsigned terrainActorID, unsigned int terrainShapeID, int regionSizeX,
+   int regionSizeY, float rowSpacing, float columnSpacing, float * posts,
    float heightScaleFactor)
 {
-   PxHeightFieldDesc         heightFieldDescription;
-   uint64_t                  numPosts;
-   PxHeightFieldSample *     heightFieldSampleArray;
-   PxStridedData             stridedData;
-   PxHeightField *           heightField;
-   PxHeightFieldGeometry *   heightFieldGeometry;
-   PxMaterial *              physxMaterial;
-   PxShape *                 newShape;
+   SceneReference            scene;
+   PhysXHeightField *        heightField;
    PhysXRigidActor *         actor;
-   atInt *                   terrainID;
    float                     heightScale;
-
-   // TODO: Check that the terrain is added to the correct scene for 
-   // mega region support
+   bool                      result;
+   unsigned long long        startTime;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_SET_HEIGHT_FIELD, "uuuiiffFf", sceneID,
+         terrainActorID, terrainShapeID, regionSizeX, regionSizeY, rowSpacing,
+         columnSpacing, posts, regionSizeX * regionSizeY, heightScaleFactor);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
 
    // Make sure the scene has been initialized
-   if (scene_initialized != true)
+   if (scene->scene_initialized != true)
    {
       return;
    }
 
-   // In order to create the height field the number of data points is needed
-   // which uses the current size of the region, so the region sizes are saved
-   // here
-   heightFieldDescription.nbRows = regionSizeX;
-   heightFieldDescription.nbColumns = regionSizeY;
-
-   // For now, add a default thickness of 10 units to handle odd collision
-   // cases
-   heightFieldDescription.thickness = -10.0f;
-
    // Check to see if the given height scale value is valid. If so, use it.
    // Otherwise, use the default scale factor
    if (heightScaleFactor > 0.0)
@@ -2212,122 +3442,165 @@ PHYSX_API void setHeightField(unsigned terrainActorID,
    else
       heightScale = default_height_field_scale;
 
-   // Determine the number of datapoints inside of the posts array
-   numPosts = regionSizeX * regionSizeY;
-
-   // Initialize a height field sample array to store the posts data translated
-   // for PhysX
-   heightFieldSampleArray = new PxHeightFieldSample[numPosts];
-
-   // Loop through all of the posts
-   for (int i = 0; i < numPosts; i++)
+   // Ensure that the following operations on the terrain are thread-safe
+   scene->actor_registry->lockWrite();
+
+   // If the existing terrain has the same layout, patch the new posts into it
+   // in place; this keeps the actor and its shapes, so that objects resting
+   // on the terrain aren't disturbed (height fields can't be modified while
+   // a step is in flight though, in which case the patch is queued until the
+   // next step begins, just like the patches of updateHeightField)
+   // NOTE: The posts of the region are laid out in rows of regionSizeY posts
+   if (scene->terrain != NULL && scene->terrain_actor_id == terrainActorID &&
+       scene->terrain->hasLayout(regionSizeX, regionSizeY, rowSpacing,
+          columnSpacing, heightScale, scene->terrain_tile_size))
    {
-      // Copy the current height field posts into the sample array, while
-      // translating them for PhysX
-      // NOTE: The posts are scaled to match PhysX data, but as this can cause
-      // a loss of precision, an expanding scale is used to preserve as much
-      // precision as possible
-      // NOTE: Both the incoming height field and the sample array have
-      // row-major ordering, so the elements can be copied directly
-      heightFieldSampleArray[i].height = (PxI16)(posts[i] /
-         heightScale);
-
-      // For now, differing materials are not supported in the height field, so
-      // the default material indices are used
-      heightFieldSampleArray[i].materialIndex0 = 1;
-      heightFieldSampleArray[i].materialIndex1 = 1;
+      lockSceneWrite(scene);
+      if (scene->simulation_running)
+      {
+         scene->terrain->queueUpdate(0, 0, regionSizeX, regionSizeY, posts,
+            regionSizeY);
+      }
+      else
+      {
+         startTime = PhysXHistogram::getTime();
+         scene->terrain->update(0, 0, regionSizeX, regionSizeY, posts,
+            regionSizeY);
+         scene->statistics->cook_times.addSampleSince(startTime);
+      }
+      unlockSceneWrite(scene);
+      scene->actor_registry->unlockWrite();
+      return;
    }
 
-   // Store the sample array inside of strided data for storage inside of the
-   // height field description
-   stridedData.data = heightFieldSampleArray;
-   stridedData.stride = sizeof(PxHeightFieldSample);
-
-   // Tell PhysX that a 16 bit integer height value will be used for the data
-   heightFieldDescription.format = PxHeightFieldFormat::eS16_TM;
-
-   // Store the sample array inside of the height field description
-   heightFieldDescription.samples = stridedData;
-
-   // Cooks the height field using the description that was just created
-   heightField = px_cooking->createHeightField(heightFieldDescription,
-      px_physics->getPhysicsInsertionCallback());
-
-   // Check that the height field was successfully created
-   if (heightField == NULL)
+   // Build the height fields and shapes of the new terrain, which counts
+   // towards the time spent cooking
+   startTime = PhysXHistogram::getTime();
+   heightField = new PhysXHeightField(px_physics, px_cooking,
+      scene->cpu_threads);
+   result = heightField->build(regionSizeX, regionSizeY, rowSpacing,
+      columnSpacing, heightScale, scene->terrain_tile_size, posts);
+   scene->statistics->cook_times.addSampleSince(startTime);
+   if (!result)
    {
-      // Send error message to the user
-      logger->notify(AT_ERROR, "Failed to create height field.\n");
-
-      // Clean up resources and break out of the method, since the height field
-      // doesn't exist
-      delete heightFieldSampleArray;
+      // The terrain could not be built, so keep the existing one
+      delete heightField;
+      scene->actor_registry->unlockWrite();
       return;
    }
 
-   // Use the height field, scale, and spacing of posts to create a height
-   // field geometry
-   heightFieldGeometry = new PxHeightFieldGeometry(heightField,
-      PxMeshGeometryFlags(), heightScale, rowSpacing, columnSpacing);
-
-   // Create a default material
-   // TODO: Allow this to be passed into function rather than assuming
-   // default for OpenSim
-   physxMaterial = px_physics->createMaterial(0.2f, 0.2f, 0.0f);
-
-   // Use the geometry and material to create the terrain shape
-   newShape = px_physics->createShape(*heightFieldGeometry, *physxMaterial,
-      true);
+   // Ensure that the following changes to the scene are thread-safe
+   lockSceneWrite(scene);
 
    // Check if the scene already has a loaded terrain so that it can be removed
-   // before the next terrain is loaded
-   terrainID = new atInt(terrainActorID);
-   if (actor_map->containsKey(terrainID))
+   // before the next terrain is loaded; the actor is removed from the
+   // registry, but a reference is kept so the memory can be cleaned up after
+   // the actor has been removed from the PhysX scene
+   actor = scene->actor_registry->removeActor(terrainActorID);
+   if (actor != NULL)
    {
-      // Remove the actor from the map of actors, but keep a reference so the
-      // memory can be cleaned up after the actor has been removed from the
-      // PhysX scene
-      actor = (PhysXRigidActor*) actor_map->removeEntry(terrainID);
-
       // Remove the actor from the PhysX scene
-      px_scene->removeActor(*(actor->getActor()), false);
+      scene->px_scene->removeActor(*(actor->getActor()), false);
 
       // Clean up the memory used by the Terrain actor
       delete actor;
    }
 
-   // Create a static actor to hold the terrain height map shape
-   actor = createRigidActor(terrainID->getValue(), "terrain", 0.0f, 0.0f, 0.0f,
+   // The height fields of the old terrain are no longer used by any shape
+   delete scene->terrain;
+   scene->terrain = heightField;
+   scene->terrain_actor_id = terrainActorID;
+
+   // Create a static actor to hold the terrain height map shapes and attach
+   // the shape of every tile
+   actor = createRigidActor(scene, terrainActorID, "terrain", 0.0f, 0.0f, 0.0f,
       false, false);
+   scene->terrain->attachTo(actor, terrainShapeID);
 
-   // Rotate the height map to the correct world position, this is needed
-   // because the height map is just a list of heights and doesn't include the
-   // position or orientation
-   // TODO: Alter this to allow for mega regions
-   newShape->setLocalPose(PxTransform(PxVec3(0.0f, 0.0f, 0.0f),
-      PxQuat(0.5f, 0.5f, 0.5f, 0.5f)));
+   // Add the newly created actor to the scene
+   scene->px_scene->addActor(*(actor->getActor()));
+
+   // Now that the terrain has been replaced, unlock the scene and registry
+   unlockSceneWrite(scene);
+   scene->actor_registry->unlockWrite();
+}
 
-   // Add the shape for the terrain to the actor that has been added to the
-   // scene (use a 0 density, as it will not matter for the static height field)
-   actor->addShape(terrainShapeID, newShape, 0.0f);
 
-   // Add the newly created actor to the scene
-   px_scene->lockWrite();
-   px_scene->addActor(*(actor->getActor()));
-   px_scene->unlockWrite();
+PHYSX_API bool updateHeightFieldInScene(unsigned int sceneID,
+   unsigned int terrainActorID, int startRow, int startColumn, int rowCount,
+   int columnCount, float * posts)
+{
+   SceneReference       scene;
+   bool                 result;
+   unsigned long long   startTime;
 
-   // Clean-up
-   delete terrainID;
-   delete heightFieldSampleArray;
-   delete heightFieldGeometry;
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_UPDATE_HEIGHT_FIELD, "uuiiiiF", sceneID,
+         terrainActorID, startRow, startColumn, rowCount, columnCount, posts,
+         rowCount * columnCount);
 
-   // Clean up the memory used by the material
-   physxMaterial->release();
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return false;
+
+   // Make sure the scene has been initialized
+   if (scene->scene_initialized != true)
+   {
+      return false;
+   }
+
+   // Ensure that the following operations are thread-safe; the registry
+   // keeps the terrain from being replaced while it is being updated
+   scene->actor_registry->lockRead();
+   lockSceneWrite(scene);
+
+   // There has to be a terrain to update
+   result = false;
+   if (scene->terrain == NULL || scene->terrain_actor_id != terrainActorID)
+   {
+      logger->notify(AT_WARN, "Failed to update height field! Terrain %u "
+         "not found.\n", terrainActorID);
+   }
+   else if (scene->simulation_running)
+   {
+      // Height fields can't be modified while a step is in flight, so queue
+      // the patch until the next step begins
+      result = scene->terrain->queueUpdate(startRow, startColumn, rowCount,
+         columnCount, posts, columnCount);
+      if (!result)
+      {
+         logger->notify(AT_WARN, "Failed to update height field! The "
+            "rectangle lies outside of the terrain.\n");
+      }
+   }
+   else
+   {
+      // Patch the given rectangle of posts into the existing height fields,
+      // which counts towards the time spent cooking
+      startTime = PhysXHistogram::getTime();
+      result = scene->terrain->update(startRow, startColumn, rowCount,
+         columnCount, posts, columnCount);
+      scene->statistics->cook_times.addSampleSince(startTime);
+      if (!result)
+      {
+         logger->notify(AT_WARN, "Failed to update height field! The "
+            "rectangle lies outside of the terrain.\n");
+      }
+   }
+
+   // Now that the operations are complete, unlock the scene and registry
+   unlockSceneWrite(scene);
+   scene->actor_registry->unlockRead();
+
+   // Return whether the terrain was updated
+   return result;
 }
 
 
-void constructJoint(unsigned int jointID, PhysXRigidActor * actor1,
-   PhysXRigidActor * actor2, float * actor1Pos,
+void constructJoint(PhysXScene * scene, unsigned int jointID,
+   PhysXRigidActor * actor1, PhysXRigidActor * actor2, float * actor1Pos,
    float * actor1Quat, float * actor2Pos, float * actor2Quat,
    float * linearLowerLimit, float * linearUpperLimit,
    float * angularLowerLimit, float * angularUpperLimit)
@@ -2370,7 +3643,7 @@ void constructJoint(unsigned int jointID, PhysXRigidActor * actor1,
       PxQuat(actor2Quat[0], actor2Quat[1], actor2Quat[2], actor2Quat[3]));
 
    // Create a new D6 joint between the given actors
-   px_scene->lockWrite();
+   lockSceneWrite(scene);
    joint = PxD6JointCreate(
       *px_physics, rigidActor1, actor1Frame, rigidActor2, actor2Frame);
 
@@ -2471,7 +3744,7 @@ void constructJoint(unsigned int jointID, PhysXRigidActor * actor1,
    }
 
    // Now that the joint creation is done, unlock writing
-   px_scene->unlockWrite();
+   unlockSceneWrite(scene);
 
    // Obtain IDs for both given actors (if they are valid)
    actor1ID = 0;
@@ -2485,45 +3758,61 @@ void constructJoint(unsigned int jointID, PhysXRigidActor * actor1,
    physXJoint = new PhysXJoint(jointID, actor1ID, actor2ID, joint);
 
    // Save reference to the new joint
-   joint_map->addEntry(new atInt(jointID), physXJoint);
+   scene->joint_map->addEntry(new atInt(jointID), physXJoint);
 }
 
 
-PHYSX_API void addJoint(unsigned int jointID, unsigned int actorID1,
-   unsigned int actorID2, float * actor1Pos,
-   float * actor1Quat, float * actor2Pos,
-   float * actor2Quat, float * linearLowerLimit,
-   float * linearUpperLimit, float * angularLowerLimit,
-   float * angularUpperLimit)
+PHYSX_API void addJointInScene(unsigned int sceneID, unsigned int jointID,
+   unsigned int actorID1, unsigned int actorID2, float * actor1Pos,
+   float * actor1Quat, float * actor2Pos, float * actor2Quat,
+   float * linearLowerLimit, float * linearUpperLimit,
+   float * angularLowerLimit, float * angularUpperLimit)
 {
+   SceneReference      scene;
    PhysXJoint *        physXJoint;
    PhysXRigidActor *   actor1;
    PhysXRigidActor *   actor2;
    atInt *             jointKey;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ADD_JOINT, "uuuuFFFFFFFF", sceneID, jointID,
+         actorID1, actorID2, actor1Pos, 3, actor1Quat, 4, actor2Pos, 3,
+         actor2Quat, 4, linearLowerLimit, 3, linearUpperLimit, 3,
+         angularLowerLimit, 3, angularUpperLimit, 3);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Create a key from the joint ID, so that it can be used to search
    // the joint map
    jointKey = new atInt(jointID);
 
    // Check whether or not a joint with the given ID already exists;
    // can't have the same IDs for different joints
-   physXJoint = (PhysXJoint *) joint_map->getValue(jointKey);
+   physXJoint = (PhysXJoint *) scene->joint_map->getValue(jointKey);
    if (physXJoint == NULL)
    {
       // Ensure that the following operations are thread-safe
-      pthread_mutex_lock(&actor_map_mutex);
+      scene->actor_registry->lockWrite();
  
       // Get the actors associated with a joint from the given actor IDs
-      actor1 = getActor(actorID1);
-      actor2 = getActor(actorID2);
+      actor1 = getActor(scene, actorID1);
+      actor2 = getActor(scene, actorID2);
  
       // Construct the joint using the actors that were found
-      constructJoint(jointID, actor1, actor2, actor1Pos, actor1Quat, actor2Pos,
-                     actor2Quat, linearLowerLimit, linearUpperLimit,
+      constructJoint(scene, jointID, actor1, actor2, actor1Pos, actor1Quat,
+                     actor2Pos, actor2Quat, linearLowerLimit, linearUpperLimit,
                      angularLowerLimit, angularUpperLimit);
  
-      // Now that the operations are complete, unlock the mutex
-      pthread_mutex_unlock(&actor_map_mutex);
+      // Now that the operations are complete, unlock the registry
+      scene->actor_registry->unlockWrite();
    }
 
    // Now that the operation is complete, clean up the key
@@ -2531,44 +3820,60 @@ PHYSX_API void addJoint(unsigned int jointID, unsigned int actorID1,
 }
 
 
-PHYSX_API void addGlobalFrameJoint(unsigned int jointID, unsigned int actorID,
-   float * actorPos, float * actorQuat, float * linearLowerLimit,
-   float * linearUpperLimit, float * angularLowerLimit,
-   float * angularUpperLimit)
+PHYSX_API void addGlobalFrameJointInScene(unsigned int sceneID,
+   unsigned int jointID, unsigned int actorID, float * actorPos,
+   float * actorQuat, float * linearLowerLimit, float * linearUpperLimit,
+   float * angularLowerLimit, float * angularUpperLimit)
 {
+   SceneReference      scene;
    PhysXJoint *        physXJoint;
    PhysXRigidActor *   actor1;
    PhysXRigidActor *   actor2;
    atInt *             jointKey;
 
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_ADD_GLOBAL_FRAME_JOINT, "uuuFFFFFF", sceneID,
+         jointID, actorID, actorPos, 3, actorQuat, 4, linearLowerLimit, 3,
+         linearUpperLimit, 3, angularLowerLimit, 3, angularUpperLimit, 3);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
+
    // Create a key from the joint ID, so that it can be used to search
    // the joint map
    jointKey = new atInt(jointID);
 
    // Check whether or not a joint with the given ID already exists;
    // can't have the same IDs for different joints
-   physXJoint = (PhysXJoint *) joint_map->getValue(jointKey);
+   physXJoint = (PhysXJoint *) scene->joint_map->getValue(jointKey);
    if (physXJoint != NULL)
    {
       return;
    }
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
    // Find the actor with the given ID
-   actor1 = getActor(actorID);
+   actor1 = getActor(scene, actorID);
 
    // The second actor will be null in order to signify the global frame
    actor2 = NULL;
 
    // Construct the joint using the actors that were found
-   constructJoint(jointID, actor1, actor2, actorPos, actorQuat, actorPos,
+   constructJoint(scene, jointID, actor1, actor2, actorPos, actorQuat, actorPos,
                   actorQuat, linearLowerLimit, linearUpperLimit,
                   angularLowerLimit, angularUpperLimit);
  
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 
    // Now that the operation is complete, clean up the key
    delete jointKey;
@@ -2576,93 +3881,334 @@ PHYSX_API void addGlobalFrameJoint(unsigned int jointID, unsigned int actorID,
 
 
 
-PHYSX_API void removeJoint(unsigned int id)
+PHYSX_API void removeJointInScene(unsigned int sceneID, unsigned int id)
 {
-   atInt *        jointKey;
-   PhysXJoint *   joint;
+   SceneReference   scene;
+   atInt *          jointKey;
+   PhysXJoint *     joint;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_REMOVE_JOINT, "uu", sceneID, id);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return;
 
    // Create a temporary key for map lookup
    jointKey = new atInt(id);
 
    // Ensure that the following operations are thread-safe
-   pthread_mutex_lock(&actor_map_mutex);
+   scene->actor_registry->lockWrite();
 
    // Remove the given joint from the map
-   joint = (PhysXJoint *) joint_map->removeEntry(jointKey);
+   joint = (PhysXJoint *) scene->joint_map->removeEntry(jointKey);
 
    // Clean up the joint if it existed in a thread-safe manner
-   px_scene->lockWrite();
+   lockSceneWrite(scene);
    if (joint != NULL)
    {
       // Clean up the joint
       delete joint;
    }
-   px_scene->unlockWrite();
+   unlockSceneWrite(scene);
  
-   // Now that the operations are complete, unlock the mutex
-   pthread_mutex_unlock(&actor_map_mutex);
+   // Now that the operations are complete, unlock the registry
+   scene->actor_registry->unlockWrite();
 
    // Clean up the temporary key
    delete jointKey;
 }
 
 
-PHYSX_API void simulate(float time,
-   unsigned int * updatedEntityCount, unsigned int * updatedCollisionCount)
+PHYSX_API int applyCommandsInScene(unsigned int sceneID, void * commandBuffer,
+   int bufferSize, unsigned int * commandResults)
 {
-   const PxActiveTransform *   activeTransforms;
-   PxRigidDynamic *            actor;
-   atInt *                     actorID;
-   unsigned int                numTransforms;
-   PxVec3                      position;
-   PxQuat                      rotation;
-   PxVec3                      velocity;
-   PxVec3                      angularVelocity;
+   SceneReference   scene;
+   ActorCommand *   commands;
+   int              commandCount;
+   int              failureCount;
+   CommandStatus    status;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_APPLY_COMMANDS, "uCb", sceneID, commandBuffer,
+         bufferSize, commandResults != NULL);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return -1;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return -1;
+
+   // Reject the buffer as a whole if it isn't well-formed
+   commandCount = PhysXCommandQueue::validateBuffer(commandBuffer, bufferSize);
+   if (commandCount < 0)
+      return -1;
+
+   // The commands directly follow the header of the buffer
+   commands = (ActorCommand *)
+      ((char *) commandBuffer + sizeof(CommandBufferHeader));
+
+   // Ensure that the following operations are thread-safe; both locks are
+   // acquired once for the entire batch
+   scene->actor_registry->lockRead();
+   lockSceneWrite(scene);
+
+   // While a step is in flight the commands can't take effect until it ends,
+   // so queue them for the next step instead
+   if (scene->simulation_running)
+   {
+      unlockSceneWrite(scene);
+      scene->actor_registry->unlockRead();
+
+      scene->command_queue->appendBuffer(commandBuffer, bufferSize);
+      if (commandResults != NULL)
+      {
+         for (int i = 0; i < commandCount; i++)
+            commandResults[i] = (unsigned int) COMMAND_QUEUED;
+      }
+
+      return 0;
+   }
+
+   // Apply each command, reporting its outcome if the caller asked for it
+   failureCount = 0;
+   for (int i = 0; i < commandCount; i++)
+   {
+      status = applyActorCommand(scene, &commands[i]);
+      if (status != COMMAND_SUCCEEDED)
+         failureCount++;
+
+      if (commandResults != NULL)
+         commandResults[i] = (unsigned int) status;
+   }
+
+   // Now that the operations are complete, unlock the scene and the registry
+   unlockSceneWrite(scene);
+   scene->actor_registry->unlockRead();
+
+   // Return the number of commands that could not be applied
+   return failureCount;
+}
+
+
+PHYSX_API bool queueCommandsInScene(unsigned int sceneID, void * commandBuffer,
+   int bufferSize)
+{
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_QUEUE_COMMANDS, "uC", sceneID, commandBuffer,
+         bufferSize);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return false;
+
+   // Copy the commands onto the queue, where they will wait to be applied at
+   // the start of the next simulation step
+   return scene->command_queue->appendBuffer(commandBuffer, bufferSize);
+}
+
+
+PHYSX_API void initCommandFailureUpdateInScene(unsigned int sceneID,
+   CommandFailure * failureArray, int maxFailures)
+{
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_INIT_COMMAND_FAILURE_UPDATE, "ui", sceneID,
+         maxFailures);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Keep reference to the given array for reporting queued commands that
+   // failed, along with its size
+   scene->command_queue->setFailureArray(failureArray, maxFailures);
+}
 
-   // Ensure that the following operations are thread-safe
-   px_scene->lockWrite();
+
+PHYSX_API void getCommandFailuresInScene(unsigned int sceneID,
+   unsigned int * failureCount)
+{
+   SceneReference   scene;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_GET_COMMAND_FAILURES, "u", sceneID);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Report the number of queued commands that have failed since the last
+   // call; the failures themselves were written to the failure array
+   scene->command_queue->getFailures(failureCount);
+}
+
+
+PHYSX_API bool beginSimulateInScene(unsigned int sceneID, float time)
+{
+   SceneReference       scene;
+   unsigned long long   startTime;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_BEGIN_SIMULATE, "uf", sceneID, time);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return false;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return false;
+
+   // Ensure that the following operations are thread-safe; the registry is
+   // only needed while the queued commands are applied, but it has to be
+   // locked before the scene to keep the lock order consistent
+   scene->actor_registry->lockRead();
+   lockSceneWrite(scene);
+
+   // Only one step may be in flight at a time
+   if (scene->simulation_running)
+   {
+      unlockSceneWrite(scene);
+      scene->actor_registry->unlockRead();
+      logger->notify(AT_WARN, "Unable to begin simulation step. The previous "
+         "step has not been ended.\n");
+      return false;
+   }
+
+   // Apply the commands and terrain patches that were queued since the last
+   // step, so that they take effect in this step; the patches count towards
+   // the time spent cooking
+   applyQueuedCommands(scene);
+   if (scene->terrain != NULL)
+   {
+      startTime = PhysXHistogram::getTime();
+      if (scene->terrain->applyQueuedUpdates() > 0)
+         scene->statistics->cook_times.addSampleSince(startTime);
+   }
+   scene->actor_registry->unlockRead();
+
+   // Contacts are reported while the results are fetched, so point the
+   // collision callback at the buffer that this step will fill
+   setCollisionTarget(scene);
 
    // Mark the start time of the simulate call to get an accurate measurement
    // of how long the simulate call takes to run
-   #ifdef LIB_PHYSX_DEBUG
-      profiling_timer->mark();
-   #endif
+   scene->step_timer->mark();
 
-   // Advance the world forward in time
-   px_scene->simulate(time);
+   // Start advancing the world forward in time; the step runs on the
+   // dispatcher's worker threads while the caller goes on with other work
+   scene->px_scene->simulate(time);
+   scene->simulation_running = true;
 
-   // Mark and record how long it took for the simulate call to finish, then
-   // remark the timer for the next profile
+   // Mark and record how long it took for the simulate call to return
+   scene->step_timer->mark();
+   scene->step_timings.SimulateTime =
+      scene->step_timer->getInterval() * 1000.0f;
    #ifdef LIB_PHYSX_DEBUG
-      profiling_timer->mark();
-      logger->notify(AT_INFO, "PhysX simulate time = %fMS\n", 
-         profiling_timer->getInterval() * 1000.0f);
-      profiling_timer->mark();
+      logger->notify(AT_INFO, "PhysX simulate time = %fMS\n",
+         scene->step_timings.SimulateTime);
    #endif
 
-   // Allow the simulation to finish and indicate that it should
-   // wait until it is completed
-   px_scene->fetchResults(true);
-   
-   // Mark and record how long it took for the fetch results call to finish, 
-   // then remark the timer for the next profile
-   #ifdef LIB_PHYSX_DEBUG
-      profiling_timer->mark();
-      logger->notify(AT_INFO, "PhysX fetch results time = %fMS\n", 
-         profiling_timer->getInterval() * 1000.0f);
-      profiling_timer->mark();
-   #endif
+   // Add the time to the statistics, which are kept in microseconds
+   scene->statistics->simulate_times.addSample(
+      (unsigned long long) (scene->step_timings.SimulateTime * 1000.0f));
+
+   // Release the scene so that other calls can proceed while the step runs
+   unlockSceneWrite(scene);
+   return true;
+}
+
+
+PHYSX_API bool pollSimulateInScene(unsigned int sceneID)
+{
+   SceneReference   scene;
+   bool             result;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_POLL_SIMULATE, "u", sceneID);
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return false;
+
+   // There is nothing to operate on until the scene has been created
+   if (!scene->scene_initialized)
+      return false;
+
+   // Ensure that the following operations are thread-safe
+   lockSceneRead(scene);
+
+   // Check, without blocking, whether the step in flight has finished; when
+   // no step is in flight there is nothing to wait for
+   if (scene->simulation_running)
+      result = scene->px_scene->checkResults(false);
+   else
+      result = true;
+
+   // Now that the operations are complete, unlock the scene
+   unlockSceneRead(scene);
+
+   // Return whether endSimulate can be called without blocking
+   return result;
+}
+
+
+// Fills the given array with the state of the actors that moved during the
+// last step; the caller must hold the scene's write lock
+unsigned int fillEntityUpdates(PhysXScene * scene,
+   EntityProperties * updates)
+{
+   const PxActiveTransform *   activeTransforms;
+   PxRigidDynamic *            actor;
+   atInt *                     actorID;
+   unsigned int                numTransforms;
+   unsigned int                maxUpdates;
+   PxVec3                      position;
+   PxQuat                      rotation;
+   PxVec3                      velocity;
+   PxVec3                      angularVelocity;
+
+   // The update array holds at most the number of updates it was
+   // initialized with, which is never negative
+   if (scene->max_updates > 0)
+      maxUpdates = (unsigned int) scene->max_updates;
+   else
+      maxUpdates = 0;
 
    // Retrieve the array of actors that have been active since
    // the last simulation step
    numTransforms = 0;
-   activeTransforms = px_scene->getActiveTransforms(numTransforms);
+   activeTransforms = scene->px_scene->getActiveTransforms(numTransforms);
 
    // Go through all active actors
    for (unsigned int i = 0; i < numTransforms; i++)
    {
       // We are only able to make a certain amount of updates for each step
-      if (i >= max_updates)
+      if (i >= maxUpdates)
          break;
 
       // Get the affected actor and its ID from its user data
@@ -2671,70 +4217,774 @@ PHYSX_API void simulate(float time,
 
       // Update the actor's position
       position = activeTransforms[i].actor2World.p;
-      update_array[i].PositionX = position.x;
-      update_array[i].PositionY = position.y;
-      update_array[i].PositionZ = position.z;
+      updates[i].PositionX = position.x;
+      updates[i].PositionY = position.y;
+      updates[i].PositionZ = position.z;
 
       // Update the actor's orientation
       rotation = activeTransforms[i].actor2World.q;
-      update_array[i].RotationX = rotation.x;
-      update_array[i].RotationY = rotation.y;
-      update_array[i].RotationZ = rotation.z;
-      update_array[i].RotationW = rotation.w;
+      updates[i].RotationX = rotation.x;
+      updates[i].RotationY = rotation.y;
+      updates[i].RotationZ = rotation.z;
+      updates[i].RotationW = rotation.w;
 
       // Update the actor's velocity
       velocity = actor->getLinearVelocity();
-      update_array[i].VelocityX = velocity.x;
-      update_array[i].VelocityY = velocity.y;
-      update_array[i].VelocityZ = velocity.z;
+      updates[i].VelocityX = velocity.x;
+      updates[i].VelocityY = velocity.y;
+      updates[i].VelocityZ = velocity.z;
 
       // Update the actor's angular velocity
       angularVelocity = actor->getAngularVelocity();
-      update_array[i].AngularVelocityX = angularVelocity.x;
-      update_array[i].AngularVelocityY = angularVelocity.y;
-      update_array[i].AngularVelocityZ = angularVelocity.z;
+      updates[i].AngularVelocityX = angularVelocity.x;
+      updates[i].AngularVelocityY = angularVelocity.y;
+      updates[i].AngularVelocityZ = angularVelocity.z;
 
       // Save the actor's ID if one was saved in the actor's user data;
       // if the ID wasn't found, that means that this is an actor that
       // we are not keeping track of so just give it a default ID value
       if (actorID != NULL)
-         update_array[i].ID = actorID->getValue();
+         updates[i].ID = actorID->getValue();
       else
-         update_array[i].ID = 0;
+         updates[i].ID = 0;
    }  
 
-   // Update the number of active transforms and collisions,
-   // in this step, by reference
-   if (numTransforms < max_updates)
+   // Keep track of how many actors moved during the step, and of how many
+   // of them didn't fit into the update array
+   scene->statistics->active_actors = numTransforms;
+   if (numTransforms > maxUpdates)
+      scene->statistics->truncated_updates += numTransforms - maxUpdates;
+
+   // Return the number of updates that were written
+   if (numTransforms < maxUpdates)
+      return numTransforms;
+   else
+      return maxUpdates;
+}
+
+
+PHYSX_API int endSimulateInScene(unsigned int sceneID,
+   unsigned int * updatedEntityCount, unsigned int * updatedCollisionCount,
+   unsigned int * droppedCollisionCount)
+{
+   SceneReference   scene;
+   int              filledBuffer;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_END_SIMULATE, "ub", sceneID,
+         droppedCollisionCount != NULL);
+
+   // Find the scene that the call operates on; there are no results if it
+   // doesn't exist or hasn't been created yet
+   scene = getScene(sceneID);
+   if (scene == NULL || !scene->scene_initialized)
    {
-      *updatedEntityCount = numTransforms;
+      *updatedEntityCount = 0;
+      *updatedCollisionCount = 0;
+      if (droppedCollisionCount != NULL)
+         *droppedCollisionCount = 0;
+      return -1;
    }
-   else
+
+   // Ensure that the following operations are thread-safe
+   lockSceneWrite(scene);
+
+   // There are no results unless a step was begun
+   if (!scene->simulation_running)
    {
-      *updatedEntityCount = max_updates;
+      unlockSceneWrite(scene);
+      *updatedEntityCount = 0;
+      *updatedCollisionCount = 0;
+      if (droppedCollisionCount != NULL)
+         *droppedCollisionCount = 0;
+      return -1;
    }
-   
-   // Mark and record how long it took for the update array to be filled, then
-   // remark the timer for the next profile
+
+   // Mark the start time of the fetch to get an accurate measurement of how
+   // long the caller had to wait for the step to finish
+   scene->step_timer->mark();
+
+   // Wait for the step to finish (if it hasn't already) and make its results
+   // visible; the contacts of the step are reported during this call
+   scene->px_scene->fetchResults(true);
+   scene->simulation_running = false;
+
+   // Mark and record how long it took for the fetch results call to finish;
+   // the mark also starts the timing of the update array
+   scene->step_timer->mark();
+   scene->step_timings.FetchTime = scene->step_timer->getInterval() * 1000.0f;
+   #ifdef LIB_PHYSX_DEBUG
+      logger->notify(AT_INFO, "PhysX fetch results time = %fMS\n",
+         scene->step_timings.FetchTime);
+   #endif
+
+   // Fill the current pair of buffers with the results of the step
+   filledBuffer = scene->current_buffer;
+   *updatedEntityCount = fillEntityUpdates(scene,
+      scene->update_buffers[filledBuffer]);
+
+   // Mark and record how long it took for the update array to be filled;
+   // the mark also starts the timing of the collisions
+   scene->step_timer->mark();
+   scene->step_timings.UpdateTime = scene->step_timer->getInterval() * 1000.0f;
    #ifdef LIB_PHYSX_DEBUG
-      profiling_timer->mark();
       logger->notify(AT_INFO, "Update array finished time = %fMS\n",
-         profiling_timer->getInterval() * 1000.0f);
-      profiling_timer->mark();
+         scene->step_timings.UpdateTime);
    #endif
 
-   px_collisions->getCollisions(updatedCollisionCount);
+   // Write out the collisions of the step, keeping track of how many contact
+   // points did not fit into the buffer
+   scene->px_collisions->getCollisions(updatedCollisionCount,
+      &scene->dropped_collisions);
+   if (droppedCollisionCount != NULL)
+      *droppedCollisionCount = scene->dropped_collisions;
+
+   // Mark and record how long it took for the getCollisions call to finish
+   scene->step_timer->mark();
+   scene->step_timings.CollisionTime =
+      scene->step_timer->getInterval() * 1000.0f;
+
+   // Add the step to the statistics, which keep their times in microseconds
+   scene->statistics->fetch_times.addSample(
+      (unsigned long long) (scene->step_timings.FetchTime * 1000.0f));
+   scene->statistics->update_times.addSample(
+      (unsigned long long) (scene->step_timings.UpdateTime * 1000.0f));
+   scene->statistics->collision_times.addSample(
+      (unsigned long long) (scene->step_timings.CollisionTime * 1000.0f));
+   scene->statistics->contact_pairs =
+      scene->px_collisions->getContactPairCount();
+   scene->statistics->truncated_collisions += scene->dropped_collisions;
+
+   // Alternate to the other pair of buffers for the next step, so that the
+   // caller can keep reading these results while that step runs
+   scene->current_buffer = 1 - scene->current_buffer;
 
    // Release the write lock acquired earlier in this method, now that the
    // operation are complete
-   px_scene->unlockWrite();
+   unlockSceneWrite(scene);
 
-   // Mark and record how long it took for the getCollisions call to finish, 
-   // then clean up the timer so no memory is leaked
+   // Report the time spent on the collisions
    #ifdef LIB_PHYSX_DEBUG
-      profiling_timer->mark();
       logger->notify(AT_INFO, "Get collisions time = %fMS\n",
-         profiling_timer->getInterval() * 1000.0f);
+         scene->step_timings.CollisionTime);
    #endif
+
+   // Return which pair of buffers now holds the results
+   return filledBuffer;
+}
+
+
+PHYSX_API void simulateInScene(unsigned int sceneID, float time,
+   unsigned int * updatedEntityCount, unsigned int * updatedCollisionCount)
+{
+   // Run a complete step and wait for its results
+   if (beginSimulateInScene(sceneID, time))
+   {
+      endSimulateInScene(sceneID, updatedEntityCount, updatedCollisionCount,
+         NULL);
+   }
+   else
+   {
+      *updatedEntityCount = 0;
+      *updatedCollisionCount = 0;
+   }
+}
+
+
+PHYSX_API void getStepTimingsInScene(unsigned int sceneID,
+   StepTimings * timings)
+{
+   SceneReference   scene;
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return;
+
+   // Report how long each phase of the last step took; the timings only
+   // change while the scene's write lock is held
+   if (scene->scene_initialized)
+   {
+      lockSceneRead(scene);
+      *timings = scene->step_timings;
+      unlockSceneRead(scene);
+   }
+   else
+   {
+      *timings = scene->step_timings;
+   }
+}
+
+
+PHYSX_API void getStatisticsInScene(unsigned int sceneID,
+   PhysicsStatistics * statistics, bool reset)
+{
+   SceneReference   scene;
+
+   // Find the scene that the call operates on; there are no statistics if
+   // it doesn't exist
+   scene = getScene(sceneID);
+   if (scene == NULL)
+   {
+      memset(statistics, 0, sizeof(PhysicsStatistics));
+      return;
+   }
+
+   // The counters only change while the scene's write lock is held, so hold
+   // the read lock while copying them, or the write lock if they are about
+   // to be reset; the histograms can be read at any time
+   scene->actor_registry->lockRead();
+   if (scene->scene_initialized)
+   {
+      if (reset)
+         lockSceneWrite(scene);
+      else
+         lockSceneRead(scene);
+   }
+
+   // Copy the histograms
+   scene->statistics->simulate_times.read(&statistics->SimulateTime);
+   scene->statistics->fetch_times.read(&statistics->FetchTime);
+   scene->statistics->update_times.read(&statistics->UpdateTime);
+   scene->statistics->collision_times.read(&statistics->CollisionTime);
+   scene->actor_registry->getLockTimes(&statistics->RegistryWaitTime,
+      &statistics->RegistryHoldTime);
+   scene->statistics->lock_wait_times.read(&statistics->SceneWaitTime);
+   scene->statistics->lock_hold_times.read(&statistics->SceneHoldTime);
+   scene->statistics->cook_times.read(&statistics->CookTime);
+
+   // Copy the counters
+   statistics->ActorCount = scene->actor_registry->getNumActors();
+   statistics->ActiveActors = scene->statistics->active_actors;
+   statistics->ContactPairs = scene->statistics->contact_pairs;
+   statistics->TruncatedUpdates = scene->statistics->truncated_updates;
+   statistics->TruncatedCollisions = scene->statistics->truncated_collisions;
+
+   // Start a new window if asked to
+   if (reset)
+      resetStatistics(scene);
+
+   // Now that the operations are complete, unlock the scene and registry
+   if (scene->scene_initialized)
+   {
+      if (reset)
+         unlockSceneWrite(scene);
+      else
+         unlockSceneRead(scene);
+   }
+   scene->actor_registry->unlockRead();
+}
+
+
+PHYSX_API int runSceneQueriesInScene(unsigned int sceneID,
+   RaycastQuery * raycasts, int raycastCount, QueryHit * raycastHits,
+   SweepQuery * sweeps, int sweepCount, QueryHit * sweepHits,
+   OverlapQuery * overlaps, int overlapCount, QueryHit * overlapHits)
+{
+   SceneReference    scene;
+   PhysXSceneQuery   query;
+   int               hitCount;
+
+   // Capture the call if a session is being recorded
+   if (recorder.isRecording())
+      recorder.record(CALL_RUN_SCENE_QUERIES, "uDDD", sceneID, raycasts,
+         raycastCount * (int) sizeof(RaycastQuery), sweeps,
+         sweepCount * (int) sizeof(SweepQuery), overlaps,
+         overlapCount * (int) sizeof(OverlapQuery));
+
+   // Find the scene that the call operates on
+   scene = getScene(sceneID);
+   if (scene == NULL)
+      return -1;
+
+   // A batch that is missing its results can't be run
+   if ((raycastCount > 0 && (raycasts == NULL || raycastHits == NULL)) ||
+       (sweepCount > 0 && (sweeps == NULL || sweepHits == NULL)) ||
+       (overlapCount > 0 && (overlaps == NULL || overlapHits == NULL)))
+   {
+      logger->notify(AT_WARN, "Unable to run scene queries without "
+         "query and result arrays.\n");
+      return -1;
+   }
+
+   // There is nothing to query until the scene has been created
+   if (!scene->scene_initialized)
+      return -1;
+
+   // Run all of the queries under a single read lock, so that the whole
+   // batch sees one state of the scene; queries only read the scene, so
+   // they can run alongside each other and alongside a step in flight (in
+   // which case they see the scene as it was before the step)
+   query.setScene(scene->px_scene);
+   lockSceneRead(scene);
+   hitCount = 0;
+   if (raycastCount > 0)
+      hitCount += query.raycast(raycasts, raycastCount, raycastHits);
+   if (sweepCount > 0)
+      hitCount += query.sweep(sweeps, sweepCount, sweepHits);
+   if (overlapCount > 0)
+      hitCount += query.overlap(overlaps, overlapCount, overlapHits);
+   unlockSceneRead(scene);
+
+   // Return the number of queries that hit something
+   return hitCount;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// The single-scene API, which predates scene handles; every call operates on
+// the default scene, which is the first scene that was created
+
+
+PHYSX_API void releaseScene()
+{
+   unsigned int   sceneID;
+
+   // Read the handle of the default scene without reserving one
+   pthread_rwlock_rdlock(&scenes_lock);
+   sceneID = default_scene_id;
+   pthread_rwlock_unlock(&scenes_lock);
+
+   destroyScene(sceneID);
+}
+
+
+PHYSX_API void initEntityUpdate(EntityProperties * updateArray, int maxUpdates)
+{
+   initEntityUpdateInScene(getDefaultScene(), updateArray, maxUpdates);
+}
+
+
+PHYSX_API void initEntityUpdateBuffers(EntityProperties * firstArray,
+   EntityProperties * secondArray, int maxUpdates)
+{
+   initEntityUpdateBuffersInScene(getDefaultScene(), firstArray, secondArray,
+      maxUpdates);
+}
+
+
+PHYSX_API void initCollisionUpdate(CollisionProperties * collisionArray,
+   int maxCollisions)
+{
+   initCollisionUpdateInScene(getDefaultScene(), collisionArray, maxCollisions);
+}
+
+
+PHYSX_API void initCollisionUpdateBuffers(CollisionProperties * firstArray,
+   CollisionProperties * secondArray, int maxCollisions)
+{
+   initCollisionUpdateBuffersInScene(getDefaultScene(), firstArray, secondArray,
+      maxCollisions);
+}
+
+
+PHYSX_API void initCollisionArraysUpdate(CollisionArrays * firstArrays,
+   CollisionArrays * secondArrays, int maxCollisions)
+{
+   initCollisionArraysUpdateInScene(getDefaultScene(), firstArrays,
+      secondArrays, maxCollisions);
+}
+
+
+PHYSX_API void setCollisionReportMode(int mode)
+{
+   setCollisionReportModeInScene(getDefaultScene(), mode);
+}
+
+
+PHYSX_API unsigned int getDroppedCollisionCount()
+{
+   return getDroppedCollisionCountInScene(getDefaultScene());
+}
+
+
+PHYSX_API void createActor(unsigned int id, char * name, float x, float y,
+   float z, bool isDynamic, bool reportCollisions)
+{
+   createActorInScene(getDefaultScene(), id, name, x, y, z, isDynamic,
+      reportCollisions);
+}
+
+
+PHYSX_API void attachSphere(unsigned int id, unsigned int shapeId,
+   float staticFriction, float dynamicFriction, float restitution, float radius,
+   float x, float y, float z, float density)
+{
+   attachSphereInScene(getDefaultScene(), id, shapeId, staticFriction,
+      dynamicFriction, restitution, radius, x, y, z, density);
+}
+
+
+PHYSX_API void attachBox(unsigned int id, unsigned int shapeId,
+   float staticFriction, float dynamicFriction, float restitution, float halfX,
+   float halfY, float halfZ, float x, float y, float z, float rotX, float rotY,
+   float rotZ, float rotW, float density)
+{
+   attachBoxInScene(getDefaultScene(), id, shapeId, staticFriction,
+      dynamicFriction, restitution, halfX, halfY, halfZ, x, y, z, rotX, rotY,
+      rotZ, rotW, density);
+}
+
+
+PHYSX_API void attachCapsule(unsigned int id, unsigned shapeId,
+   float staticFriction, float dynamicFriction, float restitution,
+   float halfHeight, float radius, float x, float y, float z, float rotX,
+   float rotY, float rotZ, float rotW, float density)
+{
+   attachCapsuleInScene(getDefaultScene(), id, shapeId, staticFriction,
+      dynamicFriction, restitution, halfHeight, radius, x, y, z, rotX, rotY,
+      rotZ, rotW, density);
+}
+
+
+PHYSX_API void attachTriangleMesh(unsigned int id, unsigned int shapeId,
+   float staticFriction, float dynamicFriction, float restitution,
+   float * vertices, int * indices, int vertexCount, int indexCount, float x,
+   float y, float z, float rotX, float rotY, float rotZ, float rotW)
+{
+   attachTriangleMeshInScene(getDefaultScene(), id, shapeId, staticFriction,
+      dynamicFriction, restitution, vertices, indices, vertexCount, indexCount,
+      x, y, z, rotX, rotY, rotZ, rotW);
+}
+
+
+PHYSX_API void attachConvexMesh(unsigned int id, unsigned int shapeId,
+   float staticFriction, float dynamicFriction, float restitution,
+   float * vertices, int vertexCount, float x, float y, float z, float rotX,
+   float rotY, float rotZ, float rotW, float density)
+{
+   attachConvexMeshInScene(getDefaultScene(), id, shapeId, staticFriction,
+      dynamicFriction, restitution, vertices, vertexCount, x, y, z, rotX, rotY,
+      rotZ, rotW, density);
+}
+
+
+PHYSX_API void removeShape(unsigned int id, unsigned int shapeId)
+{
+   removeShapeInScene(getDefaultScene(), id, shapeId);
+}
+
+
+PHYSX_API void createActorSphere(unsigned int id, char * name, float x, float y,
+   float z, unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float radius, float density, bool isDynamic,
+   bool reportCollisions)
+{
+   createActorSphereInScene(getDefaultScene(), id, name, x, y, z, shapeId,
+      staticFriction, dynamicFriction, restitution, radius, density, isDynamic,
+      reportCollisions);
+}
+
+
+PHYSX_API void createActorBox(unsigned int id, char * name, float posX,
+   float posY, float posZ, unsigned int shapeId, float staticFriction,
+   float dynamicFriction, float restitution, float halfX, float halfY,
+   float halfZ, float density, bool isDynamic, bool reportCollisions)
+{
+   createActorBoxInScene(getDefaultScene(), id, name, posX, posY, posZ, shapeId,
+      staticFriction, dynamicFriction, restitution, halfX, halfY, halfZ,
+      density, isDynamic, reportCollisions);
+}
+
+
+PHYSX_API void createActorCapsule(unsigned int id, char * name, float x,
+   float y, float z, float rotX, float rotY, float rotZ, float rotW,
+   unsigned int shapeId, float staticFriction, float dynamicFriction,
+   float restitution, float halfHeight, float radius, float density,
+   bool isDynamic, bool reportCollisions)
+{
+   createActorCapsuleInScene(getDefaultScene(), id, name, x, y, z, rotX, rotY,
+      rotZ, rotW, shapeId, staticFriction, dynamicFriction, restitution,
+      halfHeight, radius, density, isDynamic, reportCollisions);
+}
+
+
+PHYSX_API void createActorTriangleMesh(unsigned int id, char * name, float x,
+   float y, float z, unsigned int shapeId, float staticFriction,
+   float dynamicFriction, float restitution, float* vertices, int* indices,
+   int vertexCount, int indexCount, bool isDynamic, bool reportCollisions)
+{
+   createActorTriangleMeshInScene(getDefaultScene(), id, name, x, y, z, shapeId,
+      staticFriction, dynamicFriction, restitution, vertices, indices,
+      vertexCount, indexCount, isDynamic, reportCollisions);
+}
+
+
+PHYSX_API void createActorConvexMesh(unsigned int id, char * name, float x,
+   float y, float z, unsigned int shapeId, float staticFriction,
+   float dynamicFriction, float restitution, float* vertices, int vertexCount,
+   float density, bool isDynamic, bool reportCollisions)
+{
+   createActorConvexMeshInScene(getDefaultScene(), id, name, x, y, z, shapeId,
+      staticFriction, dynamicFriction, restitution, vertices, vertexCount,
+      density, isDynamic, reportCollisions);
+}
+
+
+PHYSX_API void removeActor(unsigned int id)
+{
+   removeActorInScene(getDefaultScene(), id);
+}
+
+
+PHYSX_API void updateMaterialProperties(unsigned int id, unsigned int shapeId,
+   float staticFriction, float dynamicFriction, float restitution)
+{
+   updateMaterialPropertiesInScene(getDefaultScene(), id, shapeId,
+      staticFriction, dynamicFriction, restitution);
+}
+
+
+PHYSX_API float getActorMass(unsigned int id)
+{
+   return getActorMassInScene(getDefaultScene(), id);
+}
+
+
+PHYSX_API void clearAllForces(unsigned int id)
+{
+   clearAllForcesInScene(getDefaultScene(), id);
+}
+
+
+PHYSX_API bool addForce(unsigned int id, float forceX, float forceY,
+   float forceZ)
+{
+   return addForceInScene(getDefaultScene(), id, forceX, forceY, forceZ);
+}
+
+
+PHYSX_API bool addTorque(unsigned int id, float torqueX, float torqueY,
+   float torqueZ)
+{
+   return addTorqueInScene(getDefaultScene(), id, torqueX, torqueY, torqueZ);
+}
+
+
+PHYSX_API void setTransformation(unsigned int id, float posX, float posY,
+   float posZ, float rotX, float rotY, float rotZ, float rotW)
+{
+   setTransformationInScene(getDefaultScene(), id, posX, posY, posZ, rotX, rotY,
+      rotZ, rotW);
+}
+
+
+PHYSX_API void setPosition(unsigned int id, ActorPosition pos)
+{
+   setPositionInScene(getDefaultScene(), id, pos);
+}
+
+
+PHYSX_API ActorPosition getPosition(unsigned int id)
+{
+   return getPositionInScene(getDefaultScene(), id);
+}
+
+
+PHYSX_API void setRotation(unsigned int id, ActorOrientation orient)
+{
+   setRotationInScene(getDefaultScene(), id, orient);
+}
+
+
+PHYSX_API ActorOrientation getRotation(unsigned int id)
+{
+   return getRotationInScene(getDefaultScene(), id);
+}
+
+
+PHYSX_API void setLinearVelocity(unsigned int id, float x, float y, float z)
+{
+   setLinearVelocityInScene(getDefaultScene(), id, x, y, z);
+}
+
+
+PHYSX_API void setAngularVelocity(unsigned int id, float x, float y, float z)
+{
+   setAngularVelocityInScene(getDefaultScene(), id, x, y, z);
+}
+
+
+PHYSX_API void setGravity(unsigned int id, float x, float y, float z)
+{
+   setGravityInScene(getDefaultScene(), id, x, y, z);
+}
+
+
+PHYSX_API void enableGravity(unsigned int id, bool enabled)
+{
+   enableGravityInScene(getDefaultScene(), id, enabled);
+}
+
+
+PHYSX_API void setLinearDamping(unsigned int id, float damping)
+{
+   setLinearDampingInScene(getDefaultScene(), id, damping);
+}
+
+
+PHYSX_API void setAngularDamping(unsigned int id, float damping)
+{
+   setAngularDampingInScene(getDefaultScene(), id, damping);
+}
+
+
+PHYSX_API void updateShapeDensity(unsigned int id, unsigned int shapeID,
+   float density)
+{
+   updateShapeDensityInScene(getDefaultScene(), id, shapeID, density);
+}
+
+
+PHYSX_API bool updateActorMass(unsigned int id, float mass)
+{
+   return updateActorMassInScene(getDefaultScene(), id, mass);
+}
+
+
+PHYSX_API void createGroundPlane(float x, float y, float z)
+{
+   createGroundPlaneInScene(getDefaultScene(), x, y, z);
+}
+
+
+PHYSX_API void releaseGroundPlane()
+{
+   releaseGroundPlaneInScene(getDefaultScene());
+}
+
+
+PHYSX_API void setHeightFieldTileSize(int tileSize)
+{
+   setHeightFieldTileSizeInScene(getDefaultScene(), tileSize);
+}
+
+
+PHYSX_API void setHeightField(unsigned terrainActorID,
+   unsigned int terrainShapeID, int regionSizeX, int regionSizeY,
+   float rowSpacing, float columnSpacing, float * posts,
+   float heightScaleFactor)
+{
+   setHeightFieldInScene(getDefaultScene(), terrainActorID, terrainShapeID,
+      regionSizeX, regionSizeY, rowSpacing, columnSpacing, posts,
+      heightScaleFactor);
+}
+
+
+PHYSX_API bool updateHeightField(unsigned int terrainActorID, int startRow,
+   int startColumn, int rowCount, int columnCount, float * posts)
+{
+   return updateHeightFieldInScene(getDefaultScene(), terrainActorID, startRow,
+      startColumn, rowCount, columnCount, posts);
+}
+
+
+PHYSX_API void addJoint(unsigned int jointID, unsigned int actorID1,
+   unsigned int actorID2, float * actor1Pos, float * actor1Quat,
+   float * actor2Pos, float * actor2Quat, float * linearLowerLimit,
+   float * linearUpperLimit, float * angularLowerLimit,
+   float * angularUpperLimit)
+{
+   addJointInScene(getDefaultScene(), jointID, actorID1, actorID2, actor1Pos,
+      actor1Quat, actor2Pos, actor2Quat, linearLowerLimit, linearUpperLimit,
+      angularLowerLimit, angularUpperLimit);
+}
+
+
+PHYSX_API void addGlobalFrameJoint(unsigned int jointID, unsigned int actorID,
+   float * actorPos, float * actorQuat, float * linearLowerLimit,
+   float * linearUpperLimit, float * angularLowerLimit,
+   float * angularUpperLimit)
+{
+   addGlobalFrameJointInScene(getDefaultScene(), jointID, actorID, actorPos,
+      actorQuat, linearLowerLimit, linearUpperLimit, angularLowerLimit,
+      angularUpperLimit);
+}
+
+
+PHYSX_API void removeJoint(unsigned int id)
+{
+   removeJointInScene(getDefaultScene(), id);
+}
+
+
+PHYSX_API int applyCommands(void * commandBuffer, int bufferSize,
+   unsigned int * commandResults)
+{
+   return applyCommandsInScene(getDefaultScene(), commandBuffer, bufferSize,
+      commandResults);
+}
+
+
+PHYSX_API bool queueCommands(void * commandBuffer, int bufferSize)
+{
+   return queueCommandsInScene(getDefaultScene(), commandBuffer, bufferSize);
+}
+
+
+PHYSX_API void initCommandFailureUpdate(CommandFailure * failureArray,
+   int maxFailures)
+{
+   initCommandFailureUpdateInScene(getDefaultScene(), failureArray,
+      maxFailures);
+}
+
+
+PHYSX_API void getCommandFailures(unsigned int * failureCount)
+{
+   getCommandFailuresInScene(getDefaultScene(), failureCount);
+}
+
+
+PHYSX_API bool beginSimulate(float time)
+{
+   return beginSimulateInScene(getDefaultScene(), time);
+}
+
+
+PHYSX_API bool pollSimulate()
+{
+   return pollSimulateInScene(getDefaultScene());
+}
+
+
+PHYSX_API int endSimulate(unsigned int * updatedEntityCount,
+   unsigned int * updatedCollisionCount, unsigned int * droppedCollisionCount)
+{
+   return endSimulateInScene(getDefaultScene(), updatedEntityCount,
+      updatedCollisionCount, droppedCollisionCount);
+}
+
+
+PHYSX_API void simulate(float time, unsigned int * updatedEntityCount,
+   unsigned int * updatedCollisionCount)
+{
+   simulateInScene(getDefaultScene(), time, updatedEntityCount,
+      updatedCollisionCount);
+}
+
+
+PHYSX_API void getStepTimings(StepTimings * timings)
+{
+   getStepTimingsInScene(getDefaultScene(), timings);
+}
+
+
+PHYSX_API void getStatistics(PhysicsStatistics * statistics, bool reset)
+{
+   getStatisticsInScene(getDefaultScene(), statistics, reset);
+}
+
+
+PHYSX_API int runSceneQueries(RaycastQuery * raycasts, int raycastCount,
+   QueryHit * raycastHits, SweepQuery * sweeps, int sweepCount,
+   QueryHit * sweepHits, OverlapQuery * overlaps, int overlapCount,
+   QueryHit * overlapHits)
+{
+   return runSceneQueriesInScene(getDefaultScene(), raycasts, raycastCount,
+      raycastHits, sweeps, sweepCount, sweepHits, overlaps, overlapCount,
+      overlapHits);
 }
 
@@ -31,8 +31,17 @@
 #include "PxPhysicsAPI.h"
 
 #include "PhysXCollisionCallback.h++"
+#include "PhysXCommandQueue.h++"
 #include "PhysXJoint.h++"
+#include "PhysXMeshCache.h++"
 #include "PhysXRigidActor.h++"
+#include "PhysXSceneQuery.h++"
+#include "PhysXStatistics.h++"
+
+
+/// The state of a single scene, which is private to PhysXLib.c++.
+///
+struct PhysXScene;
 
 
 struct EntityProperties
@@ -54,9 +63,59 @@ struct EntityProperties
 };
 
 
+/// Struct for reporting how long, in milliseconds, each phase of the last
+/// simulation step took. SimulateTime covers starting the step, FetchTime
+/// waiting for it to finish, UpdateTime filling the update array and
+/// CollisionTime writing out the collisions.
+///
+struct StepTimings
+{
+   float   SimulateTime;
+   float   FetchTime;
+   float   UpdateTime;
+   float   CollisionTime;
+};
+
+
+/// Struct for reporting the statistics of a scene, gathered since the scene
+/// was created or since they were last reset.
+///
+/// The step histograms cover the same phases as StepTimings. The lock
+/// histograms cover the time spent waiting for the actor registry and the
+/// PhysX scene, and the time that either was held for writing. CookTime
+/// covers cooking meshes that weren't found in the mesh cache and building
+/// or patching height fields for the scene. Meshes are cached across all of
+/// the scenes, so only the scene that cooked a mesh first is charged for it.
+///
+/// ActorCount is the number of actors in the scene, while ActiveActors and
+/// ContactPairs are the number of actors that moved and of pairs of shapes
+/// in contact during the last step. TruncatedUpdates and TruncatedCollisions
+/// are the totals of actor updates and contact points that didn't fit into
+/// the update and collision arrays.
+///
+struct PhysicsStatistics
+{
+   TimeHistogram   SimulateTime;
+   TimeHistogram   FetchTime;
+   TimeHistogram   UpdateTime;
+   TimeHistogram   CollisionTime;
+   TimeHistogram   RegistryWaitTime;
+   TimeHistogram   RegistryHoldTime;
+   TimeHistogram   SceneWaitTime;
+   TimeHistogram   SceneHoldTime;
+   TimeHistogram   CookTime;
+   unsigned int    ActorCount;
+   unsigned int    ActiveActors;
+   unsigned int    ContactPairs;
+   unsigned int    TruncatedUpdates;
+   unsigned int    TruncatedCollisions;
+};
+
+
 /// Method to create an actor either dynamic or static with given id, name, and
 /// position.
 ///
+/// @param scene The scene whose registry keeps track of the actor.
 /// @param id Id of the physical actor being created.
 /// @param name Name of the physical actor being created.
 /// @param x The x value of the position of the physical actor in the scene.
@@ -69,12 +128,14 @@ struct EntityProperties
 ///
 /// @return The PhysXRigidActor that represents the physical object.
 ///
-extern PhysXRigidActor *   createRigidActor(unsigned int id, char * name, 
-   float x, float y, float z, bool isDynamic, bool reportCollisions);
+extern PhysXRigidActor *   createRigidActor(PhysXScene * scene,
+   unsigned int id, const char * name, float x, float y, float z,
+   bool isDynamic, bool reportCollisions);
 
 /// Method to create an actor either dynamic or static with given id, name, and
 /// position.
 ///
+/// @param scene The scene whose registry keeps track of the actor.
 /// @param id Id of the physical actor being created.
 /// @param name Name of the physical actor being created.
 /// @param x The x value of the position of the physical actor in the scene.
@@ -89,27 +150,31 @@ extern PhysXRigidActor *   createRigidActor(unsigned int id, char * name,
 ///
 /// @return The PhysXRigidActor that represents the physical object.
 ///
-extern PhysXRigidActor *   createRigidActor(unsigned int id, char * name,
-   float x, float y, float z, PxQuat Rot, bool isDynamic,
-   bool reportCollisions);
+extern PhysXRigidActor *   createRigidActor(PhysXScene * scene,
+   unsigned int id, const char * name, float x, float y, float z, PxQuat Rot,
+   bool isDynamic, bool reportCollisions);
 
-/// Method to fetch the actor from the map of actors.
+/// Method to fetch the actor from the registry of actors. The caller must hold
+/// the registry lock.
 ///
+/// @param scene The scene whose registry holds the actor.
 /// @param id The id of the actor that is being fetched.
 ///
 /// @return The actor with the given id or null if the actor was not inside of
-/// the map of actors.
+/// the registry of actors.
 ///
-extern PhysXRigidActor *   getActor(unsigned int id);
+extern PhysXRigidActor *   getActor(PhysXScene * scene, unsigned int id);
 
-/// Method to fetch the actor from the map of actors.
+/// Method to fetch the actor from the registry of actors. The caller must hold
+/// the registry lock.
 ///
+/// @param scene The scene whose registry holds the actor.
 /// @param id The id of the actor that is being fetched.
 ///
 /// @return The actor with the given id or null if the actor was not inside of
-/// the map of actors.
+/// the registry of actors.
 ///
-extern PhysXRigidActor *   getActor(atInt * id);
+extern PhysXRigidActor *   getActor(PhysXScene * scene, atInt * id);
 
 /// Custom filter shader used for collision filtering and to customize the
 /// collection of flags describing the actions to take on a collision pair.
@@ -126,44 +191,149 @@ extern PxFilterFlags   contactFilterShader(PxFilterObjectAttributes attributes0,
 ///
 extern void   startVisualDebugger();
 
+/// Method to fetch the handle of the default scene, which the single-scene
+/// API operates on. The scene is reserved if it doesn't exist yet.
+///
+/// @return The handle of the default scene, or 0 if there are too many
+/// scenes already.
+///
+extern unsigned int   getDefaultScene();
+
 
 extern "C"
 {
-   /// Initializes the foundation, physics, cooking, collisions, and visual
+   /// Initializes the foundation, physics, cooking, mesh cache, and visual
    /// debugger.
    ///
    /// @return 1 if successfully initialized and 0 otherwise.
    ///
    int   initialize();
 
-   /// Cleans up the PhysXWrapper by releasing the visual debugger, physics,
-   /// and foundation in that order.
+   /// Cleans up the PhysXWrapper by releasing any remaining scenes, the
+   /// visual debugger, physics, and foundation in that order.
    ///
    void   release();
 
+   /// Creates a CPU dispatcher that is shared by all of the scenes created
+   /// from now on, so that scenes stepped concurrently share one pool of
+   /// worker threads instead of each having their own.
+   ///
+   /// @param cpuMaxThreads Number of worker threads of the dispatcher.
+   ///
+   /// @return True if the dispatcher was created.
+   ///
+   bool   createSharedDispatcher(int cpuMaxThreads);
+
+   /// Starts recording every call made into the library to a binary call
+   /// log, which the replay tool can re-drive later on. Recording should be
+   /// started before the first scene is created, so that the log holds the
+   /// complete state of the session.
+   ///
+   /// @param path The file that the log is written to.
+   ///
+   /// @return True if the log could be created.
+   ///
+   bool   startRecording(char * path);
+
+   /// Finishes recording calls and writes out the rest of the call log.
+   ///
+   void   stopRecording();
+
    /// Initialize the update array for updating the physical object properties
    /// after every simulate call.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param updateArray The array that has been pinned to memory and will be
    /// transfering the updates from the unmanaged code to managed code.
    /// @param maxUpdates The size of the updateArray which in turn determines
    /// how many updates can be sent after each simulate call.
    ///
-   void   initEntityUpdate(EntityProperties * updateArray, int maxUpdates);
+   void   initEntityUpdateInScene(unsigned int sceneID,
+      EntityProperties * updateArray, int maxUpdates);
+
+   /// Initialize a pair of update arrays that alternate between simulation
+   /// steps, so that the results of one step can be read while the next one
+   /// is being simulated.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param firstArray The array that has been pinned to memory and receives
+   /// the updates of every other step, starting with the first.
+   /// @param secondArray The array that has been pinned to memory and receives
+   /// the updates of the remaining steps.
+   /// @param maxUpdates The size of each of the arrays.
+   ///
+   void   initEntityUpdateBuffersInScene(unsigned int sceneID,
+      EntityProperties * firstArray, EntityProperties * secondArray,
+      int maxUpdates);
 
    /// Initialize the collision array for updating the physical object
    /// collisions after every simulate call.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param collisionArray The array that has been pinned to memory and will
    /// be transferring the collisions from the unmanaged code to managed code.
    /// @param maxUpdates The size of the collisionArray which in turn determines
    /// how many collisions can be sent after each simulate call.
    ///
-   void   initCollisionUpdate(CollisionProperties * collisionArray,
-      int maxUpdates);
+   void   initCollisionUpdateInScene(unsigned int sceneID,
+      CollisionProperties * collisionArray, int maxUpdates);
+
+   /// Initialize a pair of collision arrays that alternate between simulation
+   /// steps, along with the entity update arrays. The arrays can't be changed
+   /// while a simulation step is in flight.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param firstArray The array that has been pinned to memory and receives
+   /// the collisions of every other step, starting with the first.
+   /// @param secondArray The array that has been pinned to memory and receives
+   /// the collisions of the remaining steps.
+   /// @param maxCollisions The size of each of the arrays.
+   ///
+   void   initCollisionUpdateBuffersInScene(unsigned int sceneID,
+      CollisionProperties * firstArray, CollisionProperties * secondArray,
+      int maxCollisions);
 
-   /// Create the scene for the physical objects and determine what hardware is
-   /// running PhysX.
+   /// Initialize a pair of structure of arrays layouts that collisions are
+   /// written to instead of arrays of collision properties; the arrays
+   /// alternate between simulation steps like the other update buffers, and
+   /// can't be changed while a simulation step is in flight.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param firstArrays The arrays, pinned to memory, that receive the
+   /// collisions of every other step, starting with the first.
+   /// @param secondArrays The arrays, pinned to memory, that receive the
+   /// collisions of the remaining steps; may describe the same arrays as
+   /// firstArrays.
+   /// @param maxCollisions The size of each of the arrays.
+   ///
+   void   initCollisionArraysUpdateInScene(unsigned int sceneID,
+      CollisionArrays * firstArrays, CollisionArrays * secondArrays,
+      int maxCollisions);
+
+   /// Sets whether every contact point is reported, or one record for each
+   /// pair of actors in contact holding the deepest point, the average
+   /// normal and the total impulse. The mode can't be changed while a
+   /// simulation step is in flight.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param mode The CollisionReportMode to use; unknown modes are ignored.
+   ///
+   void   setCollisionReportModeInScene(unsigned int sceneID, int mode);
+
+   /// Returns the number of contact points from the last simulation step
+   /// that could not be reported because the collision array was full.
+   ///
+   /// @param sceneID The handle of the scene.
+   ///
+   /// @return The number of dropped contact points.
+   ///
+   unsigned int   getDroppedCollisionCountInScene(unsigned int sceneID);
+
+   /// Create a scene for the physical objects and determine what hardware is
+   /// running PhysX. Every scene has its own actors, joints, terrain and
+   /// update arrays, and separate scenes may be stepped concurrently. The
+   /// first scene created becomes the default scene, which is the one that
+   /// the calls without a scene handle operate on.
    ///
    /// @param gpuEnabled Flag that tells the method to set up the GPU for
    /// PhysX.
@@ -172,18 +342,25 @@ extern "C"
    /// @param cpuMaxThreads Number of threads that the CPU should use for
    /// PhysX.
    ///
-   /// @return 1 if the scene is set up correctly and 0 if the scene was
-   /// unable to be created.
+   /// @return The handle of the scene, which is never 0, or 0 if the scene
+   /// was unable to be created.
    ///
-   int   createScene(bool gpuEnabled, bool cpuEnabled, int cpuMaxThreads);
+   unsigned int   createScene(bool gpuEnabled, bool cpuEnabled,
+      int cpuMaxThreads);
 
-   /// Call the scene release to clean up the scene.
+   /// Release a scene along with all of the actors and joints in it. The
+   /// handle stops being valid right away; calls that other threads are
+   /// making on the scene at the same time finish first, and the last of
+   /// them releases the scene.
    ///
-   void   releaseScene();
+   /// @param sceneID The handle of the scene.
+   ///
+   void   destroyScene(unsigned int sceneID);
 
    /// Method to create an actor either dynamic or static with given id, name,
    /// and position.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id Id of the physical actor being created.
    /// @param name Name of the physical actor being created.
    /// @param x The x value of the position of the physical actor in the scene.
@@ -194,11 +371,12 @@ extern "C"
    /// @param reportCollisions Indicates whether collisions involving this actor
    /// should be reported.
    ///
-   void   createActor(unsigned int id, char * name, float x, float y, float z,
-      bool isDynamic, bool reportCollisions);
+   void   createActorInScene(unsigned int sceneID, unsigned int id, char * name,
+      float x, float y, float z, bool isDynamic, bool reportCollisions);
 
    /// Method to attach a sphere shape to an existing actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id Unique identifier of the actor to which the shape is being 
    /// attached.
    /// @param shapeId Unique identifier of the shape being attached.
@@ -217,13 +395,14 @@ extern "C"
    /// position of the actor to which the sphere is being attached.
    /// @param density The density of the sphere.
    ///
-   void   attachSphere(unsigned int id, unsigned int shapeId,
-                       float staticFriction, float dynamicFriction,
-                       float restitution, float radius, float x, float y,
-                       float z, float density);
+   void   attachSphereInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeId, float staticFriction, float dynamicFriction,
+      float restitution, float radius, float x, float y, float z,
+      float density);
 
    /// Method to attach a box shape to an existing actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id Unique identifier of the actor to which the shape is being
    /// attached.
    /// @param shapeId Unique identifier of the shape being attached.
@@ -252,14 +431,15 @@ extern "C"
    /// box relative to the actor.
    /// @param density The density of the box.
    ///
-   void   attachBox(unsigned int id, unsigned int shapeId, float staticFriction,
-                    float dynamicFriction, float restitution, float halfX,
-                    float halfY, float halfZ, float x, float y, float z,
-                    float rotX, float rotY, float rotZ, float rotW,
-                    float density);
+   void   attachBoxInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeId, float staticFriction, float dynamicFriction,
+      float restitution, float halfX, float halfY, float halfZ, float x,
+      float y, float z, float rotX, float rotY, float rotZ, float rotW,
+      float density);
 
    /// Method to attach a capsule shape to an existing actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id Unique identifier of the actor to which the shape is being
    /// attached.
    /// @param shapeId Unique identifier of the shape being attached.
@@ -287,14 +467,14 @@ extern "C"
    /// of the capsule relative to the actor.
    /// @param density The density of the capsule.
    ///
-   void   attachCapsule(unsigned int id, unsigned int shapeId,
-                        float staticFriction, float dynamicFriction,
-                        float restitution, float halfHeight, float radius,
-                        float x, float y, float z, float rotX, float rotY,
-                        float rotZ, float rotW, float density);
+   void   attachCapsuleInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeId, float staticFriction, float dynamicFriction,
+      float restitution, float halfHeight, float radius, float x, float y,
+      float z, float rotX, float rotY, float rotZ, float rotW, float density);
 
    /// Method to attach a triangle mesh shape to an existing actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id Unique identifier of the actor to which the shape is being
    /// attached.
    /// @param shapeId Unique identifier of the shape being attached.
@@ -327,15 +507,15 @@ extern "C"
    /// actors, so this method will fail if the given ID belongs to a static
    /// actor.
    ///
-   void   attachTriangleMesh(unsigned int id, unsigned int shapeId,
-                             float staticFriction, float dynamicFriction,
-                             float restitution, float * vertices,
-                             int * indices, int vertexCount, int indexCount,
-                             float x, float y, float z, float rotX,
-                             float rotY, float rotZ, float rotW);
+   void   attachTriangleMeshInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeId, float staticFriction, float dynamicFriction,
+      float restitution, float * vertices, int * indices, int vertexCount,
+      int indexCount, float x, float y, float z, float rotX, float rotY,
+      float rotZ, float rotW);
 
    /// Method to attach a convex mesh to an existing actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id Unique identifier of the actor to which the shape is being
    /// attached.
    /// @param shapeId Unique identifier of the shape being attached.
@@ -363,23 +543,47 @@ extern "C"
    /// of the mesh relative to the actor.
    /// @param density The density of the convex mesh.
    ///
-   void   attachConvexMesh(unsigned int id, unsigned int shapeId,
-                           float staticFriction, float dynamicFriction,
-                           float restitution, float * vertices, int vertexCount,
-                           float x, float y, float z, float rotX, float rotY,
-                           float rotZ, float rotW, float density);
+   void   attachConvexMeshInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeId, float staticFriction, float dynamicFriction,
+      float restitution, float * vertices, int vertexCount, float x, float y,
+      float z, float rotX, float rotY, float rotZ, float rotW, float density);
 
-   /// Method to remove and delete a shape attached to an actor.
+   /// Sets the directory that cooked meshes are persisted to, so that meshes
+   /// cooked by an earlier run are loaded instead of being cooked again.
+   ///
+   /// @param path The directory, which must already exist; NULL or an empty
+   /// string keeps cooked meshes in memory only.
    ///
+   void   setMeshCacheDirectory(char * path);
+
+   /// Fetches the statistics of the cache of cooked meshes.
+   ///
+   /// @param stats The structure that receives the number of hits, misses
+   /// and meshes loaded from disk, along with the bytes cached and saved.
+   ///
+   void   getMeshCacheStatistics(MeshCacheStatistics * stats);
+
+   /// Releases the cached meshes that are no longer used by any shape.
+   ///
+   /// @return The number of meshes that were released.
+   ///
+   unsigned int   purgeMeshCache();
+
+   /// Method to remove and delete a shape attached to an actor. The tiles of
+   /// the terrain are refused; they are removed along with the terrain actor.
+   ///
+   /// @param sceneID The handle of the scene.
    /// @param id The unique identifier of the actor from which the shape
    /// should be deleted.
    /// @param shapeId The unique identifier of the shape to be removed &
    /// deleted.
    ///
-   void   removeShape(unsigned int id, unsigned int shapeId);
+   void   removeShapeInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeId);
 
    /// Method to create a sphere actor in the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor.
    /// @param name The string name associated with this actor.
    /// @param x The x value of the position of this actor in the physical
@@ -403,14 +607,14 @@ extern "C"
    /// @param reportCollisions Indicates whether collisions involving this
    /// actor should be reported.
    ///
-   void   createActorSphere(unsigned int id, char * name, float x, float y, 
-                            float z, unsigned int shapeId, float staticFriction,
-                            float dynamicFriction, float restitution,
-                            float radius, float density, bool isDynamic,
-                            bool reportCollisions);
+   void   createActorSphereInScene(unsigned int sceneID, unsigned int id,
+      char * name, float x, float y, float z, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution,
+      float radius, float density, bool isDynamic, bool reportCollisions);
 
    /// Method to create a box actor in the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor.
    /// @param name The string name associated with this actor.
    /// @param x The x value of the position of this actor in the physical
@@ -436,14 +640,15 @@ extern "C"
    /// @param reportCollisions Indicates whether collisions involving this
    /// actor should be reported.
    ///
-   void   createActorBox(unsigned int id, char * name, float x, float y, 
-                         float z, unsigned int shapeId, float staticFriction,
-                         float dynamicFriction, float restitution, float halfX,
-                         float halfY, float halfZ, float density,
-                         bool isDynamic, bool reportCollisions);
+   void   createActorBoxInScene(unsigned int sceneID, unsigned int id,
+      char * name, float x, float y, float z, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution,
+      float halfX, float halfY, float halfZ, float density, bool isDynamic,
+      bool reportCollisions);
 
    /// Method to create a capsule actor in the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor.
    /// @param name The string name associated with this actor.
    /// @param x The x value of the position of this actor in the physical
@@ -476,17 +681,15 @@ extern "C"
    /// @param reportCollisions Indicates whether collisions involving this
    /// actor should be reported.
    ///
-   void   createActorCapsule(unsigned int id, char * name,
-                             float x, float y, float z,
-                             float rotX, float rotY, float rotZ, float rotW,
-                             unsigned int shapeId,
-                             float staticFriction, float dynamicFriction,
-                             float restitution, float halfHeight, float radius,
-                             float density, bool isDynamic,
-                             bool reportCollisions);
+   void   createActorCapsuleInScene(unsigned int sceneID, unsigned int id,
+      char * name, float x, float y, float z, float rotX, float rotY,
+      float rotZ, float rotW, unsigned int shapeId, float staticFriction,
+      float dynamicFriction, float restitution, float halfHeight, float radius,
+      float density, bool isDynamic, bool reportCollisions);
 
    /// Method to create a triangle mesh actor in the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor.
    /// @param name The string name associated with this actor.
    /// @param x The x value of the position of this actor in the physical
@@ -513,16 +716,15 @@ extern "C"
    /// @param reportCollisions Indicates whether collisions involving this
    /// actor should be reported.
    ///
-   void   createActorTriangleMesh(unsigned int id, char * name, float x,
-                                  float y, float z, unsigned int shapeId,
-                                  float staticFriction, float dynamicFriction,
-                                  float restitution, float * vertices,
-                                  int * indices, int vertexCount,
-                                  int indexCount, bool isDynamic,
-                                  bool reportCollisions);
+   void   createActorTriangleMeshInScene(unsigned int sceneID, unsigned int id,
+      char * name, float x, float y, float z, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution,
+      float * vertices, int * indices, int vertexCount, int indexCount,
+      bool isDynamic, bool reportCollisions);
 
    /// Method to create a convex mesh actor in the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor.
    /// @param name The string name associated with this actor.
    /// @param x The x value of the position of this actor in the physical
@@ -548,21 +750,22 @@ extern "C"
    /// @param reportCollisions Indicates whether collisions involving this actor
    /// should be reported.
    ///
-   void   createActorConvexMesh(unsigned int id, char * name, float x, float y, 
-                                float z, unsigned int shapeId,
-                                float staticFriction, float dynamicFriction,
-                                float restitution, float * vertices,
-                                int vertexCount, float density, bool isDynamic,
-                                bool reportCollisions);
+   void   createActorConvexMeshInScene(unsigned int sceneID, unsigned int id,
+      char * name, float x, float y, float z, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution,
+      float * vertices, int vertexCount, float density, bool isDynamic,
+      bool reportCollisions);
 
    /// Remove an actor from the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be removed.
    ///
-   void   removeActor(unsigned int id);
+   void   removeActorInScene(unsigned int sceneID, unsigned int id);
 
    /// Updates various physical properties of a shape.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The unique identifier of the actor to which the shape is
    /// attached.
    /// @param shapeId The unique identifier of the shape whose material
@@ -573,21 +776,44 @@ extern "C"
    /// for the shape when sliding against other objects in the scene.
    /// @param restitution The bounciness of this shape.
    ///
-   void   updateMaterialProperties(unsigned int id, unsigned int shapeId,
-                                   float staticFriction, float dynamicFriction,
-                                   float restitution);
+   void   updateMaterialPropertiesInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeId, float staticFriction, float dynamicFriction,
+      float restitution);
 
    /// Get the mass of a physical actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor for which the mass
    /// should be returned.
    ///
    /// @return The mass of the object
    ///
-   float   getActorMass(unsigned int id);
+   float   getActorMassInScene(unsigned int sceneID, unsigned int id);
+
+   /// Clear all forces and torques acting on a physical actor.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param id The unique identifier of the actor.
+   ///
+   void   clearAllForcesInScene(unsigned int sceneID, unsigned int id);
+
+   /// Apply a force to a physical actor.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param id The unique identifier of the actor to which the force will
+   /// be applied.
+   /// @param forceX The x-component of the force being applied.
+   /// @param forceY The y-component of the force being applied.
+   /// @param forceZ The z-component of the force being applied.
+   ///
+   /// @return Whether the force was successfully applied.
+   ///
+   bool   addForceInScene(unsigned int sceneID, unsigned int id, float forceX,
+      float forceY, float forceZ);
 
    /// Apply torque to a physical actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The unique identifier of the actor to which the torque will
    /// be applied.
    /// @param torqueX The x-component of the torque being applied.
@@ -596,11 +822,12 @@ extern "C"
    ///
    /// @return Whether the torque was successfully applied.
    ///
-   bool   addTorque(unsigned int id, float torqueX, float torqueY,
-                    float torqueZ);
+   bool   addTorqueInScene(unsigned int sceneID, unsigned int id, float torqueX,
+      float torqueY, float torqueZ);
 
    /// Updates an actors position and orientation inside the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be updated.
    /// @param posX The x value of the new physical translation in the scene.
    /// @param posY The y value of the new physical translation in the scene.
@@ -614,128 +841,170 @@ extern "C"
    /// @param rotW The w value of the quaternion representing the new rotation
    /// of the actor in the scene.
    ///
-   void   setTranslation(unsigned int id, float posX, float posY, float posZ,
-      float rotX, float rotY, float rotZ, float rotW);
+   void   setTransformationInScene(unsigned int sceneID, unsigned int id,
+      float posX, float posY, float posZ, float rotX, float rotY, float rotZ,
+      float rotW);
 
    /// Updates an actors position inside the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be updated.
    /// @param pos The position of the new physical translation in the scene.
    ///
-   void   setPosition(unsigned int id, ActorPosition pos);
+   void   setPositionInScene(unsigned int sceneID, unsigned int id,
+      ActorPosition pos);
 
    /// Method to fetch the current position of an actor in the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be fetched.
    ///
    /// @return A struct of floats with the x, y, z values for the position of
    /// the actor in the physical scene.
    ///
-   ActorPosition   getPosition(unsigned int id);
+   ActorPosition   getPositionInScene(unsigned int sceneID, unsigned int id);
 
    /// Updates an actors rotation inside the physical scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be updated.
    /// @param orient The quaternion representing the new rotation of
    /// the actor in the physical scene.
    ///
-   void   setRotation(unsigned int id, ActorOrientation orient);
+   void   setRotationInScene(unsigned int sceneID, unsigned int id,
+      ActorOrientation orient);
 
    /// Method to fetch the current orientation of an actor in the physical
    /// scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be fetched.
    ///
    /// @return A struct of floats with the x, y, z, w values for the quaternion
    /// representing the orientation of the actor in the physical scene.
    ///
-   ActorOrientation   getRotation(unsigned int id);
+   ActorOrientation   getRotationInScene(unsigned int sceneID, unsigned int id);
 
    /// Updates an actor with a new linear velocity.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be updated.
    /// @param x The velocity of the actor in the x direction.
    /// @param y The velocity of the actor in the y direction.
    /// @param z The velocity of the actor in the z direction.
    ///
-   void   setLinearVelocity(unsigned int id, float x, float y, float z);
+   void   setLinearVelocityInScene(unsigned int sceneID, unsigned int id,
+      float x, float y, float z);
 
    /// Updates an actor with a new angular velocity.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be updated.
    /// @param x The velocity of the actor in the x direction.
    /// @param y The velocity of the actor in the y direction.
    /// @param z The velocity of the actor in the z direction.
    ///
-   void   setAngularVelocity(unsigned int id, float x, float y, float z);
+   void   setAngularVelocityInScene(unsigned int sceneID, unsigned int id,
+      float x, float y, float z);
 
    /// Updates the scene gravity on an actor to the new values.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be updated.
    /// @param x The amount of gravity applied to the actor in the x direction.
    /// @param y The amount of gravity applied to the actor in the y direction.
    /// @param z The amount of gravity applied to the actor in the z direction.
    ///
-   void   setGravity(unsigned int id, float x, float y, float z);
+   void   setGravityInScene(unsigned int sceneID, unsigned int id, float x,
+      float y, float z);
 
    /// Enable or disable gravity on an actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor that gravity is being changed.
    /// @param enabled Flag that determines if gravity is being enabled or
    /// disabled for this particular actor.
    ///
-   void   enableGravity(unsigned int id, bool enabled);
+   void   enableGravityInScene(unsigned int sceneID, unsigned int id,
+      bool enabled);
 
    /// Set the linear damping coefficient of an actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor that is being modified.
    /// @param damping The linear damping coefficient to be updated to.
    ///
-   void setLinearDamping(unsigned int id, float damping);
+   void   setLinearDampingInScene(unsigned int sceneID, unsigned int id,
+      float damping);
 
    /// Set the angular damping coefficient of an actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor that is being modified.
    /// @param damping The angular damping coefficient to be updated to.
    ///
-   void setAngularDamping(unsigned int id, float damping);
+   void   setAngularDampingInScene(unsigned int sceneID, unsigned int id,
+      float damping);
 
    /// Updates the density of given shape attached to a given actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The unique identifier of the actor to which the desired shape
    /// is attached.
    /// @param shapeID The unique identifier of the desired shape.
    /// @param density The new density of the shape.
    ///
-   void   updateShapeDensity(unsigned int id, unsigned int shapeID,
-                             float density);
+   void   updateShapeDensityInScene(unsigned int sceneID, unsigned int id,
+      unsigned int shapeID, float density);
 
    /// Update the mass of a physical actor.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The id of the actor to be updated.
    /// @param mass The updated density of the actor.
    ///
    /// @return If the mass was updated
    ///
-   bool   updateActorMass(unsigned int id, float mass);
+   bool   updateActorMassInScene(unsigned int sceneID, unsigned int id,
+      float mass);
 
    /// Method to create a ground plane to prevent actors from falling forever.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param x The x value of the position where the plane should be created.
    /// @param y The y value of the position where the plane should be created.
    /// @param z The z value of the position where the plane should be created.
    ///
-   void   createGroundPlane(float x, float y, float z);
+   void   createGroundPlaneInScene(unsigned int sceneID, float x, float y,
+      float z);
 
    /// Release the resources currently be used by the ground plane.
    ///
-   void   releaseGroundPlane();
+   /// @param sceneID The handle of the scene.
+   ///
+   void   releaseGroundPlaneInScene(unsigned int sceneID);
 
-   /// Add a new terrain height map actor to the scene. This will delete the
-   /// old terrain height map and replace it with the new one.
+   /// Sets the number of posts along the edge of each tile when the terrain
+   /// is split into several height fields. Takes effect the next time the
+   /// terrain is built.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param tileSize The number of posts along a tile edge; values smaller
+   /// than two keep the terrain in a single height field.
    ///
-   /// @param terrainShapeID Currently not used by the program, but it should
-   /// be the id associated with the terrain actor.
+   void   setHeightFieldTileSizeInScene(unsigned int sceneID, int tileSize);
+
+   /// Add a new terrain height map actor to the scene. This will delete the
+   /// old terrain height map and replace it with the new one, unless the new
+   /// terrain has the same size, spacing, scale and tiling; in that case the
+   /// new heights are patched into the existing height fields in place. A
+   /// patch made while a simulation step is in flight is queued, and applied
+   /// when the next step begins.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param terrainActorID The unique identifier of the terrain actor.
+   /// @param terrainShapeID The identifier of the terrain shape; when the
+   /// terrain is tiled, the tiles use consecutive identifiers starting here.
    /// @param regionSizeX The total length of the region.
    /// @param regionSizeY The total width of the region.
    /// @param rowSpacing The distance between height point rows inside of the
@@ -746,13 +1015,32 @@ extern "C"
    /// the height field.
    /// @param heightScaleFactor Scale factor for the heights.
    ///
-   void   setHeightField(unsigned int terrainActorID,
-                         unsigned int terrainShapeID, int regionSizeX,
-                         int regionSizeY, float rowSpacing, float columnSpacing,
-                         float * posts, float heightScaleFactor);
+   void   setHeightFieldInScene(unsigned int sceneID,
+      unsigned int terrainActorID, unsigned int terrainShapeID, int regionSizeX,
+      int regionSizeY, float rowSpacing, float columnSpacing, float * posts,
+      float heightScaleFactor);
+
+   /// Replaces the heights of a rectangle of posts of the terrain in place,
+   /// without rebuilding the terrain. A patch made while a simulation step is
+   /// in flight is queued, and applied when the next step begins.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param terrainActorID The unique identifier of the terrain actor.
+   /// @param startRow The first row of posts to update.
+   /// @param startColumn The first column of posts to update.
+   /// @param rowCount The number of rows to update.
+   /// @param columnCount The number of columns to update.
+   /// @param posts The new height values of the rectangle, row by row.
+   ///
+   /// @return True if the terrain was updated or the patch was queued.
+   ///
+   bool   updateHeightFieldInScene(unsigned int sceneID,
+      unsigned int terrainActorID, int startRow, int startColumn, int rowCount,
+      int columnCount, float * posts);
 
    /// Add a joint between two actors.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param jointID The unique identifier of the joint being added.
    /// @param actorID1 The unique identifier of the first actor being joined.
    /// @param actorID2 The unique identifier of the second actor being joined.
@@ -765,16 +1053,17 @@ extern "C"
    /// @param angularLowerLimit Lower limits of each of the 3 rotational axes.
    /// @param angularUpperLimit Upper limits of each of the 3 rotational axes.
    ///
-   void   addJoint(unsigned int jointID, unsigned int actorID1,
-                   unsigned int actorID2, float * actor1Pos, float * actor1Quat,
-                   float * actor2Pos, float * actor2Quat,
-                   float * linearLowerLimit, float * linearUpperLimit,
-                   float * angularLowerLimit, float * angularUpperLimit);
+   void   addJointInScene(unsigned int sceneID, unsigned int jointID,
+      unsigned int actorID1, unsigned int actorID2, float * actor1Pos,
+      float * actor1Quat, float * actor2Pos, float * actor2Quat,
+      float * linearLowerLimit, float * linearUpperLimit,
+      float * angularLowerLimit, float * angularUpperLimit);
 
 
 
    /// Add a joint between an actor and the global frame.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param jointID The unique identifier of the joint being added.
    /// @param actorID The unique identifier of the joint.
    /// @param actorPos The position of joint relative to the actor.
@@ -784,33 +1073,471 @@ extern "C"
    /// @param angularLowerLimit Lower limits of each of the 3 rotational axes.
    /// @param angularUpperLimit Upper limits of each of the 3 rotational axes.
    ///
-   void   addGlobalFrameJoint(unsigned int jointID, unsigned int actorID,
-                              float * actorPos, float * actorQuat,
-                              float * linearLowerLimit,
-                              float * linearUpperLimit,
-                              float * angularLowerLimit,
-                              float * angularUpperLimit);
+   void   addGlobalFrameJointInScene(unsigned int sceneID, unsigned int jointID,
+      unsigned int actorID, float * actorPos, float * actorQuat,
+      float * linearLowerLimit, float * linearUpperLimit,
+      float * angularLowerLimit, float * angularUpperLimit);
 
 
    /// Remove joint from the physics scene.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param id The unique identifier of the PhysX joint
-   void   removeJoint(unsigned int id);
+   void   removeJointInScene(unsigned int sceneID, unsigned int id);
+
+   /// Applies a batch of actor commands immediately. The registry and the
+   /// scene are locked once for the whole batch rather than once per change.
+   /// If a simulation step is in flight, the batch is queued for the next
+   /// step instead and every command reports COMMAND_QUEUED.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param commandBuffer The command buffer, which starts with a
+   /// CommandBufferHeader followed by the ActorCommand records.
+   /// @param bufferSize The size of the command buffer in bytes.
+   /// @param commandResults Optional array, with one entry per command, that
+   /// receives the CommandStatus of each command; may be NULL.
+   ///
+   /// @return The number of commands that failed to apply, or -1 if the
+   /// buffer is invalid or of an unsupported version.
+   ///
+   int   applyCommandsInScene(unsigned int sceneID, void * commandBuffer,
+      int bufferSize, unsigned int * commandResults);
+
+   /// Queues a batch of actor commands to be applied at the start of the next
+   /// simulate call. Commands that fail are reported through the array given
+   /// to initCommandFailureUpdate.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param commandBuffer The command buffer, which starts with a
+   /// CommandBufferHeader followed by the ActorCommand records.
+   /// @param bufferSize The size of the command buffer in bytes.
+   ///
+   /// @return True if the buffer was valid and has been queued.
+   ///
+   bool   queueCommandsInScene(unsigned int sceneID, void * commandBuffer,
+      int bufferSize);
+
+   /// Initialize the array that reports queued commands that failed to apply.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param failureArray The array that has been pinned to memory and will
+   /// be transferring the failures from the unmanaged code to managed code.
+   /// @param maxFailures The size of the failureArray; failures beyond this
+   /// number are dropped.
+   ///
+   void   initCommandFailureUpdateInScene(unsigned int sceneID,
+      CommandFailure * failureArray, int maxFailures);
+
+   /// Fetches the number of queued commands that have failed since the last
+   /// call; the failures themselves are in the failure array.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param failureCount Passed by reference value that returns the number
+   /// of failures written to the failure array.
+   ///
+   void   getCommandFailuresInScene(unsigned int sceneID,
+      unsigned int * failureCount);
+
+   /// Starts advancing the PhysX world forward in time and returns without
+   /// waiting for the step to finish. Commands queued since the last step are
+   /// applied first.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param time The amount of time that the PhysX world should simulate.
+   ///
+   /// @return True if the step was started; false if the previous step has
+   /// not been ended yet.
+   ///
+   bool   beginSimulateInScene(unsigned int sceneID, float time);
+
+   /// Checks, without blocking, whether the step in flight has finished.
+   ///
+   /// @param sceneID The handle of the scene.
+   ///
+   /// @return True if endSimulate can be called without having to wait.
+   ///
+   bool   pollSimulateInScene(unsigned int sceneID);
+
+   /// Waits for the step in flight to finish and writes its results to the
+   /// current pair of update and collision arrays. The next step will write
+   /// to the other pair, so these results remain valid while it runs.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param updatedEntityCount Passed by reference value that returns the
+   /// number of entities that have updated values.
+   /// @param updatedCollisionCount Passed by reference value that returns the
+   /// number of collisions that have occurred.
+   /// @param droppedCollisionCount Passed by reference value that returns the
+   /// number of contact points that did not fit into the collision array;
+   /// may be NULL.
+   ///
+   /// @return The index (0 or 1) of the pair of arrays that holds the
+   /// results, or -1 if no step was in flight.
+   ///
+   int   endSimulateInScene(unsigned int sceneID,
+      unsigned int * updatedEntityCount, unsigned int * updatedCollisionCount,
+      unsigned int * droppedCollisionCount);
 
    /// This method runs the main simulation of PhysX and will be called at
-   /// every frame of the simulator.
+   /// every frame of the simulator. It is equivalent to beginSimulate
+   /// followed by endSimulate.
    ///
+   /// @param sceneID The handle of the scene.
    /// @param time The amount of time that the PhysX world should simulate.
    /// @param updatedEntityCount Passed by reference value that returns the
    /// number of entities that have updated values.
    /// @param updatedCollisionCount Passed by reference value that returns the
    /// number of collisions that have occurred.
    ///
+   void   simulateInScene(unsigned int sceneID, float time,
+      unsigned int * updatedEntityCount, unsigned int * updatedCollisionCount);
+
+   /// Reports how long each phase of the last simulation step took.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param timings The structure that receives the timings.
+   ///
+   void   getStepTimingsInScene(unsigned int sceneID, StepTimings * timings);
+
+   /// Reports the statistics gathered for a scene. Gathering them is cheap
+   /// enough that it is always on; resetting them starts a new window, so a
+   /// monitor that resets them on every call sees the statistics of the
+   /// interval between its calls.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param statistics The structure that receives the statistics.
+   /// @param reset Whether to start a new window once they have been read.
+   ///
+   void   getStatisticsInScene(unsigned int sceneID,
+      PhysicsStatistics * statistics, bool reset);
+
+   /// Runs batches of raycasts, sweeps and overlap tests against a scene,
+   /// all under a single read lock of the scene. Each query writes one
+   /// result to the matching element of its result array, reporting the
+   /// actor it hit by the same ID that EntityProperties uses. Queries only
+   /// consider the shapes in the groups of their group mask (see
+   /// QueryGroup), and pass through the actor that they ignore.
+   ///
+   /// Any of the batches may be empty, in which case its arrays can be NULL.
+   ///
+   /// @param sceneID The handle of the scene.
+   /// @param raycasts The rays to cast.
+   /// @param raycastCount The number of rays.
+   /// @param raycastHits The array that receives the results of the rays.
+   /// @param sweeps The volumes to sweep.
+   /// @param sweepCount The number of swept volumes.
+   /// @param sweepHits The array that receives the results of the sweeps.
+   /// @param overlaps The volumes to test for overlaps.
+   /// @param overlapCount The number of tested volumes.
+   /// @param overlapHits The array that receives the results of the
+   /// overlap tests.
+   ///
+   /// @return The number of queries that hit something, or -1 if the queries
+   /// couldn't be run.
+   ///
+   int   runSceneQueriesInScene(unsigned int sceneID,
+      RaycastQuery * raycasts, int raycastCount, QueryHit * raycastHits,
+      SweepQuery * sweeps, int sweepCount, QueryHit * sweepHits,
+      OverlapQuery * overlaps, int overlapCount, QueryHit * overlapHits);
+
+   /// The single-scene API, which predates scene handles. Each of the
+   /// following calls does the same as its InScene counterpart, operating on
+   /// the default scene; calls made before the first scene is created set up
+   /// the state of the default scene in advance.
+
+   /// Release the default scene along with all of the actors and joints in
+   /// it.
+   ///
+   void   releaseScene();
+
+   /// Single-scene form of initEntityUpdateInScene.
+   ///
+   void   initEntityUpdate(EntityProperties * updateArray, int maxUpdates);
+
+   /// Single-scene form of initEntityUpdateBuffersInScene.
+   ///
+   void   initEntityUpdateBuffers(EntityProperties * firstArray,
+      EntityProperties * secondArray, int maxUpdates);
+
+   /// Single-scene form of initCollisionUpdateInScene.
+   ///
+   void   initCollisionUpdate(CollisionProperties * collisionArray,
+      int maxCollisions);
+
+   /// Single-scene form of initCollisionUpdateBuffersInScene.
+   ///
+   void   initCollisionUpdateBuffers(CollisionProperties * firstArray,
+      CollisionProperties * secondArray, int maxCollisions);
+
+   /// Single-scene form of initCollisionArraysUpdateInScene.
+   ///
+   void   initCollisionArraysUpdate(CollisionArrays * firstArrays,
+      CollisionArrays * secondArrays, int maxCollisions);
+
+   /// Single-scene form of setCollisionReportModeInScene.
+   ///
+   void   setCollisionReportMode(int mode);
+
+   /// Single-scene form of getDroppedCollisionCountInScene.
+   ///
+   unsigned int   getDroppedCollisionCount();
+
+   /// Single-scene form of createActorInScene.
+   ///
+   void   createActor(unsigned int id, char * name, float x, float y, float z,
+      bool isDynamic, bool reportCollisions);
+
+   /// Single-scene form of attachSphereInScene.
+   ///
+   void   attachSphere(unsigned int id, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution,
+      float radius, float x, float y, float z, float density);
+
+   /// Single-scene form of attachBoxInScene.
+   ///
+   void   attachBox(unsigned int id, unsigned int shapeId, float staticFriction,
+      float dynamicFriction, float restitution, float halfX, float halfY,
+      float halfZ, float x, float y, float z, float rotX, float rotY,
+      float rotZ, float rotW, float density);
+
+   /// Single-scene form of attachCapsuleInScene.
+   ///
+   void   attachCapsule(unsigned int id, unsigned shapeId, float staticFriction,
+      float dynamicFriction, float restitution, float halfHeight, float radius,
+      float x, float y, float z, float rotX, float rotY, float rotZ, float rotW,
+      float density);
+
+   /// Single-scene form of attachTriangleMeshInScene.
+   ///
+   void   attachTriangleMesh(unsigned int id, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution,
+      float * vertices, int * indices, int vertexCount, int indexCount, float x,
+      float y, float z, float rotX, float rotY, float rotZ, float rotW);
+
+   /// Single-scene form of attachConvexMeshInScene.
+   ///
+   void   attachConvexMesh(unsigned int id, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution,
+      float * vertices, int vertexCount, float x, float y, float z, float rotX,
+      float rotY, float rotZ, float rotW, float density);
+
+   /// Single-scene form of removeShapeInScene.
+   ///
+   void   removeShape(unsigned int id, unsigned int shapeId);
+
+   /// Single-scene form of createActorSphereInScene.
+   ///
+   void   createActorSphere(unsigned int id, char * name, float x, float y,
+      float z, unsigned int shapeId, float staticFriction,
+      float dynamicFriction, float restitution, float radius, float density,
+      bool isDynamic, bool reportCollisions);
+
+   /// Single-scene form of createActorBoxInScene.
+   ///
+   void   createActorBox(unsigned int id, char * name, float posX, float posY,
+      float posZ, unsigned int shapeId, float staticFriction,
+      float dynamicFriction, float restitution, float halfX, float halfY,
+      float halfZ, float density, bool isDynamic, bool reportCollisions);
+
+   /// Single-scene form of createActorCapsuleInScene.
+   ///
+   void   createActorCapsule(unsigned int id, char * name, float x, float y,
+      float z, float rotX, float rotY, float rotZ, float rotW,
+      unsigned int shapeId, float staticFriction, float dynamicFriction,
+      float restitution, float halfHeight, float radius, float density,
+      bool isDynamic, bool reportCollisions);
+
+   /// Single-scene form of createActorTriangleMeshInScene.
+   ///
+   void   createActorTriangleMesh(unsigned int id, char * name, float x,
+      float y, float z, unsigned int shapeId, float staticFriction,
+      float dynamicFriction, float restitution, float* vertices, int* indices,
+      int vertexCount, int indexCount, bool isDynamic, bool reportCollisions);
+
+   /// Single-scene form of createActorConvexMeshInScene.
+   ///
+   void   createActorConvexMesh(unsigned int id, char * name, float x, float y,
+      float z, unsigned int shapeId, float staticFriction,
+      float dynamicFriction, float restitution, float* vertices,
+      int vertexCount, float density, bool isDynamic, bool reportCollisions);
+
+   /// Single-scene form of removeActorInScene.
+   ///
+   void   removeActor(unsigned int id);
+
+   /// Single-scene form of updateMaterialPropertiesInScene.
+   ///
+   void   updateMaterialProperties(unsigned int id, unsigned int shapeId,
+      float staticFriction, float dynamicFriction, float restitution);
+
+   /// Single-scene form of getActorMassInScene.
+   ///
+   float   getActorMass(unsigned int id);
+
+   /// Single-scene form of clearAllForcesInScene.
+   ///
+   void   clearAllForces(unsigned int id);
+
+   /// Single-scene form of addForceInScene.
+   ///
+   bool   addForce(unsigned int id, float forceX, float forceY, float forceZ);
+
+   /// Single-scene form of addTorqueInScene.
+   ///
+   bool   addTorque(unsigned int id, float torqueX, float torqueY,
+      float torqueZ);
+
+   /// Single-scene form of setTransformationInScene.
+   ///
+   void   setTransformation(unsigned int id, float posX, float posY, float posZ,
+      float rotX, float rotY, float rotZ, float rotW);
+
+   /// Single-scene form of setPositionInScene.
+   ///
+   void   setPosition(unsigned int id, ActorPosition pos);
+
+   /// Single-scene form of getPositionInScene.
+   ///
+   ActorPosition   getPosition(unsigned int id);
+
+   /// Single-scene form of setRotationInScene.
+   ///
+   void   setRotation(unsigned int id, ActorOrientation orient);
+
+   /// Single-scene form of getRotationInScene.
+   ///
+   ActorOrientation   getRotation(unsigned int id);
+
+   /// Single-scene form of setLinearVelocityInScene.
+   ///
+   void   setLinearVelocity(unsigned int id, float x, float y, float z);
+
+   /// Single-scene form of setAngularVelocityInScene.
+   ///
+   void   setAngularVelocity(unsigned int id, float x, float y, float z);
+
+   /// Single-scene form of setGravityInScene.
+   ///
+   void   setGravity(unsigned int id, float x, float y, float z);
+
+   /// Single-scene form of enableGravityInScene.
+   ///
+   void   enableGravity(unsigned int id, bool enabled);
+
+   /// Single-scene form of setLinearDampingInScene.
+   ///
+   void   setLinearDamping(unsigned int id, float damping);
+
+   /// Single-scene form of setAngularDampingInScene.
+   ///
+   void   setAngularDamping(unsigned int id, float damping);
+
+   /// Single-scene form of updateShapeDensityInScene.
+   ///
+   void   updateShapeDensity(unsigned int id, unsigned int shapeID,
+      float density);
+
+   /// Single-scene form of updateActorMassInScene.
+   ///
+   bool   updateActorMass(unsigned int id, float mass);
+
+   /// Single-scene form of createGroundPlaneInScene.
+   ///
+   void   createGroundPlane(float x, float y, float z);
+
+   /// Single-scene form of releaseGroundPlaneInScene.
+   ///
+   void   releaseGroundPlane();
+
+   /// Single-scene form of setHeightFieldTileSizeInScene.
+   ///
+   void   setHeightFieldTileSize(int tileSize);
+
+   /// Single-scene form of setHeightFieldInScene.
+   ///
+   void   setHeightField(unsigned terrainActorID, unsigned int terrainShapeID,
+      int regionSizeX, int regionSizeY, float rowSpacing, float columnSpacing,
+      float * posts, float heightScaleFactor);
+
+   /// Single-scene form of updateHeightFieldInScene.
+   ///
+   bool   updateHeightField(unsigned int terrainActorID, int startRow,
+      int startColumn, int rowCount, int columnCount, float * posts);
+
+   /// Single-scene form of addJointInScene.
+   ///
+   void   addJoint(unsigned int jointID, unsigned int actorID1,
+      unsigned int actorID2, float * actor1Pos, float * actor1Quat,
+      float * actor2Pos, float * actor2Quat, float * linearLowerLimit,
+      float * linearUpperLimit, float * angularLowerLimit,
+      float * angularUpperLimit);
+
+   /// Single-scene form of addGlobalFrameJointInScene.
+   ///
+   void   addGlobalFrameJoint(unsigned int jointID, unsigned int actorID,
+      float * actorPos, float * actorQuat, float * linearLowerLimit,
+      float * linearUpperLimit, float * angularLowerLimit,
+      float * angularUpperLimit);
+
+   /// Single-scene form of removeJointInScene.
+   ///
+   void   removeJoint(unsigned int id);
+
+   /// Single-scene form of applyCommandsInScene.
+   ///
+   int   applyCommands(void * commandBuffer, int bufferSize,
+      unsigned int * commandResults);
+
+   /// Single-scene form of queueCommandsInScene.
+   ///
+   bool   queueCommands(void * commandBuffer, int bufferSize);
+
+   /// Single-scene form of initCommandFailureUpdateInScene.
+   ///
+   void   initCommandFailureUpdate(CommandFailure * failureArray,
+      int maxFailures);
+
+   /// Single-scene form of getCommandFailuresInScene.
+   ///
+   void   getCommandFailures(unsigned int * failureCount);
+
+   /// Single-scene form of beginSimulateInScene.
+   ///
+   bool   beginSimulate(float time);
+
+   /// Single-scene form of pollSimulateInScene.
+   ///
+   bool   pollSimulate();
+
+   /// Single-scene form of endSimulateInScene.
+   ///
+   int   endSimulate(unsigned int * updatedEntityCount,
+      unsigned int * updatedCollisionCount,
+      unsigned int * droppedCollisionCount);
+
+   /// Single-scene form of simulateInScene.
+   ///
    void   simulate(float time, unsigned int * updatedEntityCount,
       unsigned int * updatedCollisionCount);
 
+   /// Single-scene form of getStepTimingsInScene.
+   ///
+   void   getStepTimings(StepTimings * timings);
+
+   /// Single-scene form of getStatisticsInScene.
+   ///
+   void   getStatistics(PhysicsStatistics * statistics, bool reset);
+
+   /// Single-scene form of runSceneQueriesInScene.
+   ///
+   int   runSceneQueries(RaycastQuery * raycasts, int raycastCount,
+      QueryHit * raycastHits, SweepQuery * sweeps, int sweepCount,
+      QueryHit * sweepHits, OverlapQuery * overlaps, int overlapCount,
+      QueryHit * overlapHits);
+
    /// Construct a joint between two actors.
    ///
+   /// @param scene The scene that the joint is added to.
    /// @param jointID The unique identifier of the joint being added
    /// @param actor1 The first actor being joined.
    /// @param actor2 The second actor being joined.
@@ -823,8 +1550,9 @@ extern "C"
    /// @param angularLowerLimit Lower limits of each of the 3 rotational axes
    /// @param angularUpperLimit Upper limits of each of the 3 rotational axes
    ///
-   void   constructJoint(unsigned int jointID, PhysXRigidActor * actor1,
-                         PhysXRigidActor * actor2, float * actor1Pos,
+   void   constructJoint(PhysXScene * scene, unsigned int jointID,
+                         PhysXRigidActor * actor1, PhysXRigidActor * actor2,
+                         float * actor1Pos,
                          float * actor1Quat, float * actor2Pos,
                          float * actor2Quat, float * linearLowerLimit,
                          float * linearUpperLimit, float * angularLowerLimit,
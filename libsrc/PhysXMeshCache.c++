@@ -0,0 +1,675 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "PhysXMeshCache.h++"
+
+#include <stdio.h>
+#include <string.h>
+
+
+// Version of the key computation; changing how meshes are cooked must change
+// this as well, so that meshes persisted by older versions aren't used
+#define PHYSX_MESH_CACHE_VERSION   2
+
+
+PhysXMeshCache::PhysXMeshCache(PxPhysics * physics, PxCooking * cooking)
+{
+   // Set the name of this class for notifications
+   setName("[PhysXMeshCache] ");
+
+   // Keep reference to the objects used to create the meshes
+   px_physics = physics;
+   px_cooking = cooking;
+
+   // Allocate the table and mark every slot as empty
+   slot_capacity = 256;
+   cache_slots = new CacheSlot[slot_capacity];
+   memset(cache_slots, 0, slot_capacity * sizeof(CacheSlot));
+   mesh_count = 0;
+
+   // Meshes are only kept in memory until a directory is given
+   cache_directory = NULL;
+
+   // Nothing has been looked up yet
+   memset(&cache_statistics, 0, sizeof(cache_statistics));
+
+   // Initialize the mutexes that guard the table and the cooking library
+   pthread_mutex_init(&cache_mutex, NULL);
+   pthread_mutex_init(&cooking_mutex, NULL);
+}
+
+
+PhysXMeshCache::~PhysXMeshCache()
+{
+   // Release the cache's reference to every mesh; meshes still used by
+   // shapes live on until those shapes are released
+   for (unsigned int i = 0; i < slot_capacity; i++)
+   {
+      if (cache_slots[i].triangle_mesh != NULL)
+         cache_slots[i].triangle_mesh->release();
+      if (cache_slots[i].convex_mesh != NULL)
+         cache_slots[i].convex_mesh->release();
+   }
+
+   // Clean up the table and the directory name
+   delete[] cache_slots;
+   delete[] cache_directory;
+
+   // Clean up the mutexes
+   pthread_mutex_destroy(&cache_mutex);
+   pthread_mutex_destroy(&cooking_mutex);
+}
+
+
+void PhysXMeshCache::computeKey(bool isConvex, float * vertices,
+   int vertexCount, int * indices, int indexCount, MeshKey * key)
+{
+   unsigned long long    hash;
+   unsigned long long    check;
+   const unsigned char * bytes;
+   unsigned int          header[4];
+   unsigned int          size;
+
+   // Describe the kind and size of the mesh, so that differently shaped
+   // data can't share a key
+   header[0] = PHYSX_MESH_CACHE_VERSION;
+   header[1] = isConvex ? 1 : 0;
+   header[2] = (unsigned int) vertexCount;
+   header[3] = (unsigned int) indexCount;
+
+   // Compute two independent hashes over the header and the data: the
+   // 64-bit FNV-1a hash, which the cache is keyed by, and a multiplicative
+   // hash that mixes each byte in differently and only serves to tell
+   // apart data that happens to share the first hash
+   hash = 14695981039346656037ull;
+   check = 0x9e3779b97f4a7c15ull;
+   bytes = (const unsigned char *) header;
+   for (unsigned int i = 0; i < sizeof(header); i++)
+   {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+      check = (check + bytes[i] + 1) * 0xff51afd7ed558ccdull;
+      check ^= check >> 29;
+   }
+
+   // Hash the vertex data
+   bytes = (const unsigned char *) vertices;
+   size = vertexCount * 3 * sizeof(float);
+   for (unsigned int i = 0; i < size; i++)
+   {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+      check = (check + bytes[i] + 1) * 0xff51afd7ed558ccdull;
+      check ^= check >> 29;
+   }
+
+   // Hash the index data, if there is any
+   if (indices != NULL)
+   {
+      bytes = (const unsigned char *) indices;
+      size = indexCount * sizeof(int);
+      for (unsigned int i = 0; i < size; i++)
+      {
+         hash = (hash ^ bytes[i]) * 1099511628211ull;
+         check = (check + bytes[i] + 1) * 0xff51afd7ed558ccdull;
+         check ^= check >> 29;
+      }
+   }
+
+   // Return the resulting key, along with the sizes of the data
+   memset(key, 0, sizeof(MeshKey));
+   key->hash = hash;
+   key->check = check;
+   key->vertex_count = (unsigned int) vertexCount;
+   key->index_count = (indices != NULL) ? (unsigned int) indexCount : 0;
+}
+
+
+bool PhysXMeshCache::isSameKey(const MeshKey & first, const MeshKey & second)
+{
+   // Every part of the key has to match
+   return (first.hash == second.hash && first.check == second.check &&
+           first.vertex_count == second.vertex_count &&
+           first.index_count == second.index_count);
+}
+
+
+unsigned int PhysXMeshCache::findSlot(const MeshKey & key)
+{
+   unsigned int   index;
+
+   // The hash is already a good one, so use its low bits as the home slot
+   // and probe linearly until either the key or an empty slot is found;
+   // meshes whose hashes collide simply end up in different slots
+   index = (unsigned int) key.hash & (slot_capacity - 1);
+   while ((cache_slots[index].triangle_mesh != NULL ||
+           cache_slots[index].convex_mesh != NULL) &&
+          !isSameKey(cache_slots[index].mesh_key, key))
+   {
+      index = (index + 1) & (slot_capacity - 1);
+   }
+
+   // Return the slot that was found
+   return index;
+}
+
+
+void PhysXMeshCache::grow()
+{
+   CacheSlot *    oldSlots;
+   unsigned int   oldCapacity;
+
+   // Keep track of the old table, so its entries can be re-inserted
+   oldSlots = cache_slots;
+   oldCapacity = slot_capacity;
+
+   // Allocate a table twice the size and mark every slot as empty
+   slot_capacity = oldCapacity * 2;
+   cache_slots = new CacheSlot[slot_capacity];
+   memset(cache_slots, 0, slot_capacity * sizeof(CacheSlot));
+
+   // Re-insert each of the meshes from the old table
+   for (unsigned int i = 0; i < oldCapacity; i++)
+   {
+      if (oldSlots[i].triangle_mesh != NULL || oldSlots[i].convex_mesh != NULL)
+         cache_slots[findSlot(oldSlots[i].mesh_key)] = oldSlots[i];
+   }
+
+   // Clean up the old table
+   delete[] oldSlots;
+}
+
+
+PxBase * PhysXMeshCache::lookupMesh(const MeshKey & key, bool isConvex)
+{
+   CacheSlot *   slot;
+   PxBase *      result;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&cache_mutex);
+
+   // Find the slot of the mesh and check that it holds the right kind
+   slot = &cache_slots[findSlot(key)];
+   if (isConvex)
+      result = slot->convex_mesh;
+   else
+      result = slot->triangle_mesh;
+
+   // Mark the mesh as being in use and count the hit, along with the memory
+   // that would have gone to a copy of the mesh
+   if (result != NULL)
+   {
+      slot->users++;
+      cache_statistics.Hits++;
+      cache_statistics.BytesSaved += slot->cooked_size;
+   }
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&cache_mutex);
+   return result;
+}
+
+
+PxBase * PhysXMeshCache::insertMesh(const MeshKey & key, PxBase * mesh,
+   unsigned int cookedSize)
+{
+   CacheSlot *   slot;
+   PxBase *      result;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&cache_mutex);
+
+   // Keep the load factor at or below one half, so that probe sequences stay
+   // short
+   if ((mesh_count + 1) * 2 > slot_capacity)
+      grow();
+
+   // Check whether another thread cooked the same mesh in the meantime
+   slot = &cache_slots[findSlot(key)];
+   if (slot->triangle_mesh != NULL || slot->convex_mesh != NULL)
+   {
+      // Use the existing mesh and get rid of the duplicate
+      if (slot->convex_mesh != NULL)
+         result = slot->convex_mesh;
+      else
+         result = slot->triangle_mesh;
+      mesh->release();
+   }
+   else
+   {
+      // Store the new mesh; the cache keeps the reference that was handed
+      // out when the mesh was created
+      slot->mesh_key = key;
+      slot->cooked_size = cookedSize;
+      slot->users = 0;
+      if (mesh->is<PxConvexMesh>())
+         slot->convex_mesh = mesh->is<PxConvexMesh>();
+      else
+         slot->triangle_mesh = mesh->is<PxTriangleMesh>();
+      mesh_count++;
+      cache_statistics.BytesCached += cookedSize;
+      result = mesh;
+   }
+
+   // Mark the mesh as being in use
+   slot->users++;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&cache_mutex);
+   return result;
+}
+
+
+bool PhysXMeshCache::getMeshPath(const MeshKey & key, bool isConvex,
+   char * path, int pathSize)
+{
+   int   length;
+
+   // There is no path unless a directory has been given
+   if (cache_directory == NULL)
+      return false;
+
+   // Name the file after the hash of the key, with an extension for the
+   // kind of mesh
+   length = snprintf(path, pathSize, "%s/%016llx.%s", cache_directory,
+      key.hash, isConvex ? "cvx" : "tri");
+   return (length > 0 && length < pathSize);
+}
+
+
+PxBase * PhysXMeshCache::loadMesh(const MeshKey & key, bool isConvex,
+   unsigned int * cookedSize)
+{
+   char                         path[1024];
+   FILE *                       file;
+   long                         size;
+   MeshKey                      fileKey;
+   PxU8 *                       data;
+   PxBase *                     result;
+   PxDefaultMemoryInputData *   inputData;
+
+   // Open the persisted mesh, if there is one
+   if (!getMeshPath(key, isConvex, path, sizeof(path)))
+      return NULL;
+   file = fopen(path, "rb");
+   if (file == NULL)
+      return NULL;
+
+   // The file is named after the hash alone, so check that the key it
+   // starts with belongs to the same data before using it; a file that
+   // belongs to other data is left to be replaced once this mesh is cooked
+   result = NULL;
+   size = 0;
+   if (fread(&fileKey, sizeof(fileKey), 1, file) != 1 ||
+       !isSameKey(fileKey, key))
+   {
+      fclose(file);
+      return NULL;
+   }
+
+   // Read the rest of the file into memory
+   fseek(file, 0, SEEK_END);
+   size = ftell(file) - (long) sizeof(fileKey);
+   fseek(file, sizeof(fileKey), SEEK_SET);
+   if (size > 0)
+   {
+      data = new PxU8[size];
+      if (fread(data, 1, size, file) == (size_t) size)
+      {
+         // Create the mesh from the cooked data; this fails if the data was
+         // cooked by an incompatible version of PhysX, in which case the
+         // mesh is simply cooked again
+         inputData = new PxDefaultMemoryInputData(data, (PxU32) size);
+         if (isConvex)
+            result = px_physics->createConvexMesh(*inputData);
+         else
+            result = px_physics->createTriangleMesh(*inputData);
+         delete inputData;
+      }
+      delete[] data;
+   }
+   fclose(file);
+
+   // Return the mesh, along with the size of its cooked data
+   *cookedSize = (unsigned int) size;
+   return result;
+}
+
+
+void PhysXMeshCache::storeMesh(const MeshKey & key, bool isConvex,
+   const PxU8 * data, PxU32 size)
+{
+   char     path[1024];
+   char     tempPath[1040];
+   FILE *   file;
+   bool     written;
+
+   // Nothing to do unless a directory has been given
+   if (!getMeshPath(key, isConvex, path, sizeof(path)))
+      return;
+
+   // Write the key and the data to a temporary file first, so that a
+   // partially written file is never picked up by another region
+   snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+   file = fopen(tempPath, "wb");
+   if (file == NULL)
+   {
+      notify(AT_WARN, "Unable to write cooked mesh to %s.\n", tempPath);
+      return;
+   }
+   written = (fwrite(&key, sizeof(key), 1, file) == 1);
+   written = (fwrite(data, 1, size, file) == size) && written;
+   written = (fclose(file) == 0) && written;
+
+   // Move the file into place, or clean it up if anything went wrong
+   if (!written || rename(tempPath, path) != 0)
+   {
+      remove(tempPath);
+      notify(AT_WARN, "Unable to write cooked mesh to %s.\n", path);
+   }
+}
+
+
+void PhysXMeshCache::setCacheDirectory(const char * path)
+{
+   // Ensure that the following operations are thread-safe; the directory is
+   // only used while cooking, so the cooking mutex is the one that guards it
+   pthread_mutex_lock(&cooking_mutex);
+
+   // Replace the current directory, if any
+   delete[] cache_directory;
+   cache_directory = NULL;
+   if (path != NULL && path[0] != '\0')
+   {
+      cache_directory = new char[strlen(path) + 1];
+      strcpy(cache_directory, path);
+   }
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&cooking_mutex);
+}
+
+
+PxTriangleMesh * PhysXMeshCache::acquireTriangleMesh(float * vertices,
+   int vertexCount, int * indices, int indexCount, MeshKey * key,
+   bool * cooked)
+{
+   PxBase *                      mesh;
+   PxTriangleMeshDesc            meshDesc;
+   PxDefaultMemoryOutputStream   buffer;
+   PxDefaultMemoryInputData *    inputData;
+   unsigned int                  cookedSize;
+
+   // Nothing has been cooked yet
+   *cooked = false;
+
+   // Look the mesh up in memory first
+   computeKey(false, vertices, vertexCount, indices, indexCount, key);
+   mesh = lookupMesh(*key, false);
+   if (mesh != NULL)
+      return mesh->is<PxTriangleMesh>();
+
+   // Only one thread cooks at a time, since cooking is expensive anyway and
+   // this keeps other threads from cooking the same mesh twice
+   pthread_mutex_lock(&cooking_mutex);
+
+   // Another thread may have finished cooking this mesh while this one was
+   // waiting
+   mesh = lookupMesh(*key, false);
+   if (mesh != NULL)
+   {
+      pthread_mutex_unlock(&cooking_mutex);
+      return mesh->is<PxTriangleMesh>();
+   }
+
+   // Next, try to load the mesh from the cache directory
+   cookedSize = 0;
+   mesh = loadMesh(*key, false, &cookedSize);
+   if (mesh != NULL)
+   {
+      pthread_mutex_lock(&cache_mutex);
+      cache_statistics.DiskHits++;
+      pthread_mutex_unlock(&cache_mutex);
+   }
+   else
+   {
+      // Describe the mesh using the given arrays as they are, since their
+      // layout already matches what PhysX expects
+      meshDesc.points.count = vertexCount;
+      meshDesc.points.stride = sizeof(float) * 3;
+      meshDesc.points.data = vertices;
+      meshDesc.triangles.count = indexCount / 3;
+      meshDesc.triangles.stride = sizeof(int) * 3;
+      meshDesc.triangles.data = indices;
+
+      // Cook the mesh into a stream, so that the cooked data can be persisted
+      // and its size recorded, then create the mesh from it
+      *cooked = true;
+      if (px_cooking->validateTriangleMesh(meshDesc) &&
+          px_cooking->cookTriangleMesh(meshDesc, buffer))
+      {
+         inputData =
+            new PxDefaultMemoryInputData(buffer.getData(), buffer.getSize());
+         mesh = px_physics->createTriangleMesh(*inputData);
+         delete inputData;
+
+         cookedSize = buffer.getSize();
+         if (mesh != NULL)
+            storeMesh(*key, false, buffer.getData(), buffer.getSize());
+      }
+   }
+
+   // Count the miss, since the mesh wasn't found in memory
+   pthread_mutex_lock(&cache_mutex);
+   cache_statistics.Misses++;
+   pthread_mutex_unlock(&cache_mutex);
+
+   // Add the mesh to the cache, if it could be created
+   if (mesh != NULL)
+      mesh = insertMesh(*key, mesh, cookedSize);
+
+   // Now that the mesh is available, let other threads cook
+   pthread_mutex_unlock(&cooking_mutex);
+
+   // Return the mesh, if there is one
+   if (mesh != NULL)
+      return mesh->is<PxTriangleMesh>();
+   else
+      return NULL;
+}
+
+
+PxConvexMesh * PhysXMeshCache::acquireConvexMesh(float * vertices,
+   int vertexCount, MeshKey * key, bool * cooked)
+{
+   PxBase *                      mesh;
+   PxConvexMeshDesc              meshDesc;
+   PxDefaultMemoryOutputStream   buffer;
+   PxDefaultMemoryInputData *    inputData;
+   unsigned int                  cookedSize;
+
+   // Nothing has been cooked yet
+   *cooked = false;
+
+   // Look the mesh up in memory first
+   computeKey(true, vertices, vertexCount, NULL, 0, key);
+   mesh = lookupMesh(*key, true);
+   if (mesh != NULL)
+      return mesh->is<PxConvexMesh>();
+
+   // Only one thread cooks at a time, since cooking is expensive anyway and
+   // this keeps other threads from cooking the same mesh twice
+   pthread_mutex_lock(&cooking_mutex);
+
+   // Another thread may have finished cooking this mesh while this one was
+   // waiting
+   mesh = lookupMesh(*key, true);
+   if (mesh != NULL)
+   {
+      pthread_mutex_unlock(&cooking_mutex);
+      return mesh->is<PxConvexMesh>();
+   }
+
+   // Next, try to load the mesh from the cache directory
+   cookedSize = 0;
+   mesh = loadMesh(*key, true, &cookedSize);
+   if (mesh != NULL)
+   {
+      pthread_mutex_lock(&cache_mutex);
+      cache_statistics.DiskHits++;
+      pthread_mutex_unlock(&cache_mutex);
+   }
+   else
+   {
+      // Describe the mesh using the given array as it is, since its layout
+      // already matches what PhysX expects
+      meshDesc.points.count = vertexCount;
+      meshDesc.points.stride = sizeof(float) * 3;
+      meshDesc.points.data = vertices;
+      meshDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
+      meshDesc.flags |= PxConvexFlag::eINFLATE_CONVEX;
+      meshDesc.vertexLimit = 256;
+
+      // Attempt to 'cook' the mesh data into a form which allows PhysX to
+      // perform efficient collision detection, then create the mesh from it
+      *cooked = true;
+      if (px_cooking->cookConvexMesh(meshDesc, buffer))
+      {
+         inputData =
+            new PxDefaultMemoryInputData(buffer.getData(), buffer.getSize());
+         mesh = px_physics->createConvexMesh(*inputData);
+         delete inputData;
+
+         cookedSize = buffer.getSize();
+         if (mesh != NULL)
+            storeMesh(*key, true, buffer.getData(), buffer.getSize());
+      }
+   }
+
+   // Count the miss, since the mesh wasn't found in memory
+   pthread_mutex_lock(&cache_mutex);
+   cache_statistics.Misses++;
+   pthread_mutex_unlock(&cache_mutex);
+
+   // Add the mesh to the cache, if it could be created
+   if (mesh != NULL)
+      mesh = insertMesh(*key, mesh, cookedSize);
+
+   // Now that the mesh is available, let other threads cook
+   pthread_mutex_unlock(&cooking_mutex);
+
+   // Return the mesh, if there is one
+   if (mesh != NULL)
+      return mesh->is<PxConvexMesh>();
+   else
+      return NULL;
+}
+
+
+void PhysXMeshCache::releaseMesh(const MeshKey & key)
+{
+   CacheSlot *   slot;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&cache_mutex);
+
+   // The caller is done with the mesh, so it may be purged once no shape
+   // uses it anymore
+   slot = &cache_slots[findSlot(key)];
+   if (slot->users > 0)
+      slot->users--;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&cache_mutex);
+}
+
+
+unsigned int PhysXMeshCache::purge()
+{
+   CacheSlot *    oldSlots;
+   unsigned int   refCount;
+   unsigned int   result;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&cache_mutex);
+
+   // Rebuild the table from scratch, rather than removing entries from it in
+   // place, so that no probe sequence is broken
+   oldSlots = cache_slots;
+   cache_slots = new CacheSlot[slot_capacity];
+   memset(cache_slots, 0, slot_capacity * sizeof(CacheSlot));
+   mesh_count = 0;
+   result = 0;
+
+   for (unsigned int i = 0; i < slot_capacity; i++)
+   {
+      // Skip empty slots
+      if (oldSlots[i].triangle_mesh == NULL && oldSlots[i].convex_mesh == NULL)
+         continue;
+
+      // The cache holds one reference, so any more belong to shapes
+      if (oldSlots[i].triangle_mesh != NULL)
+         refCount = oldSlots[i].triangle_mesh->getReferenceCount();
+      else
+         refCount = oldSlots[i].convex_mesh->getReferenceCount();
+
+      if (refCount <= 1 && oldSlots[i].users == 0)
+      {
+         // Nothing uses the mesh anymore, so release it
+         if (oldSlots[i].triangle_mesh != NULL)
+            oldSlots[i].triangle_mesh->release();
+         else
+            oldSlots[i].convex_mesh->release();
+         cache_statistics.BytesCached -= oldSlots[i].cooked_size;
+         result++;
+      }
+      else
+      {
+         // Keep the mesh
+         cache_slots[findSlot(oldSlots[i].mesh_key)] = oldSlots[i];
+         mesh_count++;
+      }
+   }
+
+   // Clean up the old table
+   delete[] oldSlots;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&cache_mutex);
+
+   // Return the number of meshes that were released
+   return result;
+}
+
+
+void PhysXMeshCache::getStatistics(MeshCacheStatistics * stats)
+{
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&cache_mutex);
+
+   // Copy the running statistics, along with the current number of meshes
+   *stats = cache_statistics;
+   stats->Entries = mesh_count;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&cache_mutex);
+}
+
@@ -0,0 +1,303 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PHYSX_MESH_CACHE_H
+#define PHYSX_MESH_CACHE_H
+
+#include "PxPhysicsAPI.h"
+
+#include "atNotifier.h++"
+
+#include "pthread.h"
+
+
+using namespace physx;
+
+
+/// Struct for reporting how effective the mesh cache has been. Misses count
+/// every mesh that wasn't found in memory, including those that were then
+/// loaded from the cache directory (DiskHits) instead of being cooked.
+///
+struct MeshCacheStatistics
+{
+   unsigned int         Hits;
+   unsigned int         Misses;
+   unsigned int         DiskHits;
+   unsigned int         Entries;
+   unsigned long long   BytesCached;
+   unsigned long long   BytesSaved;
+};
+
+
+/// Struct for the identity of a cached mesh. The hash of the data a mesh was
+/// cooked from is what the cache is keyed by, but different data can share
+/// a hash; the sizes of the data and a second, independent hash are kept
+/// along with it, and all of them have to match before a cached mesh is
+/// used.
+///
+struct MeshKey
+{
+   unsigned long long   hash;
+   unsigned long long   check;
+   unsigned int         vertex_count;
+   unsigned int         index_count;
+};
+
+
+/// Cache of cooked triangle and convex meshes, keyed by a hash of the data
+/// they were cooked from.
+///
+/// Identical geometry is only cooked once; every shape created from it
+/// shares the same PhysX mesh. The cache holds one reference to each mesh,
+/// while each shape holds another, so a mesh is only released once it is no
+/// longer used by any shape and the cache is purged. Cooking happens under a
+/// mutex of its own, so a cache miss never blocks lookups of other meshes.
+/// Optionally, cooked meshes are also written to a directory, from which
+/// they are loaded instead of being cooked again the next time around.
+
+class PhysXMeshCache : public atNotifier
+{
+   protected:
+      /// A single entry of the hash table; a slot is empty when both of its
+      /// meshes are NULL.
+      ///
+      struct CacheSlot
+      {
+         MeshKey              mesh_key;
+         PxTriangleMesh *     triangle_mesh;
+         PxConvexMesh *       convex_mesh;
+         unsigned int         cooked_size;
+         unsigned int         users;
+      };
+
+      /// The physics object that creates the meshes.
+      ///
+      PxPhysics *          px_physics;
+
+      /// The cooking library used on a cache miss.
+      ///
+      PxCooking *          px_cooking;
+
+      /// The table of slots; the capacity is always a power of two.
+      ///
+      CacheSlot *          cache_slots;
+
+      /// The number of slots in the table.
+      ///
+      unsigned int         slot_capacity;
+
+      /// The number of meshes currently held by the table.
+      ///
+      unsigned int         mesh_count;
+
+      /// The directory that cooked meshes are persisted to, or NULL if they
+      /// are only kept in memory.
+      ///
+      char *               cache_directory;
+
+      /// The running statistics of the cache.
+      ///
+      MeshCacheStatistics  cache_statistics;
+
+      /// Mutex object that ensures the thread-safety of the table.
+      ///
+      pthread_mutex_t      cache_mutex;
+
+      /// Mutex object that serializes the calls into the cooking library.
+      ///
+      pthread_mutex_t      cooking_mutex;
+
+      /// Computes the key of a mesh from the data it is cooked from.
+      ///
+      /// @param isConvex Whether the data describes a convex mesh.
+      /// @param vertices The array of vertices (x, y, z per vertex).
+      /// @param vertexCount The number of vertices.
+      /// @param indices The array of triangle indices; may be NULL.
+      /// @param indexCount The number of indices.
+      /// @param key Passed by reference value that returns the key of the
+      /// mesh.
+      ///
+      void   computeKey(bool isConvex, float * vertices, int vertexCount,
+         int * indices, int indexCount, MeshKey * key);
+
+      /// Checks whether two keys identify the same mesh.
+      ///
+      /// @param first The first key.
+      /// @param second The second key.
+      ///
+      /// @return True if every part of the keys matches.
+      ///
+      static bool   isSameKey(const MeshKey & first, const MeshKey & second);
+
+      /// Finds the slot that either holds the given key or is the empty slot
+      /// where the key would be inserted. The cache mutex must be held.
+      ///
+      /// @param key The key being searched for.
+      ///
+      /// @return The index of the slot.
+      ///
+      unsigned int   findSlot(const MeshKey & key);
+
+      /// Doubles the capacity of the table and re-inserts all of the meshes.
+      /// The cache mutex must be held.
+      ///
+      void   grow();
+
+      /// Looks up a mesh and, if it is found, marks it as being in use.
+      ///
+      /// @param key The key of the mesh.
+      /// @param isConvex Whether a convex mesh is wanted.
+      ///
+      /// @return The mesh (a PxTriangleMesh or PxConvexMesh) or NULL.
+      ///
+      PxBase *   lookupMesh(const MeshKey & key, bool isConvex);
+
+      /// Inserts a newly created mesh into the table and marks it as being in
+      /// use. If another thread inserted the same mesh in the meantime, the
+      /// new mesh is released and the existing one is used instead.
+      ///
+      /// @param key The key of the mesh.
+      /// @param mesh The mesh (a PxTriangleMesh or PxConvexMesh).
+      /// @param cookedSize The size of the cooked mesh data in bytes.
+      ///
+      /// @return The mesh that is now held by the table.
+      ///
+      PxBase *   insertMesh(const MeshKey & key, PxBase * mesh,
+         unsigned int cookedSize);
+
+      /// Builds the path of the file that persists the given mesh.
+      ///
+      /// @param key The key of the mesh.
+      /// @param isConvex Whether the mesh is a convex mesh.
+      /// @param path The buffer that receives the path.
+      /// @param pathSize The size of the buffer.
+      ///
+      /// @return True if a cache directory is set and the path fit.
+      ///
+      bool   getMeshPath(const MeshKey & key, bool isConvex, char * path,
+         int pathSize);
+
+      /// Loads a persisted mesh from the cache directory. The file starts with
+      /// the key of the mesh it holds, which has to match the given key.
+      ///
+      /// @param key The key of the mesh.
+      /// @param isConvex Whether the mesh is a convex mesh.
+      /// @param cookedSize Passed by reference value that returns the size of
+      /// the cooked mesh data in bytes.
+      ///
+      /// @return The loaded mesh, or NULL if it wasn't persisted or could not
+      /// be read.
+      ///
+      PxBase *   loadMesh(const MeshKey & key, bool isConvex,
+         unsigned int * cookedSize);
+
+      /// Writes cooked mesh data to the cache directory, if one is set,
+      /// preceded by the key of the mesh.
+      ///
+      /// @param key The key of the mesh.
+      /// @param isConvex Whether the mesh is a convex mesh.
+      /// @param data The cooked mesh data.
+      /// @param size The size of the cooked mesh data in bytes.
+      ///
+      void   storeMesh(const MeshKey & key, bool isConvex,
+         const PxU8 * data, PxU32 size);
+
+   public:
+      /// Constructor.
+      ///
+      /// @param physics The physics object that creates the meshes.
+      /// @param cooking The cooking library used on a cache miss.
+      ///
+      PhysXMeshCache(PxPhysics * physics, PxCooking * cooking);
+
+      /// Destructor. The cache's reference to every mesh is released.
+      ///
+      ~PhysXMeshCache();
+
+      /// Sets the directory that cooked meshes are persisted to.
+      ///
+      /// @param path The directory, which must already exist; NULL or an
+      /// empty string keeps the cache in memory only.
+      ///
+      void   setCacheDirectory(const char * path);
+
+      /// Fetches the triangle mesh for the given data, cooking it if it is
+      /// not cached yet. The mesh stays in use, and will not be purged, until
+      /// releaseMesh is called with the returned key.
+      ///
+      /// @param vertices The array of vertices (x, y, z per vertex).
+      /// @param vertexCount The number of vertices.
+      /// @param indices The array of triangle indices (three per triangle).
+      /// @param indexCount The number of indices.
+      /// @param key Passed by reference value that returns the key of the
+      /// mesh.
+      /// @param cooked Passed by reference value that returns whether the
+      /// mesh had to be cooked, rather than being found in memory or in the
+      /// cache directory.
+      ///
+      /// @return The triangle mesh, or NULL if it could not be cooked.
+      ///
+      PxTriangleMesh *   acquireTriangleMesh(float * vertices,
+         int vertexCount, int * indices, int indexCount, MeshKey * key,
+         bool * cooked);
+
+      /// Fetches the convex mesh for the given data, cooking it if it is not
+      /// cached yet. The mesh stays in use, and will not be purged, until
+      /// releaseMesh is called with the returned key.
+      ///
+      /// @param vertices The array of vertices (x, y, z per vertex).
+      /// @param vertexCount The number of vertices.
+      /// @param key Passed by reference value that returns the key of the
+      /// mesh.
+      /// @param cooked Passed by reference value that returns whether the
+      /// mesh had to be cooked, rather than being found in memory or in the
+      /// cache directory.
+      ///
+      /// @return The convex mesh, or NULL if it could not be cooked.
+      ///
+      PxConvexMesh *   acquireConvexMesh(float * vertices, int vertexCount,
+         MeshKey * key, bool * cooked);
+
+      /// Indicates that the caller is done creating shapes from a mesh that
+      /// was acquired from the cache.
+      ///
+      /// @param key The key returned when the mesh was acquired.
+      ///
+      void   releaseMesh(const MeshKey & key);
+
+      /// Releases every cached mesh that is neither used by a shape nor in the
+      /// middle of being acquired. Persisted meshes are kept on disk.
+      ///
+      /// @return The number of meshes that were released.
+      ///
+      unsigned int   purge();
+
+      /// Fetches the statistics of the cache.
+      ///
+      /// @param stats The structure that receives the statistics.
+      ///
+      void   getStatistics(MeshCacheStatistics * stats);
+};
+
+#endif
+
@@ -0,0 +1,287 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "PhysXRecorder.h++"
+#include "PhysXCommandQueue.h++"
+
+#include <stdarg.h>
+#include <string.h>
+
+
+// The amount of buffered records that triggers a write to the log
+#define PHYSX_RECORDER_FLUSH_SIZE   (256 * 1024)
+
+
+PhysXRecorder::PhysXRecorder()
+{
+   // Set the name of this class
+   setName("[PhysXRecorder] ");
+
+   // Nothing is being recorded yet
+   log_file = NULL;
+   is_recording = false;
+
+   // Start out with a buffer that can hold a batch of typical calls
+   buffer_capacity = PHYSX_RECORDER_FLUSH_SIZE * 2;
+   record_buffer = new unsigned char[buffer_capacity];
+   buffer_size = 0;
+
+   // Initialize the mutex that keeps the records apart
+   pthread_mutex_init(&recorder_mutex, NULL);
+}
+
+
+PhysXRecorder::~PhysXRecorder()
+{
+   // Finish the session, if one is being recorded
+   stop();
+
+   // Clean up the buffer and the mutex
+   delete[] record_buffer;
+   pthread_mutex_destroy(&recorder_mutex);
+}
+
+
+void PhysXRecorder::reserve(unsigned int size)
+{
+   unsigned int      newCapacity;
+   unsigned char *   newBuffer;
+
+   // Nothing to do if the bytes already fit
+   if (buffer_size + size <= buffer_capacity)
+      return;
+
+   // Grow the buffer, which only happens for unusually large payloads such
+   // as the posts of a large terrain
+   newCapacity = buffer_capacity;
+   while (buffer_size + size > newCapacity)
+      newCapacity *= 2;
+
+   newBuffer = new unsigned char[newCapacity];
+   memcpy(newBuffer, record_buffer, buffer_size);
+   delete[] record_buffer;
+   record_buffer = newBuffer;
+   buffer_capacity = newCapacity;
+}
+
+
+void PhysXRecorder::append(const void * data, unsigned int size)
+{
+   unsigned int   paddedSize;
+
+   // Keep every value aligned to four bytes, so that the replay tool can use
+   // arrays in place
+   paddedSize = (size + 3) & ~3u;
+   reserve(paddedSize);
+
+   // Copy the bytes and zero the padding
+   if (size > 0)
+      memcpy(&record_buffer[buffer_size], data, size);
+   memset(&record_buffer[buffer_size + size], 0, paddedSize - size);
+   buffer_size += paddedSize;
+}
+
+
+void PhysXRecorder::flush()
+{
+   // Write out everything that has been buffered
+   if (log_file != NULL && buffer_size > 0)
+   {
+      if (fwrite(record_buffer, 1, buffer_size, log_file) != buffer_size)
+         notify(AT_WARN, "Failed to write to the call log.\n");
+   }
+
+   // The buffer is empty again
+   buffer_size = 0;
+}
+
+
+bool PhysXRecorder::start(const char * path)
+{
+   unsigned int   version;
+
+   // Finish the session that is currently being recorded, if any
+   stop();
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&recorder_mutex);
+
+   // Create the log
+   log_file = fopen(path, "wb");
+   if (log_file == NULL)
+   {
+      pthread_mutex_unlock(&recorder_mutex);
+      notify(AT_WARN, "Failed to create call log %s.\n", path);
+      return false;
+   }
+
+   // Begin the log with its magic number and layout version
+   version = PHYSX_RECORDING_VERSION;
+   append(PHYSX_RECORDING_MAGIC, 4);
+   append(&version, sizeof(version));
+
+   // Calls are recorded from now on
+   is_recording = true;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&recorder_mutex);
+   return true;
+}
+
+
+void PhysXRecorder::stop()
+{
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&recorder_mutex);
+
+   // Write out the remaining calls and close the log
+   if (log_file != NULL)
+   {
+      flush();
+      fclose(log_file);
+      log_file = NULL;
+   }
+
+   // No more calls are recorded
+   is_recording = false;
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&recorder_mutex);
+}
+
+
+void PhysXRecorder::record(PhysXCall call, const char * format, ...)
+{
+   va_list              args;
+   unsigned int         recordStart;
+   CallRecordHeader     header;
+   unsigned int         intValue;
+   float                floatValue;
+   const char *         stringValue;
+   const void *         dataValue;
+   int                  count;
+   unsigned int         size;
+
+   // Ensure that the following operations are thread-safe
+   pthread_mutex_lock(&recorder_mutex);
+
+   // The session may have been finished since the caller checked for it
+   if (log_file == NULL)
+   {
+      pthread_mutex_unlock(&recorder_mutex);
+      return;
+   }
+
+   // Leave room for the header, whose size is only known at the end
+   recordStart = buffer_size;
+   header.Call = (unsigned int) call;
+   header.Size = 0;
+   append(&header, sizeof(header));
+
+   // Serialize each of the arguments according to the format
+   va_start(args, format);
+   for (const char * type = format; *type != '\0'; type++)
+   {
+      switch (*type)
+      {
+         case 'u':
+         case 'i':
+         case 'b':
+            // Integers and bools all take 32 bits (bools are promoted to int
+            // when passed through the variable arguments)
+            intValue = va_arg(args, unsigned int);
+            if (*type == 'b')
+               intValue = (intValue != 0);
+            append(&intValue, sizeof(intValue));
+            break;
+
+         case 'f':
+            // Floats are promoted to double when passed through the variable
+            // arguments
+            floatValue = (float) va_arg(args, double);
+            append(&floatValue, sizeof(floatValue));
+            break;
+
+         case 's':
+            // Strings are stored along with their terminating zero, so that
+            // the replay tool can use them in place
+            stringValue = va_arg(args, const char *);
+            if (stringValue == NULL)
+            {
+               size = 0xFFFFFFFF;
+               append(&size, sizeof(size));
+            }
+            else
+            {
+               size = (unsigned int) strlen(stringValue);
+               append(&size, sizeof(size));
+               append(stringValue, size + 1);
+            }
+            break;
+
+         case 'F':
+         case 'I':
+         case 'D':
+         case 'C':
+            // Arrays are stored with their number of elements (or bytes)
+            dataValue = va_arg(args, const void *);
+            count = va_arg(args, int);
+            if (dataValue == NULL || count < 0)
+               count = 0;
+
+            // Only the well-formed part of a command buffer is stored, since
+            // the size given by the caller can't be trusted
+            if (*type == 'C')
+            {
+               count = PhysXCommandQueue::validateBuffer((void *) dataValue,
+                  count);
+               if (count < 0)
+                  count = 0;
+               else
+                  count = sizeof(CommandBufferHeader) +
+                     count * sizeof(ActorCommand);
+            }
+
+            size = (unsigned int) count;
+            append(&size, sizeof(size));
+            if (*type == 'F' || *type == 'I')
+               append(dataValue, size * 4);
+            else
+               append(dataValue, size);
+            break;
+      }
+   }
+   va_end(args);
+
+   // Now that the size of the arguments is known, complete the header
+   header.Size = buffer_size - recordStart - sizeof(header);
+   memcpy(&record_buffer[recordStart], &header, sizeof(header));
+
+   // Write the records out once enough of them have been buffered
+   if (buffer_size >= PHYSX_RECORDER_FLUSH_SIZE)
+      flush();
+
+   // Now that the operations are complete, unlock the mutex
+   pthread_mutex_unlock(&recorder_mutex);
+}
+
@@ -0,0 +1,227 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PHYSX_RECORDER_H
+#define PHYSX_RECORDER_H
+
+#include "atNotifier.h++"
+
+#include "pthread.h"
+
+#include <stdio.h>
+
+
+/// The four bytes that every call log starts with.
+#define PHYSX_RECORDING_MAGIC     "PXRC"
+
+/// The version of the call log layout; logs carrying any other version are
+/// rejected by the replay tool.
+#define PHYSX_RECORDING_VERSION   1
+
+
+/// Enumeration of the calls that can appear in a call log. The values are
+/// part of the log layout, so new calls may only be added at the end.
+///
+/// RESERVE_DEFAULT_SCENE is not an exported call; it marks the point where
+/// a call of the single-scene API reserved the default scene.
+///
+enum PhysXCall
+{
+   CALL_CREATE_SHARED_DISPATCHER = 1,
+   CALL_CREATE_SCENE = 2,
+   CALL_RESERVE_DEFAULT_SCENE = 3,
+   CALL_DESTROY_SCENE = 4,
+   CALL_INIT_ENTITY_UPDATE_BUFFERS = 5,
+   CALL_INIT_COLLISION_UPDATE_BUFFERS = 6,
+   CALL_INIT_COLLISION_ARRAYS_UPDATE = 7,
+   CALL_SET_COLLISION_REPORT_MODE = 8,
+   CALL_GET_DROPPED_COLLISION_COUNT = 9,
+   CALL_CREATE_ACTOR = 10,
+   CALL_ATTACH_SPHERE = 11,
+   CALL_ATTACH_BOX = 12,
+   CALL_ATTACH_CAPSULE = 13,
+   CALL_ATTACH_TRIANGLE_MESH = 14,
+   CALL_ATTACH_CONVEX_MESH = 15,
+   CALL_SET_MESH_CACHE_DIRECTORY = 16,
+   CALL_PURGE_MESH_CACHE = 17,
+   CALL_REMOVE_SHAPE = 18,
+   CALL_CREATE_ACTOR_SPHERE = 19,
+   CALL_CREATE_ACTOR_BOX = 20,
+   CALL_CREATE_ACTOR_CAPSULE = 21,
+   CALL_CREATE_ACTOR_TRIANGLE_MESH = 22,
+   CALL_CREATE_ACTOR_CONVEX_MESH = 23,
+   CALL_REMOVE_ACTOR = 24,
+   CALL_UPDATE_MATERIAL_PROPERTIES = 25,
+   CALL_GET_ACTOR_MASS = 26,
+   CALL_CLEAR_ALL_FORCES = 27,
+   CALL_ADD_FORCE = 28,
+   CALL_ADD_TORQUE = 29,
+   CALL_SET_TRANSFORMATION = 30,
+   CALL_SET_POSITION = 31,
+   CALL_GET_POSITION = 32,
+   CALL_SET_ROTATION = 33,
+   CALL_GET_ROTATION = 34,
+   CALL_SET_LINEAR_VELOCITY = 35,
+   CALL_SET_ANGULAR_VELOCITY = 36,
+   CALL_SET_GRAVITY = 37,
+   CALL_ENABLE_GRAVITY = 38,
+   CALL_SET_LINEAR_DAMPING = 39,
+   CALL_SET_ANGULAR_DAMPING = 40,
+   CALL_UPDATE_SHAPE_DENSITY = 41,
+   CALL_UPDATE_ACTOR_MASS = 42,
+   CALL_CREATE_GROUND_PLANE = 43,
+   CALL_RELEASE_GROUND_PLANE = 44,
+   CALL_SET_HEIGHT_FIELD_TILE_SIZE = 45,
+   CALL_SET_HEIGHT_FIELD = 46,
+   CALL_UPDATE_HEIGHT_FIELD = 47,
+   CALL_ADD_JOINT = 48,
+   CALL_ADD_GLOBAL_FRAME_JOINT = 49,
+   CALL_REMOVE_JOINT = 50,
+   CALL_APPLY_COMMANDS = 51,
+   CALL_QUEUE_COMMANDS = 52,
+   CALL_INIT_COMMAND_FAILURE_UPDATE = 53,
+   CALL_GET_COMMAND_FAILURES = 54,
+   CALL_BEGIN_SIMULATE = 55,
+   CALL_POLL_SIMULATE = 56,
+   CALL_END_SIMULATE = 57,
+   CALL_RUN_SCENE_QUERIES = 58
+};
+
+
+/// Header of every record in a call log. The header is followed by the
+/// arguments of the call, each of which takes a multiple of four bytes:
+///
+/// 'u', 'i', 'f', 'b': a 32-bit unsigned int, int, float or bool (0 or 1)
+/// 's': a 32-bit length, then the characters and a terminating zero; a NULL
+/// string has a length of 0xFFFFFFFF and no characters
+/// 'F', 'I': a 32-bit count, then that many floats or ints
+/// 'D', 'C': a 32-bit size, then that many bytes of data or of a command
+/// buffer
+///
+/// Strings and data are padded with zeroes to a multiple of four bytes.
+///
+struct CallRecordHeader
+{
+   unsigned int   Call;
+   unsigned int   Size;
+};
+
+
+/// Records the calls made into the library to a compact binary log, which
+/// the replay tool re-drives in order to benchmark a captured session.
+///
+/// Calls are serialized into a memory buffer that is written out in large
+/// blocks, so recording costs little more than copying the arguments. When
+/// no session is being recorded, the only cost is the isRecording() check.
+/// Calls from several threads are logged in the order that they acquire the
+/// recorder, which is the order that the replay tool issues them in.
+
+class PhysXRecorder : public atNotifier
+{
+   protected:
+      /// The log that calls are written to, or NULL when not recording.
+      ///
+      FILE *            log_file;
+
+      /// Whether a session is being recorded; read without locking, so that
+      /// the check stays cheap.
+      ///
+      volatile bool     is_recording;
+
+      /// Buffer that records are serialized into before being written out.
+      ///
+      unsigned char *   record_buffer;
+
+      /// The number of bytes currently in the buffer.
+      ///
+      unsigned int      buffer_size;
+
+      /// The number of bytes the buffer can hold.
+      ///
+      unsigned int      buffer_capacity;
+
+      /// Mutex object that keeps the records of concurrent calls apart.
+      ///
+      pthread_mutex_t   recorder_mutex;
+
+      /// Makes sure that the buffer can hold the given number of additional
+      /// bytes. The recorder mutex must be held.
+      ///
+      /// @param size The number of bytes about to be appended.
+      ///
+      void   reserve(unsigned int size);
+
+      /// Appends bytes to the buffer, padding them to a multiple of four
+      /// bytes. The recorder mutex must be held.
+      ///
+      /// @param data The bytes to append.
+      /// @param size The number of bytes.
+      ///
+      void   append(const void * data, unsigned int size);
+
+      /// Writes the buffered records out to the log. The recorder mutex must
+      /// be held.
+      ///
+      void   flush();
+
+   public:
+      /// Constructor.
+      ///
+      PhysXRecorder();
+
+      /// Destructor. Any session being recorded is finished.
+      ///
+      ~PhysXRecorder();
+
+      /// Starts recording calls to the given file, finishing any session that
+      /// is already being recorded.
+      ///
+      /// @param path The file that the log is written to.
+      ///
+      /// @return True if the file could be created.
+      ///
+      bool   start(const char * path);
+
+      /// Finishes the session being recorded, writing out any buffered calls.
+      ///
+      void   stop();
+
+      /// Checks whether a session is being recorded.
+      ///
+      /// @return True while recording.
+      ///
+      inline bool   isRecording() { return is_recording; }
+
+      /// Appends a call to the log. The arguments are described by the
+      /// format string, one character per argument, as listed for
+      /// CallRecordHeader; 'F', 'I', 'D' and 'C' each take a pointer followed
+      /// by an int count (in elements for 'F' and 'I', in bytes otherwise).
+      ///
+      /// @param call The call being recorded.
+      /// @param format The types of the arguments that follow.
+      ///
+      void   record(PhysXCall call, const char * format, ...);
+};
+
+#endif
+
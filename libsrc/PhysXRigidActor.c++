@@ -22,6 +22,7 @@
 
 
 #include "PhysXRigidActor.h++"
+#include "PhysXSceneQuery.h++"
 #include "PhysXShape.h++"
 
 #include "pthread.h"
@@ -254,6 +255,7 @@ void PhysXRigidActor::addShape(unsigned int shapeId, PxShape * shape,
    atInt *        tempId;
    PhysXShape *   newShape;
    PxFilterData   filterData;
+   PxFilterData   queryData;
 
    // Ensure that the following operations on the actor are thread-safe
    pthread_mutex_lock(&actor_mutex);
@@ -291,6 +293,14 @@ void PhysXRigidActor::addShape(unsigned int shapeId, PxShape * shape,
          filterData.word0 = 1;
          shape->setSimulationFilterData(filterData);
       }
+
+      // Place the shape in the groups that scene queries filter on
+      queryData.word0 = QUERY_GROUP_STATIC;
+      if (actor_type == DYNAMIC)
+         queryData.word0 = QUERY_GROUP_DYNAMIC;
+      if (report_collisions)
+         queryData.word0 |= QUERY_GROUP_REPORTING;
+      shape->setQueryFilterData(queryData);
  
       // Now that a new shape has been attached, the densities have to
       // be updated
@@ -449,7 +459,7 @@ void PhysXRigidActor::detachAllShapes()
 }
 
 
-void PhysXRigidActor::setName(char * name)
+void PhysXRigidActor::setName(const char * name)
 {
    // Ensure that the following operations on the actor are thread-safe
    pthread_mutex_lock(&actor_mutex);
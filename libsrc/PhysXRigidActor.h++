@@ -231,7 +231,7 @@ class PhysXRigidActor : public atItem
       ///
       /// @param name The new name of the actor.
       ///
-      void             setName(char * name);
+      void             setName(const char * name);
       
       /// Fetch the current name of the actor.
       ///
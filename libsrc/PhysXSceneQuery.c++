@@ -0,0 +1,327 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "PhysXSceneQuery.h++"
+
+#include "atInt.h++"
+
+
+PhysXSceneQuery::PhysXSceneQuery()
+{
+   // The scene is given once it is known
+   px_scene = NULL;
+
+   // No query is running yet
+   ignore_actor_id = 0;
+   hit_type = PxQueryHitType::eBLOCK;
+}
+
+
+PhysXSceneQuery::~PhysXSceneQuery()
+{
+}
+
+
+void PhysXSceneQuery::setScene(PxScene * scene)
+{
+   // Keep a reference to the scene that the queries run against
+   px_scene = scene;
+}
+
+
+PxQueryFilterData PhysXSceneQuery::getFilterData(unsigned int groupMask,
+   bool anyHit)
+{
+   PxQueryFilterData   filterData;
+
+   // PhysX skips the shapes whose query filter data shares no bits with
+   // the filter data of the query, unless the query's filter data is zero
+   filterData.data.word0 = groupMask;
+
+   // Consider both static and dynamic actors, letting the pre-filter pass
+   // through the ignored actor
+   filterData.flags = PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC |
+      PxQueryFlag::ePREFILTER;
+
+   // Stop at the first shape found if any shape will do
+   if (anyHit)
+      filterData.flags |= PxQueryFlag::eANY_HIT;
+
+   // Return the filter data
+   return filterData;
+}
+
+
+bool PhysXSceneQuery::getGeometry(unsigned int volume,
+   const PxVec3 & halfExtents, PxGeometryHolder & geometry)
+{
+   // Create the geometry of the given type, as long as its extents are
+   // valid; PhysX rejects volumes without any thickness
+   switch (volume)
+   {
+      case QUERY_VOLUME_SPHERE:
+         if (halfExtents.x <= 0.0f)
+            return false;
+         geometry.storeAny(PxSphereGeometry(halfExtents.x));
+         return true;
+
+      case QUERY_VOLUME_BOX:
+         if (halfExtents.x <= 0.0f || halfExtents.y <= 0.0f ||
+            halfExtents.z <= 0.0f)
+            return false;
+         geometry.storeAny(PxBoxGeometry(halfExtents));
+         return true;
+
+      case QUERY_VOLUME_CAPSULE:
+         if (halfExtents.x <= 0.0f || halfExtents.y <= 0.0f)
+            return false;
+         geometry.storeAny(PxCapsuleGeometry(halfExtents.x, halfExtents.y));
+         return true;
+
+      default:
+         return false;
+   }
+}
+
+
+unsigned int PhysXSceneQuery::getActorID(const PxRigidActor * actor)
+{
+   atInt *   actorID;
+
+   // Use the ID saved in the actor's user data; actors without one, such as
+   // the ground plane, are not being kept track of, so give them the same
+   // default ID that the entity updates use
+   actorID = reinterpret_cast<atInt *>(actor->userData);
+   if (actorID != NULL)
+      return (unsigned int) actorID->getValue();
+   else
+      return 0;
+}
+
+
+void PhysXSceneQuery::writeHit(const PxLocationHit & hit, QueryHit * result)
+{
+   // Report the actor that was hit
+   result->Hit = 1;
+   result->ActorID = getActorID(hit.actor);
+
+   // Report where and how far along the query the hit happened
+   result->PositionX = hit.position.x;
+   result->PositionY = hit.position.y;
+   result->PositionZ = hit.position.z;
+   result->NormalX = hit.normal.x;
+   result->NormalY = hit.normal.y;
+   result->NormalZ = hit.normal.z;
+   result->Distance = hit.distance;
+}
+
+
+void PhysXSceneQuery::writeMiss(QueryHit * result)
+{
+   // Report that nothing was found
+   result->Hit = 0;
+   result->ActorID = 0;
+   result->PositionX = 0.0f;
+   result->PositionY = 0.0f;
+   result->PositionZ = 0.0f;
+   result->NormalX = 0.0f;
+   result->NormalY = 0.0f;
+   result->NormalZ = 0.0f;
+   result->Distance = 0.0f;
+}
+
+
+int PhysXSceneQuery::raycast(const RaycastQuery * queries, int count,
+   QueryHit * results)
+{
+   PxVec3            origin;
+   PxVec3            direction;
+   PxRaycastBuffer   buffer;
+   int               hitCount;
+
+   // Cast each of the rays, reporting the closest shape each one hits
+   hit_type = PxQueryHitType::eBLOCK;
+   hitCount = 0;
+   for (int i = 0; i < count; i++)
+   {
+      // PhysX needs a unit direction, so a ray without a direction can't
+      // hit anything
+      origin = PxVec3(queries[i].OriginX, queries[i].OriginY,
+         queries[i].OriginZ);
+      direction = PxVec3(queries[i].DirectionX, queries[i].DirectionY,
+         queries[i].DirectionZ);
+      if (direction.normalize() <= 0.0f || queries[i].Distance < 0.0f)
+      {
+         writeMiss(&results[i]);
+         continue;
+      }
+
+      // Cast the ray, passing through the actor it ignores
+      ignore_actor_id = queries[i].IgnoreActorID;
+      px_scene->raycast(origin, direction, queries[i].Distance, buffer,
+         PxHitFlags(PxHitFlag::eDEFAULT),
+         getFilterData(queries[i].GroupMask, false), this);
+
+      // Report the result
+      if (buffer.hasBlock)
+      {
+         writeHit(buffer.block, &results[i]);
+         hitCount++;
+      }
+      else
+      {
+         writeMiss(&results[i]);
+      }
+   }
+
+   // Return the number of rays that hit something
+   return hitCount;
+}
+
+
+int PhysXSceneQuery::sweep(const SweepQuery * queries, int count,
+   QueryHit * results)
+{
+   PxGeometryHolder   geometry;
+   PxTransform        pose;
+   PxVec3             direction;
+   PxSweepBuffer      buffer;
+   int                hitCount;
+
+   // Sweep each of the volumes, reporting the closest shape each one hits
+   hit_type = PxQueryHitType::eBLOCK;
+   hitCount = 0;
+   for (int i = 0; i < count; i++)
+   {
+      // Create the volume to be swept, which also needs a direction
+      direction = PxVec3(queries[i].DirectionX, queries[i].DirectionY,
+         queries[i].DirectionZ);
+      if (!getGeometry(queries[i].Volume, PxVec3(queries[i].HalfExtentX,
+         queries[i].HalfExtentY, queries[i].HalfExtentZ), geometry) ||
+         direction.normalize() <= 0.0f || queries[i].Distance < 0.0f)
+      {
+         writeMiss(&results[i]);
+         continue;
+      }
+
+      // Place the volume where the sweep starts; PhysX needs a unit
+      // orientation
+      pose.p = PxVec3(queries[i].PositionX, queries[i].PositionY,
+         queries[i].PositionZ);
+      pose.q = PxQuat(queries[i].RotationX, queries[i].RotationY,
+         queries[i].RotationZ, queries[i].RotationW);
+      if (pose.q.normalize() <= 0.0f)
+         pose.q = PxQuat(PxIdentity);
+
+      // Sweep the volume, passing through the actor it ignores
+      ignore_actor_id = queries[i].IgnoreActorID;
+      px_scene->sweep(geometry.any(), pose, direction, queries[i].Distance,
+         buffer, PxHitFlags(PxHitFlag::eDEFAULT),
+         getFilterData(queries[i].GroupMask, false), this);
+
+      // Report the result
+      if (buffer.hasBlock)
+      {
+         writeHit(buffer.block, &results[i]);
+         hitCount++;
+      }
+      else
+      {
+         writeMiss(&results[i]);
+      }
+   }
+
+   // Return the number of sweeps that hit something
+   return hitCount;
+}
+
+
+int PhysXSceneQuery::overlap(const OverlapQuery * queries, int count,
+   QueryHit * results)
+{
+   PxGeometryHolder   geometry;
+   PxTransform        pose;
+   PxOverlapBuffer    buffer;
+   int                hitCount;
+
+   // Test each of the volumes, stopping at the first shape each one
+   // overlaps; overlaps have no order, so the shapes are reported as
+   // touching rather than blocking
+   hit_type = PxQueryHitType::eTOUCH;
+   hitCount = 0;
+   for (int i = 0; i < count; i++)
+   {
+      // Create the volume to be tested
+      writeMiss(&results[i]);
+      if (!getGeometry(queries[i].Volume, PxVec3(queries[i].HalfExtentX,
+         queries[i].HalfExtentY, queries[i].HalfExtentZ), geometry))
+         continue;
+
+      // Place the volume; PhysX needs a unit orientation
+      pose.p = PxVec3(queries[i].PositionX, queries[i].PositionY,
+         queries[i].PositionZ);
+      pose.q = PxQuat(queries[i].RotationX, queries[i].RotationY,
+         queries[i].RotationZ, queries[i].RotationW);
+      if (pose.q.normalize() <= 0.0f)
+         pose.q = PxQuat(PxIdentity);
+
+      // Test the volume, passing through the actor it ignores; the first
+      // shape found is returned as the blocking hit
+      ignore_actor_id = queries[i].IgnoreActorID;
+      px_scene->overlap(geometry.any(), pose, buffer,
+         getFilterData(queries[i].GroupMask, true), this);
+
+      // Report the actor that the volume overlaps, if any
+      if (buffer.hasBlock)
+      {
+         results[i].Hit = 1;
+         results[i].ActorID = getActorID(buffer.block.actor);
+         hitCount++;
+      }
+   }
+
+   // Return the number of volumes that overlap something
+   return hitCount;
+}
+
+
+PxQueryHitType::Enum PhysXSceneQuery::preFilter(const PxFilterData &,
+   const PxShape *, const PxRigidActor * actor, PxHitFlags &)
+{
+   // Pass through the shapes of the ignored actor
+   if (ignore_actor_id != 0 && getActorID(actor) == ignore_actor_id)
+      return PxQueryHitType::eNONE;
+
+   // Any other shape that got past the group mask is hit
+   return hit_type;
+}
+
+
+PxQueryHitType::Enum PhysXSceneQuery::postFilter(const PxFilterData &,
+   const PxQueryHit &)
+{
+   // Post-filtering is never requested, so keep the hit as it is
+   return hit_type;
+}
+
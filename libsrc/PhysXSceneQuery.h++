@@ -0,0 +1,291 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef PHYSX_SCENE_QUERY_H
+#define PHYSX_SCENE_QUERY_H
+
+#include "PxPhysicsAPI.h"
+
+
+using namespace physx;
+
+
+/// Enumeration of the groups that a shape belongs to for scene queries,
+/// stored as bits in word0 of the shape's query filter data. A query only
+/// considers the shapes that share a bit with its group mask; a mask of zero
+/// considers every shape.
+///
+/// REPORTING marks the shapes of actors whose collisions are reported, the
+/// same actors that have word0 of their simulation filter data set for the
+/// contact filter shader.
+///
+enum QueryGroup
+{
+   QUERY_GROUP_STATIC = 1,
+   QUERY_GROUP_DYNAMIC = 2,
+   QUERY_GROUP_REPORTING = 4
+};
+
+
+/// Enumeration of the volumes that can be swept or tested for overlaps. The
+/// meaning of the half extents depends on the volume:
+///
+/// SPHERE: the radius is HalfExtentX
+/// BOX: the half extents along each of the axes of the box
+/// CAPSULE: the radius is HalfExtentX and the half height HalfExtentY, with
+/// the capsule lying along its x-axis like the capsules of actors
+///
+enum QueryVolume
+{
+   QUERY_VOLUME_SPHERE = 1,
+   QUERY_VOLUME_BOX = 2,
+   QUERY_VOLUME_CAPSULE = 3
+};
+
+
+/// Struct for a ray to cast into the scene. The direction doesn't need to be
+/// normalized. The actor with IgnoreActorID, such as the avatar that casts
+/// the ray, is passed through; zero ignores no actor.
+///
+struct RaycastQuery
+{
+   float          OriginX;
+   float          OriginY;
+   float          OriginZ;
+   float          DirectionX;
+   float          DirectionY;
+   float          DirectionZ;
+   float          Distance;
+   unsigned int   GroupMask;
+   unsigned int   IgnoreActorID;
+};
+
+
+/// Struct for a volume to sweep through the scene, starting at the given
+/// position and orientation. The other fields are as for RaycastQuery.
+///
+struct SweepQuery
+{
+   unsigned int   Volume;
+   float          HalfExtentX;
+   float          HalfExtentY;
+   float          HalfExtentZ;
+   float          PositionX;
+   float          PositionY;
+   float          PositionZ;
+   float          RotationX;
+   float          RotationY;
+   float          RotationZ;
+   float          RotationW;
+   float          DirectionX;
+   float          DirectionY;
+   float          DirectionZ;
+   float          Distance;
+   unsigned int   GroupMask;
+   unsigned int   IgnoreActorID;
+};
+
+
+/// Struct for a volume to test for overlaps with the scene. The fields are as
+/// for SweepQuery.
+///
+struct OverlapQuery
+{
+   unsigned int   Volume;
+   float          HalfExtentX;
+   float          HalfExtentY;
+   float          HalfExtentZ;
+   float          PositionX;
+   float          PositionY;
+   float          PositionZ;
+   float          RotationX;
+   float          RotationY;
+   float          RotationZ;
+   float          RotationW;
+   unsigned int   GroupMask;
+   unsigned int   IgnoreActorID;
+};
+
+
+/// Struct for reporting the result of a query. Hit is non-zero if the query
+/// found a shape, in which case ActorID is the ID of its actor, the same ID
+/// that EntityProperties uses (zero for actors that aren't tracked, such as
+/// the ground plane). Raycasts and sweeps report the closest hit, with the
+/// point and normal of impact and the distance travelled along the
+/// direction; overlaps report any one of the overlapping shapes, without a
+/// point, normal or distance.
+///
+struct QueryHit
+{
+   unsigned int   Hit;
+   unsigned int   ActorID;
+   float          PositionX;
+   float          PositionY;
+   float          PositionZ;
+   float          NormalX;
+   float          NormalY;
+   float          NormalZ;
+   float          Distance;
+};
+
+
+/// Runs batches of raycasts, sweeps and overlap tests against a PhysX scene.
+///
+/// The caller holds the scene's read lock for the whole batch, rather than
+/// for each query. Each batch needs its own instance, as the instance keeps
+/// track of the actor that the current query ignores; several batches can
+/// run at once under the same read lock.
+///
+/// The queries of a batch run one after another on the calling thread. The
+/// batches that OpenSim makes are small (a few rays or volumes per avatar or
+/// script), each query only visits the scene's bounding volume tree for a
+/// few microseconds, and the workers of the scene's CPU dispatcher are busy
+/// with its step whenever one is in flight, so handing the queries to them
+/// would cost more than it saves. Callers with large batches can split them
+/// over their own threads instead, each with its own instance.
+
+class PhysXSceneQuery : public PxQueryFilterCallback
+{
+   protected:
+      /// The scene that the queries run against.
+      ///
+      PxScene *                px_scene;
+
+      /// The ID of the actor that the current query passes through, or
+      /// zero if it doesn't pass through any actor.
+      ///
+      unsigned int             ignore_actor_id;
+
+      /// The kind of hit reported for the shapes that the current query
+      /// doesn't pass through.
+      ///
+      PxQueryHitType::Enum     hit_type;
+
+      /// Creates the filter data of a query from its group mask.
+      ///
+      /// @param groupMask The groups of shapes that the query considers.
+      /// @param anyHit Whether the query can stop at the first hit found.
+      ///
+      /// @return The filter data.
+      ///
+      PxQueryFilterData   getFilterData(unsigned int groupMask, bool anyHit);
+
+      /// Creates the geometry of a swept or tested volume.
+      ///
+      /// @param volume The type of volume, from QueryVolume.
+      /// @param halfExtents The half extents of the volume.
+      /// @param geometry The holder that receives the geometry.
+      ///
+      /// @return False if the volume is unknown or degenerate.
+      ///
+      bool                getGeometry(unsigned int volume,
+                                      const PxVec3 & halfExtents,
+                                      PxGeometryHolder & geometry);
+
+      /// Looks up the ID of an actor in its user data.
+      ///
+      /// @param actor The actor.
+      ///
+      /// @return The ID, or zero if the actor isn't tracked.
+      ///
+      unsigned int        getActorID(const PxRigidActor * actor);
+
+      /// Writes out the hit of a raycast or sweep.
+      ///
+      /// @param hit The hit found by PhysX.
+      /// @param result The result that receives the hit.
+      ///
+      void                writeHit(const PxLocationHit & hit,
+                                   QueryHit * result);
+
+      /// Writes out a query that found nothing.
+      ///
+      /// @param result The result that receives the miss.
+      ///
+      void                writeMiss(QueryHit * result);
+
+   public:
+      /// Constructor. No queries can run until the scene is set.
+      ///
+      PhysXSceneQuery();
+
+      /// Destructor.
+      ///
+      virtual ~PhysXSceneQuery();
+
+      /// Sets the scene that the queries run against.
+      ///
+      /// @param scene The scene.
+      ///
+      void   setScene(PxScene * scene);
+
+      /// Casts a batch of rays.
+      ///
+      /// @param queries The rays to cast.
+      /// @param count The number of rays.
+      /// @param results The array that receives one result per ray.
+      ///
+      /// @return The number of rays that hit a shape.
+      ///
+      int   raycast(const RaycastQuery * queries, int count,
+                    QueryHit * results);
+
+      /// Sweeps a batch of volumes.
+      ///
+      /// @param queries The volumes to sweep.
+      /// @param count The number of volumes.
+      /// @param results The array that receives one result per volume.
+      ///
+      /// @return The number of sweeps that hit a shape.
+      ///
+      int   sweep(const SweepQuery * queries, int count,
+                  QueryHit * results);
+
+      /// Tests a batch of volumes for overlaps.
+      ///
+      /// @param queries The volumes to test.
+      /// @param count The number of volumes.
+      /// @param results The array that receives one result per volume.
+      ///
+      /// @return The number of volumes that overlap a shape.
+      ///
+      int   overlap(const OverlapQuery * queries, int count,
+                    QueryHit * results);
+
+      /// Called by PhysX for each shape that a query may hit, in order to
+      /// pass through the ignored actor.
+      ///
+      virtual PxQueryHitType::Enum   preFilter(
+         const PxFilterData & filterData, const PxShape * shape,
+         const PxRigidActor * actor, PxHitFlags & queryFlags);
+
+      /// Called by PhysX for each hit when post-filtering is requested,
+      /// which it never is.
+      ///
+      virtual PxQueryHitType::Enum   postFilter(
+         const PxFilterData & filterData, const PxQueryHit & hit);
+};
+
+#endif
+
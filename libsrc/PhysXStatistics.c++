@@ -0,0 +1,145 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "PhysXStatistics.h++"
+
+#ifdef _WIN32
+   #include <windows.h>
+#else
+   #include <time.h>
+#endif
+
+
+PhysXHistogram::PhysXHistogram()
+{
+   // The histogram starts out empty
+   reset();
+}
+
+
+unsigned long long PhysXHistogram::getTime()
+{
+   #ifdef _WIN32
+      static LARGE_INTEGER   frequency = { 0 };
+      LARGE_INTEGER          counter;
+
+      // Read the performance counter and convert its ticks to microseconds
+      if (frequency.QuadPart == 0)
+         QueryPerformanceFrequency(&frequency);
+      QueryPerformanceCounter(&counter);
+      return (unsigned long long) (counter.QuadPart /
+         (frequency.QuadPart / 1000000.0));
+   #else
+      struct timespec   now;
+
+      // Read the monotonic clock, which isn't affected by changes to the
+      // time of day
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      return (unsigned long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+   #endif
+}
+
+
+void PhysXHistogram::addSample(unsigned long long duration)
+{
+   unsigned int   bucket;
+   unsigned int   sample;
+   unsigned int   currentMax;
+
+   // Find the bucket of the duration, which is one more than the position
+   // of its highest bit
+   bucket = 0;
+   while (bucket < PHYSX_HISTOGRAM_BUCKETS - 1 && (duration >> bucket) != 0)
+      bucket++;
+
+   // Clamp the duration for the maximum, which only has 32 bits
+   if (duration > 0xFFFFFFFF)
+      sample = 0xFFFFFFFF;
+   else
+      sample = (unsigned int) duration;
+
+   // Count the sample, using atomic operations so that threads adding
+   // samples at the same time don't lose any of them
+   #ifdef _WIN32
+      InterlockedIncrement((volatile LONG *) &sample_count);
+      InterlockedIncrement((volatile LONG *) &bucket_counts[bucket]);
+      InterlockedExchangeAdd64((volatile LONGLONG *) &total_time,
+         (LONGLONG) duration);
+   #else
+      __sync_fetch_and_add(&sample_count, 1);
+      __sync_fetch_and_add(&bucket_counts[bucket], 1);
+      __sync_fetch_and_add(&total_time, duration);
+   #endif
+
+   // Raise the maximum, retrying if another thread changed it in the
+   // meantime
+   do
+   {
+      currentMax = max_time;
+      if (sample <= currentMax)
+         break;
+   }
+   #ifdef _WIN32
+      while ((unsigned int) InterlockedCompareExchange(
+         (volatile LONG *) &max_time, (LONG) sample, (LONG) currentMax) !=
+         currentMax);
+   #else
+      while (__sync_val_compare_and_swap(&max_time, currentMax, sample) !=
+         currentMax);
+   #endif
+}
+
+
+unsigned long long PhysXHistogram::addSampleSince(
+   unsigned long long startTime)
+{
+   unsigned long long   now;
+
+   // Add the time that has passed since the start
+   now = getTime();
+   addSample(now - startTime);
+   return now;
+}
+
+
+void PhysXHistogram::read(TimeHistogram * histogram)
+{
+   // Copy the counts and convert the times to milliseconds
+   histogram->Count = sample_count;
+   histogram->TotalTime = total_time / 1000.0f;
+   histogram->MaxTime = max_time / 1000.0f;
+   for (int i = 0; i < PHYSX_HISTOGRAM_BUCKETS; i++)
+      histogram->Buckets[i] = bucket_counts[i];
+}
+
+
+void PhysXHistogram::reset()
+{
+   // Clear every count
+   sample_count = 0;
+   total_time = 0;
+   max_time = 0;
+   for (int i = 0; i < PHYSX_HISTOGRAM_BUCKETS; i++)
+      bucket_counts[i] = 0;
+}
+
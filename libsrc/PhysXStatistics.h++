@@ -0,0 +1,112 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PHYSX_STATISTICS_H
+#define PHYSX_STATISTICS_H
+
+
+/// The number of buckets in a histogram of durations.
+#define PHYSX_HISTOGRAM_BUCKETS   24
+
+
+/// Struct for reporting the distribution of a duration, such as the time
+/// spent waiting for a lock. Bucket 0 counts the durations shorter than a
+/// microsecond, and bucket i the durations from 2^(i-1) up to 2^i
+/// microseconds; the last bucket also counts everything longer than that.
+/// TotalTime and MaxTime are in milliseconds.
+///
+struct TimeHistogram
+{
+   unsigned int   Count;
+   float          TotalTime;
+   float          MaxTime;
+   unsigned int   Buckets[PHYSX_HISTOGRAM_BUCKETS];
+};
+
+
+/// Histogram of durations with power of two buckets, cheap enough to be
+/// updated all of the time.
+///
+/// Samples are added with atomic operations, so any number of threads may
+/// add to the same histogram without holding a lock. Reading or resetting
+/// the histogram while samples are being added can leave a sample that is
+/// in flight partially counted, which is of no consequence to statistics.
+
+class PhysXHistogram
+{
+   protected:
+      /// The number of samples added since the last reset.
+      ///
+      volatile unsigned int         sample_count;
+
+      /// The sum of the samples, in microseconds.
+      ///
+      volatile unsigned long long   total_time;
+
+      /// The longest sample, in microseconds.
+      ///
+      volatile unsigned int         max_time;
+
+      /// The number of samples that fell into each bucket.
+      ///
+      volatile unsigned int         bucket_counts[PHYSX_HISTOGRAM_BUCKETS];
+
+   public:
+      /// Constructor.
+      ///
+      PhysXHistogram();
+
+      /// Reads a monotonic clock; only the difference between two readings
+      /// is meaningful.
+      ///
+      /// @return The current time in microseconds.
+      ///
+      static unsigned long long   getTime();
+
+      /// Adds a single duration to the histogram.
+      ///
+      /// @param duration The duration in microseconds.
+      ///
+      void   addSample(unsigned long long duration);
+
+      /// Adds the time that has passed since a reading of getTime().
+      ///
+      /// @param startTime The reading of getTime() at the start.
+      ///
+      /// @return The current time, so that it can start the next duration.
+      ///
+      unsigned long long   addSampleSince(unsigned long long startTime);
+
+      /// Copies the histogram to the given struct.
+      ///
+      /// @param histogram The struct that receives the histogram.
+      ///
+      void   read(TimeHistogram * histogram);
+
+      /// Removes every sample from the histogram.
+      ///
+      void   reset();
+};
+
+#endif
+
@@ -0,0 +1,1155 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// Checks of the library. The parts that stand on their own are checked
+/// directly, and the rest through scenes that each check creates for itself
+/// and destroys again. The call recorder is checked by recording a short
+/// session, replaying its call log and comparing the replayed scene with the
+/// recorded one.
+///
+/// Usage: PhysXCheck [scratch directory]
+///
+/// The call log, and any meshes that are cooked, are written to the scratch
+/// directory, which defaults to the current one. Every check prints PASS or
+/// FAIL, and the tool exits with 1 if any of them failed.
+
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "PhysXReplayer.h++"
+
+#include "PhysXActorRegistry.h++"
+#include "PhysXCommandQueue.h++"
+#include "PhysXStatistics.h++"
+
+
+// The length of a simulation step and the number of steps that the checks
+// run for an actor to come to rest
+#define CHECK_STEP_TIME      (1.0f / 60.0f)
+#define CHECK_STEP_COUNT     120
+
+// The sizes of the arrays handed to the library
+#define CHECK_MAX_UPDATES    64
+#define CHECK_MAX_CONTACTS   128
+#define CHECK_MAX_FAILURES   8
+
+// The layout of the terrain: a square of posts, split into tiles that are
+// smaller than the terrain, so that it is built from several height fields
+#define CHECK_TERRAIN_POSTS  17
+#define CHECK_TERRAIN_TILE   5
+
+// The identifiers of the actors in the checks
+#define CHECK_BOX_ID         10
+#define CHECK_OTHER_BOX_ID   11
+#define CHECK_HULL_ID        20
+#define CHECK_OTHER_HULL_ID  21
+#define CHECK_TERRAIN_BOX_ID 30
+#define CHECK_TERRAIN_ID     100
+#define CHECK_MISSING_ID     9999
+
+
+// The arrays handed to the library on behalf of a scene
+struct CheckScene
+{
+   unsigned int          scene_id;
+   EntityProperties      updates[2][CHECK_MAX_UPDATES];
+   CollisionArrays       contact_arrays[2];
+   CollisionProperties   contacts[2][CHECK_MAX_CONTACTS];
+   CommandFailure        failures[CHECK_MAX_FAILURES];
+};
+
+
+static int   passed_checks = 0;
+static int   failed_checks = 0;
+
+
+//-----------------------------------------------------------------------------
+
+
+// Reports the outcome of a single check
+void check(bool passed, const char * description)
+{
+   // Count the check and print its outcome
+   if (passed)
+      passed_checks++;
+   else
+      failed_checks++;
+   printf("%s  %s\n", passed ? "PASS" : "FAIL", description);
+}
+
+
+// Checks whether two values are within the given distance of each other
+bool isClose(float value, float expected, float tolerance)
+{
+   return fabs(value - expected) <= tolerance;
+}
+
+
+// Fills a command buffer with the given commands, returning its size
+int buildCommandBuffer(unsigned char * buffer, ActorCommand * commands,
+   int commandCount)
+{
+   CommandBufferHeader *   header;
+
+   // The header is immediately followed by the commands
+   header = (CommandBufferHeader *) buffer;
+   header->Version = PHYSX_COMMAND_BUFFER_VERSION;
+   header->CommandCount = commandCount;
+   memcpy(&buffer[sizeof(CommandBufferHeader)], commands,
+      commandCount * sizeof(ActorCommand));
+   return sizeof(CommandBufferHeader) + commandCount * sizeof(ActorCommand);
+}
+
+
+// Fills in a single command
+void setCommand(ActorCommand * command, unsigned int actorID,
+   unsigned int opcode, float x, float y, float z)
+{
+   // Only the first three values of the payload are used by these checks
+   memset(command, 0, sizeof(ActorCommand));
+   command->ActorID = actorID;
+   command->Opcode = opcode;
+   command->Data[0] = x;
+   command->Data[1] = y;
+   command->Data[2] = z;
+}
+
+
+// Creates a scene on the CPU and hands it the arrays of a check scene, with
+// the collisions in either layout
+CheckScene * createCheckScene(bool structureOfArrays)
+{
+   CheckScene *        scene;
+   CollisionArrays *   arrays;
+
+   // Create the scene the same way as the replay tool does
+   scene = new CheckScene();
+   memset(scene->contact_arrays, 0, sizeof(scene->contact_arrays));
+   scene->scene_id = createScene(false, true, 2);
+
+   // Hand over the update arrays, and the collision arrays in either layout
+   initEntityUpdateBuffersInScene(scene->scene_id, scene->updates[0],
+      scene->updates[1], CHECK_MAX_UPDATES);
+   if (structureOfArrays)
+   {
+      for (int i = 0; i < 2; i++)
+      {
+         arrays = &scene->contact_arrays[i];
+         arrays->ActorId1 = new unsigned int[CHECK_MAX_CONTACTS];
+         arrays->ActorId2 = new unsigned int[CHECK_MAX_CONTACTS];
+         arrays->PositionX = new float[CHECK_MAX_CONTACTS];
+         arrays->PositionY = new float[CHECK_MAX_CONTACTS];
+         arrays->PositionZ = new float[CHECK_MAX_CONTACTS];
+         arrays->NormalX = new float[CHECK_MAX_CONTACTS];
+         arrays->NormalY = new float[CHECK_MAX_CONTACTS];
+         arrays->NormalZ = new float[CHECK_MAX_CONTACTS];
+         arrays->Penetration = new float[CHECK_MAX_CONTACTS];
+         arrays->Impulse = new float[CHECK_MAX_CONTACTS];
+      }
+      initCollisionArraysUpdateInScene(scene->scene_id,
+         &scene->contact_arrays[0], &scene->contact_arrays[1],
+         CHECK_MAX_CONTACTS);
+   }
+   else
+   {
+      initCollisionUpdateBuffersInScene(scene->scene_id, scene->contacts[0],
+         scene->contacts[1], CHECK_MAX_CONTACTS);
+   }
+
+   // Failures of queued commands are reported as well
+   initCommandFailureUpdateInScene(scene->scene_id, scene->failures,
+      CHECK_MAX_FAILURES);
+   return scene;
+}
+
+
+// Destroys the scene of a check scene, and then releases its arrays
+void destroyCheckScene(CheckScene * scene)
+{
+   CollisionArrays *   arrays;
+
+   // The library must be done with the arrays before they are released
+   destroyScene(scene->scene_id);
+
+   // Release every one of the arrays of the structure of arrays layout,
+   // which are all NULL for the other layout
+   for (int i = 0; i < 2; i++)
+   {
+      arrays = &scene->contact_arrays[i];
+      delete[] arrays->ActorId1;
+      delete[] arrays->ActorId2;
+      delete[] arrays->PositionX;
+      delete[] arrays->PositionY;
+      delete[] arrays->PositionZ;
+      delete[] arrays->NormalX;
+      delete[] arrays->NormalY;
+      delete[] arrays->NormalZ;
+      delete[] arrays->Penetration;
+      delete[] arrays->Impulse;
+   }
+   delete scene;
+}
+
+
+// Runs a number of steps of a check scene, returning the pair of arrays that
+// the last step filled
+int stepCheckScene(CheckScene * scene, int stepCount,
+   unsigned int * entityCount, unsigned int * collisionCount)
+{
+   unsigned int   droppedCount;
+   int            filledBuffer;
+
+   // Step the scene one step at a time
+   filledBuffer = 0;
+   *entityCount = 0;
+   *collisionCount = 0;
+   for (int i = 0; i < stepCount; i++)
+   {
+      beginSimulateInScene(scene->scene_id, CHECK_STEP_TIME);
+      filledBuffer = endSimulateInScene(scene->scene_id, entityCount,
+         collisionCount, &droppedCount);
+   }
+
+   // Fall back to the first pair if a step failed, so that the checks that
+   // look at the arrays fail rather than crash
+   if (filledBuffer < 0)
+      filledBuffer = 0;
+   return filledBuffer;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+// Checks adding, finding and removing actors, including growing the table
+// and removing actors from the middle of runs of occupied slots
+void checkRegistry()
+{
+   PhysXActorRegistry *   registry;
+   char                   actors[200];
+   bool                   allFound;
+   bool                   removedFound;
+   bool                   keptFound;
+
+   // Start with a table much smaller than the number of actors, so that it
+   // has to grow several times; only the addresses of the actors matter, so
+   // the actors are stand-ins that are never dereferenced
+   registry = new PhysXActorRegistry(4);
+   registry->lockWrite();
+   allFound = true;
+   for (int i = 0; i < 200; i++)
+   {
+      if (!registry->addActor(1000 + i, (PhysXRigidActor *) &actors[i]))
+         allFound = false;
+   }
+   check(allFound && registry->getNumActors() == 200,
+      "registry: adds 200 actors while growing");
+
+   // Every actor must be found by its identifier
+   allFound = true;
+   for (int i = 0; i < 200; i++)
+   {
+      if (registry->getActor(1000 + i) != (PhysXRigidActor *) &actors[i])
+         allFound = false;
+   }
+   check(allFound, "registry: finds every actor after growing");
+
+   // Duplicates and NULL actors are refused
+   check(!registry->addActor(1000, (PhysXRigidActor *) &actors[1]) &&
+      !registry->addActor(5000, NULL) && registry->getNumActors() == 200,
+      "registry: refuses duplicate identifiers and NULL actors");
+
+   // Remove every third actor; the others must stay where they can be found
+   for (int i = 0; i < 200; i += 3)
+      registry->removeActor(1000 + i);
+   removedFound = false;
+   keptFound = true;
+   for (int i = 0; i < 200; i++)
+   {
+      if (i % 3 == 0 && registry->containsActor(1000 + i))
+         removedFound = true;
+      if (i % 3 != 0 &&
+          registry->getActor(1000 + i) != (PhysXRigidActor *) &actors[i])
+         keptFound = false;
+   }
+   check(!removedFound && keptFound && registry->getNumActors() == 133,
+      "registry: removing actors leaves the others reachable");
+   check(registry->removeActor(1000) == NULL &&
+      registry->getActor(CHECK_MISSING_ID) == NULL,
+      "registry: missing actors are neither removed nor found");
+
+   // Take the stand-ins back out of the registry, since it deletes the
+   // actors it still holds
+   for (int i = 0; i < 200; i++)
+      registry->removeActor(1000 + i);
+   check(registry->getNumActors() == 0, "registry: empties out");
+   registry->unlockWrite();
+   delete registry;
+}
+
+
+// Checks validating, queueing and taking command buffers, and the failures
+// of commands taken from the queue
+void checkCommandQueue()
+{
+   PhysXCommandQueue    queue;
+   unsigned char        buffer[sizeof(CommandBufferHeader) +
+                           4 * sizeof(ActorCommand)];
+   ActorCommand         commands[4];
+   int                  bufferSize;
+   ActorCommand *       taken;
+   unsigned int         takenCount;
+   CommandFailure       failures[2];
+   CommandFailure *     reported;
+   unsigned int         failureCount;
+
+   // A well formed buffer is valid, while an empty one, one of another
+   // version and one that claims more commands than it holds are not
+   for (int i = 0; i < 4; i++)
+      setCommand(&commands[i], 1 + i, COMMAND_ADD_FORCE, (float) i, 0, 0);
+   bufferSize = buildCommandBuffer(buffer, commands, 4);
+   check(PhysXCommandQueue::validateBuffer(buffer, bufferSize) == 4 &&
+      PhysXCommandQueue::validateBuffer(NULL, 0) == -1 &&
+      PhysXCommandQueue::validateBuffer(buffer, bufferSize - 1) == -1,
+      "command queue: validates the size of buffers");
+   ((CommandBufferHeader *) buffer)->Version = 0;
+   check(PhysXCommandQueue::validateBuffer(buffer, bufferSize) == -1,
+      "command queue: refuses buffers of other versions");
+   ((CommandBufferHeader *) buffer)->Version = PHYSX_COMMAND_BUFFER_VERSION;
+
+   // Queued buffers are taken in the order that they were queued, and the
+   // queue is empty afterwards
+   check(queue.appendBuffer(buffer, bufferSize) &&
+      queue.appendBuffer(buffer, bufferSize) &&
+      !queue.appendBuffer(buffer, 1), "command queue: queues valid buffers");
+   taken = queue.takeCommands(&takenCount);
+   check(takenCount == 8 && taken[0].ActorID == 1 && taken[3].ActorID == 4 &&
+      taken[4].ActorID == 1 && taken[7].Data[0] == 3.0f,
+      "command queue: hands over the commands in order");
+   queue.takeCommands(&takenCount);
+   check(takenCount == 0, "command queue: is empty once taken");
+
+   // Failures beyond the size of the failure array are dropped, and the
+   // failures are only reported once
+   queue.setFailureArray(failures, 2);
+   queue.recordFailure(&commands[0], COMMAND_ACTOR_NOT_FOUND);
+   queue.recordFailure(&commands[1], COMMAND_UNKNOWN_OPCODE);
+   queue.recordFailure(&commands[2], COMMAND_ACTOR_NOT_FOUND);
+   reported = queue.getFailures(&failureCount);
+   check(failureCount == 2 && reported == failures &&
+      failures[0].ActorID == 1 &&
+      failures[0].Status == COMMAND_ACTOR_NOT_FOUND &&
+      failures[1].Status == COMMAND_UNKNOWN_OPCODE,
+      "command queue: reports failures up to the size of the array");
+   queue.getFailures(&failureCount);
+   check(failureCount == 0, "command queue: reports failures once");
+}
+
+
+// Checks that samples land in the power of two buckets and that the totals
+// are kept in milliseconds
+void checkHistogram()
+{
+   PhysXHistogram   histogram;
+   TimeHistogram    result;
+   bool             othersEmpty;
+
+   // Add samples that fall into the first, the last and a few other buckets
+   histogram.addSample(0);
+   histogram.addSample(1);
+   histogram.addSample(3);
+   histogram.addSample(1000);
+   histogram.addSample(1ULL << 40);
+   histogram.read(&result);
+   othersEmpty = true;
+   for (int i = 3; i < PHYSX_HISTOGRAM_BUCKETS - 1; i++)
+   {
+      if (i != 10 && result.Buckets[i] != 0)
+         othersEmpty = false;
+   }
+   check(result.Count == 5 && result.Buckets[0] == 1 &&
+      result.Buckets[1] == 1 && result.Buckets[2] == 1 &&
+      result.Buckets[10] == 1 &&
+      result.Buckets[PHYSX_HISTOGRAM_BUCKETS - 1] == 1 && othersEmpty,
+      "histogram: places samples into power of two buckets");
+   check(isClose(result.MaxTime, 0xFFFFFFFF / 1000.0f, 1.0f) &&
+      result.TotalTime > 1.0e9f,
+      "histogram: keeps the totals in milliseconds");
+
+   // A reset removes every sample
+   histogram.reset();
+   histogram.read(&result);
+   check(result.Count == 0 && result.Buckets[0] == 0 &&
+      result.Buckets[PHYSX_HISTOGRAM_BUCKETS - 1] == 0 &&
+      result.MaxTime == 0.0f, "histogram: empties out on reset");
+}
+
+
+// Checks that the reader of recorded calls stays within a record, however
+// corrupt the counts and sizes in it are
+void checkCallReader()
+{
+   unsigned int   record[4];
+   CallReader *   reader;
+   float *        floats;
+   int *          ints;
+   void *         data;
+   int            count;
+
+   // A count that fits hands out the words that follow it, in place
+   memset(record, 0, sizeof(record));
+   record[0] = 3;
+   reader = new CallReader((unsigned char *) record, sizeof(record));
+   floats = reader->readFloats(&count);
+   check(floats == (float *) &record[1] && count == 3,
+      "call reader: reads arrays within the record");
+   delete reader;
+
+   // A count whose size in bytes wraps around to a small number is refused
+   record[0] = 0x40000001;
+   reader = new CallReader((unsigned char *) record, sizeof(record));
+   floats = reader->readFloats(&count);
+   check(floats == NULL && count == 0,
+      "call reader: refuses counts whose size overflows");
+   delete reader;
+
+   // So are negative counts and counts that run past the end of the record
+   record[0] = 0xFFFFFFFF;
+   reader = new CallReader((unsigned char *) record, sizeof(record));
+   ints = reader->readInts(&count);
+   check(ints == NULL && count == 0,
+      "call reader: refuses negative counts");
+   delete reader;
+   record[0] = 4;
+   reader = new CallReader((unsigned char *) record, sizeof(record));
+   ints = reader->readInts(&count);
+   check(ints == NULL && count == 0,
+      "call reader: refuses counts past the end of the record");
+   delete reader;
+
+   // A block whose size would wrap the read offset around is refused too
+   record[0] = 0xFFFFFFFE;
+   reader = new CallReader((unsigned char *) record, sizeof(record));
+   data = reader->readData(&count);
+   check(data == NULL && count == 0,
+      "call reader: refuses blocks whose size wraps around");
+   delete reader;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+// Checks applying commands right away, and queueing them while a step is in
+// flight, along with the failures they report
+void checkCommands()
+{
+   CheckScene *     scene;
+   unsigned char    buffer[sizeof(CommandBufferHeader) +
+                       3 * sizeof(ActorCommand)];
+   ActorCommand     commands[3];
+   int              bufferSize;
+   unsigned int     results[3];
+   ActorPosition    position;
+   unsigned int     entityCount;
+   unsigned int     collisionCount;
+   unsigned int     droppedCount;
+   unsigned int     failureCount;
+   bool             queued;
+
+   // Create a scene with a single box
+   scene = createCheckScene(false);
+   createActorBoxInScene(scene->scene_id, CHECK_BOX_ID, (char *) "box", 0.0f,
+      0.0f, 2.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true, true);
+
+   // Apply a batch of commands right away: one that succeeds, one for a
+   // missing actor and one that isn't known
+   setCommand(&commands[0], CHECK_BOX_ID, COMMAND_SET_POSITION, 3.0f, 0.0f,
+      4.0f);
+   setCommand(&commands[1], CHECK_MISSING_ID, COMMAND_SET_POSITION, 0.0f,
+      0.0f, 0.0f);
+   setCommand(&commands[2], CHECK_BOX_ID, 99, 0.0f, 0.0f, 0.0f);
+   bufferSize = buildCommandBuffer(buffer, commands, 3);
+   check(applyCommandsInScene(scene->scene_id, buffer, bufferSize,
+      results) == 2 && results[0] == COMMAND_SUCCEEDED &&
+      results[1] == COMMAND_ACTOR_NOT_FOUND &&
+      results[2] == COMMAND_UNKNOWN_OPCODE,
+      "commands: report the outcome of every command");
+   position = getPositionInScene(scene->scene_id, CHECK_BOX_ID);
+   check(isClose(position.x, 3.0f, 0.001f) &&
+      isClose(position.z, 4.0f, 0.001f), "commands: are applied right away");
+   check(applyCommandsInScene(scene->scene_id, buffer, 1, results) == -1,
+      "commands: malformed buffers are refused");
+
+   // Queue a command for a missing actor while a step is in flight; it is
+   // applied, and fails, when the next step begins
+   beginSimulateInScene(scene->scene_id, CHECK_STEP_TIME);
+   setCommand(&commands[0], CHECK_MISSING_ID, COMMAND_ADD_FORCE, 1.0f, 0.0f,
+      0.0f);
+   bufferSize = buildCommandBuffer(buffer, commands, 1);
+   queued = queueCommandsInScene(scene->scene_id, buffer, bufferSize);
+   endSimulateInScene(scene->scene_id, &entityCount, &collisionCount,
+      &droppedCount);
+   stepCheckScene(scene, 1, &entityCount, &collisionCount);
+   getCommandFailuresInScene(scene->scene_id, &failureCount);
+   check(queued && failureCount == 1 &&
+      scene->failures[0].ActorID == CHECK_MISSING_ID &&
+      scene->failures[0].Status == COMMAND_ACTOR_NOT_FOUND,
+      "commands: queued commands report their failures");
+   destroyCheckScene(scene);
+}
+
+
+// Checks that the given actor was updated by a step, and is falling
+bool isFalling(EntityProperties * updates, unsigned int entityCount,
+   unsigned int id, float startHeight)
+{
+   // Look for the actor among the updates
+   for (unsigned int i = 0; i < entityCount; i++)
+   {
+      if (updates[i].ID == id)
+         return updates[i].PositionZ < startHeight &&
+            updates[i].VelocityZ < 0.0f;
+   }
+   return false;
+}
+
+
+// Checks stepping a scene asynchronously: one step at a time, with the
+// results of each step written to the other pair of arrays
+void checkSimulate()
+{
+   CheckScene *   scene;
+   unsigned int   entityCount;
+   unsigned int   collisionCount;
+   unsigned int   droppedCount;
+   int            filledBuffer;
+   bool           alternating;
+   bool           falling;
+
+   // Drop a box onto a ground plane
+   scene = createCheckScene(false);
+   createGroundPlaneInScene(scene->scene_id, 0.0f, 0.0f, 0.0f);
+   createActorBoxInScene(scene->scene_id, CHECK_BOX_ID, (char *) "box", 0.0f,
+      0.0f, 2.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true, true);
+
+   // The first step fills the first pair of arrays, the next one the other
+   alternating = true;
+   falling = false;
+   for (int step = 0; step < CHECK_STEP_COUNT; step++)
+   {
+      beginSimulateInScene(scene->scene_id, CHECK_STEP_TIME);
+
+      // While a step is in flight, another one can't be begun
+      if (step == 0)
+      {
+         check(!beginSimulateInScene(scene->scene_id, CHECK_STEP_TIME),
+            "simulate: one step at a time");
+      }
+
+      // Finish the step
+      filledBuffer = endSimulateInScene(scene->scene_id, &entityCount,
+         &collisionCount, &droppedCount);
+      if (filledBuffer != step % 2)
+      {
+         alternating = false;
+         filledBuffer = 0;
+      }
+      if (step == 10)
+      {
+         falling = isFalling(scene->updates[filledBuffer], entityCount,
+            CHECK_BOX_ID, 2.0f);
+      }
+   }
+   check(alternating, "simulate: alternates between the pairs of arrays");
+   check(falling, "simulate: falling actors are updated");
+
+   // The box is resting on the ground by now
+   check(isClose(getPositionInScene(scene->scene_id, CHECK_BOX_ID).z, 0.5f,
+      0.05f), "simulate: actors come to rest on the ground");
+   destroyCheckScene(scene);
+}
+
+
+// Checks the collisions that a step wrote in the structure of arrays
+// layout, in which every pair of actors is reported once, whichever order
+// its actors were reported in
+void checkAggregateContacts(CollisionArrays * arrays,
+   unsigned int collisionCount, unsigned int id)
+{
+   bool    normalsValid;
+   bool    pairsUnique;
+   bool    actorFound;
+   float   length;
+
+   // Every normal is the normalized average of the normals of a pair, and
+   // every pair appears only once
+   normalsValid = true;
+   pairsUnique = true;
+   actorFound = false;
+   for (unsigned int i = 0; i < collisionCount; i++)
+   {
+      length = sqrt(arrays->NormalX[i] * arrays->NormalX[i] +
+         arrays->NormalY[i] * arrays->NormalY[i] +
+         arrays->NormalZ[i] * arrays->NormalZ[i]);
+      if (!isClose(length, 1.0f, 0.001f) || arrays->Impulse[i] < 0.0f)
+         normalsValid = false;
+      for (unsigned int j = 0; j < i; j++)
+      {
+         if ((arrays->ActorId1[i] == arrays->ActorId1[j] &&
+              arrays->ActorId2[i] == arrays->ActorId2[j]) ||
+             (arrays->ActorId1[i] == arrays->ActorId2[j] &&
+              arrays->ActorId2[i] == arrays->ActorId1[j]))
+            pairsUnique = false;
+      }
+      if (arrays->ActorId1[i] == id || arrays->ActorId2[i] == id)
+         actorFound = true;
+   }
+   check(collisionCount > 0 && actorFound,
+      "collisions: resting actors are reported");
+   check(normalsValid, "collisions: aggregated normals are unit length");
+   check(pairsUnique, "collisions: aggregated pairs are reported once");
+}
+
+
+// Checks the collisions that a step wrote as an array of collision
+// properties, with a record for every contact point
+void checkPointContacts(CollisionProperties * contacts,
+   unsigned int collisionCount, unsigned int id)
+{
+   unsigned int   actorPoints;
+
+   // A box resting on the ground touches it at several points
+   actorPoints = 0;
+   for (unsigned int i = 0; i < collisionCount; i++)
+   {
+      if (contacts[i].ActorId1 == id || contacts[i].ActorId2 == id)
+         actorPoints++;
+   }
+   check(actorPoints > 1, "collisions: every contact point is reported");
+}
+
+
+// Checks gathering the collisions of a step in both report modes and both
+// layouts
+void checkCollisions()
+{
+   CheckScene *   scene;
+   unsigned int   entityCount;
+   unsigned int   collisionCount;
+   int            filledBuffer;
+
+   // Aggregate the contacts of a stack of two boxes in the structure of
+   // arrays layout, and refuse unknown modes
+   scene = createCheckScene(true);
+   setCollisionReportModeInScene(scene->scene_id, COLLISION_REPORT_AGGREGATE);
+   setCollisionReportModeInScene(scene->scene_id, 7);
+   createGroundPlaneInScene(scene->scene_id, 0.0f, 0.0f, 0.0f);
+   createActorBoxInScene(scene->scene_id, CHECK_BOX_ID, (char *) "box", 0.0f,
+      0.0f, 0.5f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true, true);
+   createActorBoxInScene(scene->scene_id, CHECK_OTHER_BOX_ID, (char *) "box",
+      0.0f, 0.0f, 1.5f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true,
+      true);
+   filledBuffer = stepCheckScene(scene, CHECK_STEP_COUNT, &entityCount,
+      &collisionCount);
+   checkAggregateContacts(&scene->contact_arrays[filledBuffer],
+      collisionCount, CHECK_BOX_ID);
+   destroyCheckScene(scene);
+
+   // Report every contact point of a box as an array of collision properties
+   scene = createCheckScene(false);
+   createGroundPlaneInScene(scene->scene_id, 0.0f, 0.0f, 0.0f);
+   createActorBoxInScene(scene->scene_id, CHECK_BOX_ID, (char *) "box", 0.0f,
+      0.0f, 2.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true, true);
+   filledBuffer = stepCheckScene(scene, CHECK_STEP_COUNT, &entityCount,
+      &collisionCount);
+   checkPointContacts(scene->contacts[filledBuffer], collisionCount,
+      CHECK_BOX_ID);
+   destroyCheckScene(scene);
+}
+
+
+// Fills in the corners of a unit cube centred on the origin, which is the
+// convex hull used by the checks of the mesh cache
+void buildHullVertices(float * vertices)
+{
+   // Each bit of the index of a corner picks the side along one axis
+   for (int i = 0; i < 8; i++)
+   {
+      vertices[i * 3] = (i & 1) ? 0.5f : -0.5f;
+      vertices[i * 3 + 1] = (i & 2) ? 0.5f : -0.5f;
+      vertices[i * 3 + 2] = (i & 4) ? 0.5f : -0.5f;
+   }
+}
+
+
+// Checks that identical meshes share one cooked mesh, that meshes that are
+// no longer used are purged, and that purged meshes come back from the
+// cache directory when they are used again
+void checkMeshCache(char * cacheDirectory)
+{
+   unsigned int          sceneID;
+   float                 hullVertices[24];
+   MeshCacheStatistics   before;
+   MeshCacheStatistics   after;
+
+   // Attach the same convex hull to two actors; the second one must share
+   // the mesh cooked for the first, which may already be in the directory
+   // from an earlier run
+   setMeshCacheDirectory(cacheDirectory);
+   buildHullVertices(hullVertices);
+   sceneID = createScene(false, true, 1);
+   getMeshCacheStatistics(&before);
+   createActorInScene(sceneID, CHECK_HULL_ID, (char *) "hull", 0.0f, 0.0f,
+      2.0f, true, false);
+   attachConvexMeshInScene(sceneID, CHECK_HULL_ID, 1, 0.5f, 0.5f, 0.0f,
+      hullVertices, 8, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f);
+   createActorInScene(sceneID, CHECK_OTHER_HULL_ID, (char *) "hull", 3.0f,
+      0.0f, 2.0f, true, false);
+   attachConvexMeshInScene(sceneID, CHECK_OTHER_HULL_ID, 1, 0.5f, 0.5f, 0.0f,
+      hullVertices, 8, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f);
+   getMeshCacheStatistics(&after);
+   check((after.Misses - before.Misses) +
+      (after.DiskHits - before.DiskHits) == 1 &&
+      after.Hits - before.Hits == 1,
+      "mesh cache: identical hulls share one cooked mesh");
+
+   // Once the scene is gone, no shape uses the hull anymore, so it can be
+   // purged
+   destroyScene(sceneID);
+   check(purgeMeshCache() > 0, "mesh cache: purges unused meshes");
+
+   // The purged hull was written to the directory, so using it again loads
+   // it instead of cooking it
+   sceneID = createScene(false, true, 1);
+   getMeshCacheStatistics(&before);
+   createActorInScene(sceneID, CHECK_HULL_ID, (char *) "hull", 0.0f, 0.0f,
+      2.0f, true, false);
+   attachConvexMeshInScene(sceneID, CHECK_HULL_ID, 1, 0.5f, 0.5f, 0.0f,
+      hullVertices, 8, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f);
+   getMeshCacheStatistics(&after);
+   check(after.DiskHits - before.DiskHits == 1 &&
+      after.Misses == before.Misses,
+      "mesh cache: reloads persisted meshes");
+   destroyScene(sceneID);
+}
+
+
+// Casts a ray straight down onto the scene, returning the query result
+QueryHit castDown(unsigned int sceneID, float x, float y,
+   unsigned int groupMask, unsigned int ignoreID)
+{
+   RaycastQuery   ray;
+   QueryHit       hit;
+
+   // Cast from high above everything in the scene
+   ray.OriginX = x;
+   ray.OriginY = y;
+   ray.OriginZ = 50.0f;
+   ray.DirectionX = 0.0f;
+   ray.DirectionY = 0.0f;
+   ray.DirectionZ = -1.0f;
+   ray.Distance = 100.0f;
+   ray.GroupMask = groupMask;
+   ray.IgnoreActorID = ignoreID;
+   memset(&hit, 0, sizeof(hit));
+   runSceneQueriesInScene(sceneID, &ray, 1, &hit, NULL, 0, NULL, NULL, 0,
+      NULL);
+   return hit;
+}
+
+
+// Checks building a terrain from several tiles, patching it across the
+// edges of the tiles while a step is in flight, and that the shapes of the
+// tiles can't be removed on their own
+void checkHeightField()
+{
+   CheckScene *   scene;
+   unsigned int   allGroups;
+   float *        posts;
+   float          patch[9];
+   unsigned int   entityCount;
+   unsigned int   collisionCount;
+   unsigned int   droppedCount;
+   bool           patched;
+   QueryHit       hit;
+
+   // Build a flat terrain that is split into several tiles, with a box
+   // above it
+   allGroups = QUERY_GROUP_STATIC | QUERY_GROUP_DYNAMIC |
+      QUERY_GROUP_REPORTING;
+   scene = createCheckScene(false);
+   setHeightFieldTileSizeInScene(scene->scene_id, CHECK_TERRAIN_TILE);
+   posts = new float[CHECK_TERRAIN_POSTS * CHECK_TERRAIN_POSTS];
+   for (int i = 0; i < CHECK_TERRAIN_POSTS * CHECK_TERRAIN_POSTS; i++)
+      posts[i] = 1.0f;
+   setHeightFieldInScene(scene->scene_id, CHECK_TERRAIN_ID, 1,
+      CHECK_TERRAIN_POSTS, CHECK_TERRAIN_POSTS, 1.0f, 1.0f, posts, 0.0f);
+   createActorBoxInScene(scene->scene_id, CHECK_TERRAIN_BOX_ID,
+      (char *) "box", 12.0f, 12.0f, 3.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f,
+      0.5f, 1.0f, true, true);
+
+   // Patch a square across the edges of the first tiles while the first
+   // step is in flight; the patch is applied when the next step begins
+   beginSimulateInScene(scene->scene_id, CHECK_STEP_TIME);
+   for (int i = 0; i < 9; i++)
+      patch[i] = 2.0f;
+   patched = updateHeightFieldInScene(scene->scene_id, CHECK_TERRAIN_ID, 3,
+      3, 3, 3, patch);
+   endSimulateInScene(scene->scene_id, &entityCount, &collisionCount,
+      &droppedCount);
+   stepCheckScene(scene, CHECK_STEP_COUNT, &entityCount, &collisionCount);
+
+   // Every tile of the terrain is in place, including the patch
+   hit = castDown(scene->scene_id, 14.5f, 1.5f, allGroups, 0);
+   check(hit.Hit != 0 && hit.ActorID == CHECK_TERRAIN_ID &&
+      isClose(hit.PositionZ, 1.0f, 0.05f) &&
+      castDown(scene->scene_id, 1.5f, 14.5f, allGroups, 0).Hit != 0 &&
+      castDown(scene->scene_id, 8.5f, 8.5f, allGroups, 0).Hit != 0,
+      "height field: every tile is built");
+   hit = castDown(scene->scene_id, 3.5f, 3.5f, allGroups, 0);
+   check(patched && hit.Hit != 0 && isClose(hit.PositionZ, 2.0f, 0.05f) &&
+      isClose(castDown(scene->scene_id, 4.5f, 4.5f, allGroups,
+      0).PositionZ, 2.0f, 0.05f),
+      "height field: patches are applied across tiles");
+   check(isClose(getPositionInScene(scene->scene_id,
+      CHECK_TERRAIN_BOX_ID).z, 1.5f, 0.05f),
+      "height field: actors come to rest on the terrain");
+
+   // The shapes of the tiles belong to the terrain, so removing them on
+   // their own is refused, and the tiles can still be patched afterwards
+   removeShapeInScene(scene->scene_id, CHECK_TERRAIN_ID, 1);
+   removeShapeInScene(scene->scene_id, CHECK_TERRAIN_ID, 2);
+   for (int i = 0; i < 9; i++)
+      patch[i] = 3.0f;
+   patched = updateHeightFieldInScene(scene->scene_id, CHECK_TERRAIN_ID, 0,
+      0, 3, 3, patch);
+   hit = castDown(scene->scene_id, 1.5f, 1.5f, allGroups, 0);
+   check(patched && hit.Hit != 0 && hit.ActorID == CHECK_TERRAIN_ID &&
+      isClose(hit.PositionZ, 3.0f, 0.05f),
+      "height field: tiles can't be removed on their own");
+   destroyCheckScene(scene);
+   delete[] posts;
+}
+
+
+// Checks that every scene gets a handle of its own, and that calls on
+// handles that don't belong to a created scene do nothing; this has to run
+// before any other scene is created, so that the default scene is still
+// waiting to be created
+void checkSceneHandles()
+{
+   unsigned char    buffer[sizeof(CommandBufferHeader) +
+                       sizeof(ActorCommand)];
+   ActorCommand     command;
+   int              bufferSize;
+   unsigned int     result;
+   ActorPosition    position;
+   unsigned int     entityCount;
+   unsigned int     collisionCount;
+   unsigned int     droppedCount;
+   unsigned int     firstID;
+   unsigned int     secondID;
+   unsigned int     unknownID;
+
+   // Calls to the single-scene API reserve the default scene, but there is
+   // nothing for them to operate on until it has been created
+   setCommand(&command, CHECK_BOX_ID, COMMAND_SET_POSITION, 1.0f, 2.0f,
+      3.0f);
+   bufferSize = buildCommandBuffer(buffer, &command, 1);
+   position.x = 1.0f;
+   position.y = 2.0f;
+   position.z = 3.0f;
+   createGroundPlane(0.0f, 0.0f, 0.0f);
+   releaseGroundPlane();
+   setPosition(CHECK_BOX_ID, position);
+   check(!beginSimulate(CHECK_STEP_TIME) && !pollSimulate() &&
+      endSimulate(&entityCount, &collisionCount, &droppedCount) == -1 &&
+      applyCommands(buffer, bufferSize, &result) == -1 &&
+      getPosition(CHECK_BOX_ID).z == 0.0f,
+      "scenes: calls before the scene is created do nothing");
+
+   // Every scene gets a handle of its own
+   firstID = createScene(false, true, 1);
+   secondID = createScene(false, true, 1);
+   check(firstID != 0 && secondID != 0 && firstID != secondID,
+      "scenes: get distinct handles");
+
+   // Calls on a handle that was never handed out do nothing
+   unknownID = firstID + secondID + 100;
+   destroyScene(unknownID);
+   check(!beginSimulateInScene(unknownID, CHECK_STEP_TIME),
+      "scenes: unknown handles are refused");
+
+   // Destroyed scenes stop accepting calls
+   destroyScene(firstID);
+   destroyScene(secondID);
+   check(!beginSimulateInScene(firstID, CHECK_STEP_TIME) &&
+      !beginSimulateInScene(secondID, CHECK_STEP_TIME),
+      "scenes: destroyed handles are refused");
+}
+
+
+// Records a short session of a scene with two boxes falling onto a ground
+// plane, replays its call log and checks that the replayed scene ends up the
+// way the recorded one did
+void checkRecorder(char * logPath, char * notLogPath)
+{
+   CheckScene *      scene;
+   unsigned int      actorIDs[2];
+   ActorPosition     recorded[2];
+   unsigned int      entityCount;
+   unsigned int      collisionCount;
+   PhysXReplayer *   replayer;
+   FILE *            notLog;
+   unsigned int      replayedID;
+   ActorPosition     position;
+   bool              positionsMatch;
+
+   // Start recording before the scene is created, so that the whole session
+   // can be replayed
+   check(startRecording(logPath), "recorder: starts a call log");
+   scene = createCheckScene(false);
+   createGroundPlaneInScene(scene->scene_id, 0.0f, 0.0f, 0.0f);
+   createActorBoxInScene(scene->scene_id, CHECK_BOX_ID, (char *) "box", 0.0f,
+      0.0f, 2.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true, true);
+   createActorBoxInScene(scene->scene_id, CHECK_OTHER_BOX_ID, (char *) "box",
+      0.25f, 0.0f, 4.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true,
+      true);
+   stepCheckScene(scene, CHECK_STEP_COUNT, &entityCount, &collisionCount);
+
+   // Keep the final positions of the boxes, and finish the call log
+   actorIDs[0] = CHECK_BOX_ID;
+   actorIDs[1] = CHECK_OTHER_BOX_ID;
+   for (int i = 0; i < 2; i++)
+      recorded[i] = getPositionInScene(scene->scene_id, actorIDs[i]);
+   stopRecording();
+
+   // Files that aren't call logs are refused
+   replayer = new PhysXReplayer();
+   notLog = fopen(notLogPath, "wb");
+   if (notLog != NULL)
+   {
+      fprintf(notLog, "not a call log\n");
+      fclose(notLog);
+   }
+   check(replayer->replayLog(notLogPath) == -1,
+      "replay: refuses files that aren't call logs");
+   remove(notLogPath);
+
+   // Replay the session, whose scene gets a handle of its own
+   check(replayer->replayLog(logPath) > 0, "replay: replays the call log");
+   replayedID = replayer->getSceneID(scene->scene_id);
+   check(replayedID != 0 && replayedID != scene->scene_id,
+      "replay: the recorded scene maps to a new scene");
+   check(replayer->getFrameTimings().size() == CHECK_STEP_COUNT,
+      "replay: replays every step");
+
+   // The boxes must end up where they did in the recorded session
+   positionsMatch = true;
+   for (int i = 0; i < 2; i++)
+   {
+      position = getPositionInScene(replayedID, actorIDs[i]);
+      if (!isClose(position.x, recorded[i].x, 0.01f) ||
+          !isClose(position.y, recorded[i].y, 0.01f) ||
+          !isClose(position.z, recorded[i].z, 0.01f))
+      {
+         printf("      actor %u replayed at (%f, %f, %f), recorded at "
+            "(%f, %f, %f)\n", actorIDs[i], position.x, position.y,
+            position.z, recorded[i].x, recorded[i].y, recorded[i].z);
+         positionsMatch = false;
+      }
+   }
+   check(positionsMatch, "replay: actors end up where they were recorded");
+
+   // The replayed scene is destroyed before the replayer releases its arrays
+   destroyScene(replayedID);
+   delete replayer;
+   destroyCheckScene(scene);
+   remove(logPath);
+}
+
+
+// Checks the statistics of a scene, including that resetting them doesn't
+// touch the statistics of another scene
+void checkStatistics()
+{
+   CheckScene *        scene;
+   unsigned int        otherID;
+   float               posts[25];
+   unsigned int        entityCount;
+   unsigned int        collisionCount;
+   PhysicsStatistics   statistics;
+
+   // Build a small terrain in each of two scenes, which counts as cooking
+   // for that scene, and drop a box onto the terrain of the first
+   for (int i = 0; i < 25; i++)
+      posts[i] = 1.0f;
+   scene = createCheckScene(false);
+   otherID = createScene(false, true, 1);
+   setHeightFieldInScene(scene->scene_id, CHECK_TERRAIN_ID, 1, 5, 5, 1.0f,
+      1.0f, posts, 0.0f);
+   setHeightFieldInScene(otherID, CHECK_TERRAIN_ID, 1, 5, 5, 1.0f, 1.0f,
+      posts, 0.0f);
+   createActorBoxInScene(scene->scene_id, CHECK_BOX_ID, (char *) "box", 2.0f,
+      2.0f, 3.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true, true);
+   stepCheckScene(scene, CHECK_STEP_COUNT, &entityCount, &collisionCount);
+
+   // The statistics cover every step, until they are reset
+   getStatisticsInScene(scene->scene_id, &statistics, true);
+   check(statistics.SimulateTime.Count == CHECK_STEP_COUNT &&
+      statistics.FetchTime.Count == CHECK_STEP_COUNT &&
+      statistics.CollisionTime.Count == CHECK_STEP_COUNT &&
+      statistics.ActorCount == 2 && statistics.ContactPairs > 0,
+      "statistics: cover every step of the scene");
+   check(statistics.RegistryWaitTime.Count > 0 &&
+      statistics.SceneWaitTime.Count > 0 && statistics.CookTime.Count == 1,
+      "statistics: cover the locks and cooking");
+   getStatisticsInScene(scene->scene_id, &statistics, false);
+   check(statistics.SimulateTime.Count == 0 &&
+      statistics.FetchTime.Buckets[0] == 0 &&
+      statistics.CookTime.Count == 0,
+      "statistics: start a new window when reset");
+
+   // Resetting the first scene left the cooking of the other one alone
+   getStatisticsInScene(otherID, &statistics, false);
+   check(statistics.CookTime.Count == 1,
+      "statistics: cooking is counted per scene");
+   destroyScene(otherID);
+   destroyCheckScene(scene);
+}
+
+
+// Checks that rays report the actor they hit, pass through the ignored
+// actor and only consider the groups of their mask, and that overlaps find
+// the actors they touch
+void checkQueries()
+{
+   CheckScene *     scene;
+   unsigned int     allGroups;
+   unsigned int     entityCount;
+   unsigned int     collisionCount;
+   QueryHit         hit;
+   OverlapQuery     overlaps[2];
+   QueryHit         overlapHits[2];
+
+   // Let two boxes come to rest on a ground plane
+   allGroups = QUERY_GROUP_STATIC | QUERY_GROUP_DYNAMIC |
+      QUERY_GROUP_REPORTING;
+   scene = createCheckScene(false);
+   createGroundPlaneInScene(scene->scene_id, 0.0f, 0.0f, 0.0f);
+   createActorBoxInScene(scene->scene_id, CHECK_BOX_ID, (char *) "box", 0.0f,
+      0.0f, 2.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true, true);
+   createActorBoxInScene(scene->scene_id, CHECK_OTHER_BOX_ID, (char *) "box",
+      3.0f, 0.0f, 2.0f, 1, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, true,
+      true);
+   stepCheckScene(scene, CHECK_STEP_COUNT, &entityCount, &collisionCount);
+
+   // Rays report the actor they hit, with the point and normal of impact
+   hit = castDown(scene->scene_id, 0.0f, 0.0f, allGroups, 0);
+   check(hit.Hit != 0 && hit.ActorID == CHECK_BOX_ID &&
+      isClose(hit.PositionZ, 1.0f, 0.05f) && isClose(hit.NormalZ, 1.0f, 0.01f),
+      "queries: rays report the actor they hit");
+   check(castDown(scene->scene_id, 0.0f, 0.0f, QUERY_GROUP_DYNAMIC,
+      CHECK_BOX_ID).Hit == 0 &&
+      castDown(scene->scene_id, 0.0f, 0.0f, QUERY_GROUP_STATIC,
+      0).ActorID != CHECK_BOX_ID,
+      "queries: rays honour the ignored actor and the group mask");
+
+   // Overlaps find the actor at their position, and nothing far away
+   memset(overlaps, 0, sizeof(overlaps));
+   for (int i = 0; i < 2; i++)
+   {
+      overlaps[i].Volume = QUERY_VOLUME_SPHERE;
+      overlaps[i].HalfExtentX = 0.25f;
+      overlaps[i].RotationW = 1.0f;
+      overlaps[i].GroupMask = allGroups;
+   }
+   overlaps[0].PositionX = 3.0f;
+   overlaps[0].PositionZ = 0.5f;
+   overlaps[1].PositionX = 50.0f;
+   overlaps[1].PositionZ = 50.0f;
+   check(runSceneQueriesInScene(scene->scene_id, NULL, 0, NULL, NULL, 0,
+      NULL, overlaps, 2, overlapHits) == 1 &&
+      overlapHits[0].ActorID == CHECK_OTHER_BOX_ID && overlapHits[1].Hit == 0,
+      "queries: overlaps report the actors they touch");
+   destroyCheckScene(scene);
+}
+
+
+int main(int argc, char * argv[])
+{
+   const char *   scratchDirectory;
+   char           logPath[1024];
+   char           notLogPath[1024];
+   char           cacheDirectory[1024];
+
+   // Parse the command line
+   scratchDirectory = ".";
+   if (argc > 2)
+   {
+      printf("Usage: PhysXCheck [scratch directory]\n");
+      return 1;
+   }
+   if (argc > 1)
+      scratchDirectory = argv[1];
+   snprintf(logPath, sizeof(logPath), "%s/PhysXCheck.log", scratchDirectory);
+   snprintf(notLogPath, sizeof(notLogPath), "%s/PhysXCheck.txt",
+      scratchDirectory);
+   snprintf(cacheDirectory, sizeof(cacheDirectory), "%s", scratchDirectory);
+
+   // Check the parts that stand on their own
+   checkRegistry();
+   checkCommandQueue();
+   checkHistogram();
+   checkCallReader();
+
+   // Initialize the library the same way as the simulator does
+   if (initialize() == 0)
+   {
+      printf("Unable to initialize the PhysX wrapper.\n");
+      return 1;
+   }
+
+   // Check the scene handles while the default scene is still waiting to be
+   // created
+   checkSceneHandles();
+
+   // Check the rest of the library through scenes of its own
+   checkRecorder(logPath, notLogPath);
+   checkCommands();
+   checkSimulate();
+   checkCollisions();
+   checkMeshCache(cacheDirectory);
+   checkHeightField();
+   checkStatistics();
+   checkQueries();
+   release();
+
+   // Summarize the checks
+   printf("\n%d checks passed, %d failed\n", passed_checks, failed_checks);
+   return failed_checks > 0 ? 1 : 0;
+}
+
@@ -0,0 +1,197 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// Microbenchmark of the actor lookup that every exported call does. It
+/// compares the atMap path that the library used to take (allocating an
+/// atInt key for every lookup, under a mutex) with the PhysXActorRegistry
+/// that replaced it (no allocation, under the shared lock).
+///
+/// Usage: PhysXLookupBenchmark [actor count] [lookup count]
+///
+/// The actors are given sequential IDs, like the local IDs handed out by the
+/// simulator, and are looked up in a scattered order, so that neither path
+/// benefits from walking the table in order.
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "PhysXActorRegistry.h++"
+
+#include "atInt.h++"
+#include "atMap.h++"
+#include "atTimer.h++"
+
+#include "pthread.h"
+
+
+// The number of actors and lookups used when none are given
+#define BENCHMARK_DEFAULT_ACTORS    20000
+#define BENCHMARK_DEFAULT_LOOKUPS   10000000
+
+
+// The first actor ID, chosen to resemble the local IDs of the simulator
+#define BENCHMARK_FIRST_ID          1000
+
+
+// Looks up each of the IDs through the atMap path that the library used to
+// take, returning a value that depends on every result so that the lookups
+// can't be optimized away
+unsigned long benchmarkMap(atMap * actorMap, pthread_mutex_t * mapMutex,
+   unsigned int * lookupIDs, int lookupCount)
+{
+   atInt *          searchID;
+   atItem *         result;
+   unsigned long    checksum;
+
+   // Look up each of the IDs the way the old getActor did, including the
+   // mutex that every exported call took around it
+   checksum = 0;
+   for (int i = 0; i < lookupCount; i++)
+   {
+      pthread_mutex_lock(mapMutex);
+      searchID = new atInt(lookupIDs[i]);
+      result = actorMap->getValue(searchID);
+      delete searchID;
+      pthread_mutex_unlock(mapMutex);
+      checksum += (unsigned long) result;
+   }
+
+   // Return the checksum of the results
+   return checksum;
+}
+
+
+// Looks up each of the IDs through the registry, returning a value that
+// depends on every result
+unsigned long benchmarkRegistry(PhysXActorRegistry * registry,
+   unsigned int * lookupIDs, int lookupCount)
+{
+   PhysXRigidActor *   result;
+   unsigned long       checksum;
+
+   // Look up each of the IDs the way the exported calls do now, under the
+   // shared lock
+   checksum = 0;
+   for (int i = 0; i < lookupCount; i++)
+   {
+      registry->lockRead();
+      result = registry->getActor(lookupIDs[i]);
+      registry->unlockRead();
+      checksum += (unsigned long) result;
+   }
+
+   // Return the checksum of the results
+   return checksum;
+}
+
+
+int main(int argc, char * argv[])
+{
+   int                    actorCount;
+   int                    lookupCount;
+   char *                 actors;
+   atMap *                actorMap;
+   pthread_mutex_t        mapMutex;
+   PhysXActorRegistry *   registry;
+   unsigned int *         lookupIDs;
+   atTimer                timer;
+   double                 mapTime;
+   double                 registryTime;
+   unsigned long          mapChecksum;
+   unsigned long          registryChecksum;
+
+   // Parse the command line
+   actorCount = BENCHMARK_DEFAULT_ACTORS;
+   lookupCount = BENCHMARK_DEFAULT_LOOKUPS;
+   if (argc > 1)
+      actorCount = atoi(argv[1]);
+   if (argc > 2)
+      lookupCount = atoi(argv[2]);
+   if (actorCount < 1 || lookupCount < 1)
+   {
+      printf("Usage: PhysXLookupBenchmark [actor count] [lookup count]\n");
+      return 1;
+   }
+
+   // Only the addresses of the actors matter to either container, so the
+   // actors are stand-ins: distinct addresses that are never dereferenced
+   actors = new char[actorCount];
+
+   // Fill both containers with the same actors; the map holds the address
+   // in an atInt, as it only holds items
+   actorMap = new atMap();
+   pthread_mutex_init(&mapMutex, NULL);
+   registry = new PhysXActorRegistry(1024);
+   registry->lockWrite();
+   for (int i = 0; i < actorCount; i++)
+   {
+      actorMap->addEntry(new atInt(BENCHMARK_FIRST_ID + i),
+         new atInt(i + 1));
+      registry->addActor(BENCHMARK_FIRST_ID + i,
+         (PhysXRigidActor *) &actors[i]);
+   }
+   registry->unlockWrite();
+
+   // Scatter the lookups over the actors with a fixed seed, so that every
+   // run looks up the same IDs
+   lookupIDs = new unsigned int[lookupCount];
+   srand(1);
+   for (int i = 0; i < lookupCount; i++)
+      lookupIDs[i] = BENCHMARK_FIRST_ID + (rand() % actorCount);
+
+   // Time both of the paths
+   timer.mark();
+   mapChecksum = benchmarkMap(actorMap, &mapMutex, lookupIDs, lookupCount);
+   timer.mark();
+   mapTime = timer.getInterval();
+   timer.mark();
+   registryChecksum = benchmarkRegistry(registry, lookupIDs, lookupCount);
+   timer.mark();
+   registryTime = timer.getInterval();
+
+   // Report the throughput of each path and the gain
+   printf("%d actors, %d lookups\n\n", actorCount, lookupCount);
+   printf("%-10s %12s %14s\n", "", "ns/lookup", "lookups/s");
+   printf("%-10s %12.1f %14.0f\n", "atMap", mapTime * 1.0e9 / lookupCount,
+      lookupCount / mapTime);
+   printf("%-10s %12.1f %14.0f\n", "registry",
+      registryTime * 1.0e9 / lookupCount, lookupCount / registryTime);
+   printf("\nThe registry is %.1f times as fast.\n", mapTime / registryTime);
+   if (mapChecksum == 0 || registryChecksum == 0)
+      printf("(Some lookups failed.)\n");
+
+   // Take the stand-ins back out of the registry, since it deletes the
+   // actors it still holds, and clean up (the map deletes its entries)
+   registry->lockWrite();
+   for (int i = 0; i < actorCount; i++)
+      registry->removeActor(BENCHMARK_FIRST_ID + i);
+   registry->unlockWrite();
+   delete registry;
+   delete actorMap;
+   pthread_mutex_destroy(&mapMutex);
+   delete[] lookupIDs;
+   delete[] actors;
+   return 0;
+}
+
@@ -0,0 +1,137 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// Headless replay tool for call logs written by startRecording(). The tool
+/// re-drives a captured session against the library, on the CPU only and as
+/// fast as possible, and reports how long each simulation step took.
+///
+/// Usage: PhysXReplay <call log> [-frames]
+///
+/// With -frames, the timings of every step are printed as they happen, in
+/// addition to the summary at the end.
+
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "PhysXReplayer.h++"
+
+#include "atTimer.h++"
+
+
+using namespace std;
+
+
+// Prints the distribution of one of the frame timings
+void printTiming(const vector<FrameTimings> & frameTimings,
+   const char * label, float FrameTimings::* member)
+{
+   vector<float>   values;
+   double          total;
+   size_t          count;
+
+   // Gather and sort the values
+   count = frameTimings.size();
+   values.reserve(count);
+   total = 0.0;
+   for (size_t i = 0; i < count; i++)
+   {
+      values.push_back(frameTimings[i].*member);
+      total += frameTimings[i].*member;
+   }
+   sort(values.begin(), values.end());
+
+   // Print the mean and the percentiles
+   printf("%-12s %10.3f %10.3f %10.3f %10.3f %10.3f\n", label,
+      (float) (total / count), values[count / 2], values[count * 9 / 10],
+      values[count * 99 / 100], values[count - 1]);
+}
+
+
+int main(int argc, char * argv[])
+{
+   const char *           logPath;
+   bool                   printFrames;
+   PhysXReplayer          replayer;
+   int                    callCount;
+   vector<FrameTimings>   frameTimings;
+   unsigned int           frameCount;
+   atTimer                replayTimer;
+
+   // Parse the command line
+   logPath = NULL;
+   printFrames = false;
+   for (int i = 1; i < argc; i++)
+   {
+      if (strcmp(argv[i], "-frames") == 0)
+         printFrames = true;
+      else
+         logPath = argv[i];
+   }
+   if (logPath == NULL)
+   {
+      printf("Usage: PhysXReplay <call log> [-frames]\n");
+      return 1;
+   }
+
+   // Initialize the library the same way as the simulator does
+   if (initialize() == 0)
+   {
+      printf("Unable to initialize the PhysX wrapper.\n");
+      return 1;
+   }
+
+   // Issue each of the recorded calls in turn
+   replayer.setPrintFrames(printFrames);
+   replayTimer.mark();
+   callCount = replayer.replayLog(logPath);
+   replayTimer.mark();
+   if (callCount < 0)
+   {
+      release();
+      return 1;
+   }
+
+   // Summarize the session
+   frameTimings = replayer.getFrameTimings();
+   frameCount = (unsigned int) frameTimings.size();
+   printf("\n%d calls, %u frames, %.3f seconds\n", callCount, frameCount,
+      replayTimer.getInterval());
+   if (frameCount > 0)
+   {
+      printf("\n%-12s %10s %10s %10s %10s %10s\n", "(ms)", "mean", "p50",
+         "p90", "p99", "max");
+      printTiming(frameTimings, "simulate", &FrameTimings::simulate_time);
+      printTiming(frameTimings, "fetch", &FrameTimings::fetch_time);
+      printTiming(frameTimings, "update", &FrameTimings::update_time);
+      printTiming(frameTimings, "collision", &FrameTimings::collision_time);
+      printTiming(frameTimings, "frame", &FrameTimings::frame_time);
+   }
+
+   // Clean up the library, which releases every remaining scene before the
+   // replayer releases their arrays
+   release();
+   return 0;
+}
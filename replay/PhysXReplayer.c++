@@ -0,0 +1,767 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "PhysXReplayer.h++"
+
+#include "PhysXRecorder.h++"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// Allocates a pair of arrays of the given type, or a single one used for
+// both if the recorded arrays were the same
+template <class T> void allocatePair(T ** pair, bool same, int count)
+{
+   // Clean up the arrays from a previous call
+   if (pair[1] != pair[0])
+      delete[] pair[1];
+   delete[] pair[0];
+
+   // Allocate the new arrays
+   if (count < 1)
+      count = 1;
+   pair[0] = new T[count];
+   if (same)
+      pair[1] = pair[0];
+   else
+      pair[1] = new T[count];
+}
+
+
+// Releases the structure of arrays layout that collisions are written to
+void releaseArrays(CollisionArrays * arrays)
+{
+   // Release every one of the arrays
+   delete[] arrays->ActorId1;
+   delete[] arrays->ActorId2;
+   delete[] arrays->PositionX;
+   delete[] arrays->PositionY;
+   delete[] arrays->PositionZ;
+   delete[] arrays->NormalX;
+   delete[] arrays->NormalY;
+   delete[] arrays->NormalZ;
+   delete[] arrays->Penetration;
+   delete[] arrays->Impulse;
+   memset(arrays, 0, sizeof(CollisionArrays));
+}
+
+
+// Allocates the structure of arrays layout that collisions are written to
+void allocateArrays(CollisionArrays * arrays, bool withImpulse, int count)
+{
+   // Allocate one array per field
+   if (count < 1)
+      count = 1;
+   arrays->ActorId1 = new unsigned int[count];
+   arrays->ActorId2 = new unsigned int[count];
+   arrays->PositionX = new float[count];
+   arrays->PositionY = new float[count];
+   arrays->PositionZ = new float[count];
+   arrays->NormalX = new float[count];
+   arrays->NormalY = new float[count];
+   arrays->NormalZ = new float[count];
+   arrays->Penetration = new float[count];
+   if (withImpulse)
+      arrays->Impulse = new float[count];
+   else
+      arrays->Impulse = NULL;
+}
+
+
+// Reads the given number of floats into an array
+void readFloatList(CallReader * reader, float * values, int count)
+{
+   // Read the floats in the order that they were recorded
+   for (int i = 0; i < count; i++)
+      values[i] = reader->readFloat();
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+PhysXReplayer::PhysXReplayer()
+{
+   // No scene has been replayed yet, and none of the arrays handed to the
+   // library exist
+   memset(replay_scenes, 0, sizeof(replay_scenes));
+
+   // Each recorded scene keeps its own frame timer
+   for (int i = 0; i <= REPLAY_MAX_SCENES; i++)
+      replay_scenes[i].frame_timer = new atTimer();
+
+   // Only the summary is printed by default
+   print_frames = false;
+}
+
+
+PhysXReplayer::~PhysXReplayer()
+{
+   ReplayScene *   scene;
+
+   // Clean up the arrays of every recorded scene, some of which may be
+   // shared between the two arrays of a pair
+   for (int i = 0; i <= REPLAY_MAX_SCENES; i++)
+   {
+      scene = &replay_scenes[i];
+      if (scene->update_arrays[1] != scene->update_arrays[0])
+         delete[] scene->update_arrays[1];
+      delete[] scene->update_arrays[0];
+      if (scene->collision_arrays[1] != scene->collision_arrays[0])
+         delete[] scene->collision_arrays[1];
+      delete[] scene->collision_arrays[0];
+      if (scene->collision_soa[1].ActorId1 != scene->collision_soa[0].ActorId1)
+         releaseArrays(&scene->collision_soa[1]);
+      releaseArrays(&scene->collision_soa[0]);
+      delete[] scene->failure_array;
+      delete[] scene->command_results;
+      delete[] scene->query_hits;
+      delete scene->frame_timer;
+   }
+}
+
+
+ReplayScene * PhysXReplayer::getReplayScene(unsigned int recordedID)
+{
+   // Handles that are out of range all share the unused first entry, whose
+   // scene handle is 0 and therefore never found by the library
+   if (recordedID > REPLAY_MAX_SCENES)
+      recordedID = 0;
+   return &replay_scenes[recordedID];
+}
+
+
+void PhysXReplayer::replayCall(unsigned int call, CallReader * reader)
+{
+   ReplayScene *          scene;
+   unsigned int           sceneID;
+   unsigned int           recordedID;
+   unsigned int           id;
+   unsigned int           shapeID;
+   unsigned int           otherID;
+   char *                 name;
+   float                  f[16];
+   int                    i[4];
+   bool                   b[2];
+   float *                vertices;
+   int *                  indices;
+   int                    vertexCount;
+   int                    indexCount;
+   float *                arrays[8];
+   int                    arraySize;
+   void *                 data;
+   int                    dataSize;
+   void *                 queries[3];
+   int                    querySizes[3];
+   ActorPosition          position;
+   ActorOrientation       orientation;
+   unsigned int           entityCount;
+   unsigned int           collisionCount;
+   unsigned int           droppedCount;
+   StepTimings            stepTimings;
+   FrameTimings           frame;
+
+   // Every call except for the process-level ones starts with the handle of
+   // the scene it operates on
+   scene = NULL;
+   sceneID = 0;
+   if (call != CALL_CREATE_SHARED_DISPATCHER &&
+       call != CALL_CREATE_SCENE &&
+       call != CALL_RESERVE_DEFAULT_SCENE &&
+       call != CALL_SET_MESH_CACHE_DIRECTORY &&
+       call != CALL_PURGE_MESH_CACHE)
+   {
+      scene = getReplayScene(reader->readUInt());
+      sceneID = scene->scene_id;
+   }
+
+   // Issue the call with the recorded arguments, which have to be read in
+   // the order that they were recorded in
+   switch (call)
+   {
+      case CALL_CREATE_SHARED_DISPATCHER:
+         createSharedDispatcher(reader->readInt());
+         break;
+
+      case CALL_CREATE_SCENE:
+         // The replay always runs on the CPU, so that the timings of a log
+         // don't depend on the machine that it was captured on
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         i[0] = reader->readInt();
+         recordedID = reader->readUInt();
+         sceneID = createScene(false, true, i[0]);
+         if (recordedID != 0)
+            getReplayScene(recordedID)->scene_id = sceneID;
+         break;
+
+      case CALL_RESERVE_DEFAULT_SCENE:
+         getReplayScene(reader->readUInt())->scene_id = getDefaultScene();
+         break;
+
+      case CALL_DESTROY_SCENE:
+         destroyScene(sceneID);
+         scene->scene_id = 0;
+         break;
+
+      case CALL_INIT_ENTITY_UPDATE_BUFFERS:
+         b[0] = reader->readBool();
+         i[0] = reader->readInt();
+         allocatePair(scene->update_arrays, b[0], i[0]);
+         initEntityUpdateBuffersInScene(sceneID, scene->update_arrays[0],
+            scene->update_arrays[1], i[0]);
+         break;
+
+      case CALL_INIT_COLLISION_UPDATE_BUFFERS:
+         b[0] = reader->readBool();
+         i[0] = reader->readInt();
+         allocatePair(scene->collision_arrays, b[0], i[0]);
+         initCollisionUpdateBuffersInScene(sceneID,
+            scene->collision_arrays[0], scene->collision_arrays[1], i[0]);
+         break;
+
+      case CALL_INIT_COLLISION_ARRAYS_UPDATE:
+         // Release the previous layouts, which may share their arrays
+         if (scene->collision_soa[1].ActorId1 !=
+             scene->collision_soa[0].ActorId1)
+            releaseArrays(&scene->collision_soa[1]);
+         releaseArrays(&scene->collision_soa[0]);
+
+         // Allocate layouts shaped like the recorded ones
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         i[0] = reader->readInt();
+         allocateArrays(&scene->collision_soa[0], b[1], i[0]);
+         if (b[0])
+            scene->collision_soa[1] = scene->collision_soa[0];
+         else
+            allocateArrays(&scene->collision_soa[1], b[1], i[0]);
+         initCollisionArraysUpdateInScene(sceneID, &scene->collision_soa[0],
+            &scene->collision_soa[1], i[0]);
+         break;
+
+      case CALL_SET_COLLISION_REPORT_MODE:
+         setCollisionReportModeInScene(sceneID, reader->readInt());
+         break;
+
+      case CALL_GET_DROPPED_COLLISION_COUNT:
+         getDroppedCollisionCountInScene(sceneID);
+         break;
+
+      case CALL_CREATE_ACTOR:
+         id = reader->readUInt();
+         name = reader->readString();
+         readFloatList(reader, f, 3);
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         createActorInScene(sceneID, id, name, f[0], f[1], f[2], b[0], b[1]);
+         break;
+
+      case CALL_ATTACH_SPHERE:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         readFloatList(reader, f, 8);
+         attachSphereInScene(sceneID, id, shapeID, f[0], f[1], f[2], f[3],
+            f[4], f[5], f[6], f[7]);
+         break;
+
+      case CALL_ATTACH_BOX:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         readFloatList(reader, f, 14);
+         attachBoxInScene(sceneID, id, shapeID, f[0], f[1], f[2], f[3], f[4],
+            f[5], f[6], f[7], f[8], f[9], f[10], f[11], f[12], f[13]);
+         break;
+
+      case CALL_ATTACH_CAPSULE:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         readFloatList(reader, f, 13);
+         attachCapsuleInScene(sceneID, id, shapeID, f[0], f[1], f[2], f[3],
+            f[4], f[5], f[6], f[7], f[8], f[9], f[10], f[11], f[12]);
+         break;
+
+      case CALL_ATTACH_TRIANGLE_MESH:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         readFloatList(reader, f, 3);
+         vertices = reader->readFloats(&vertexCount);
+         indices = reader->readInts(&indexCount);
+         readFloatList(reader, &f[3], 7);
+         attachTriangleMeshInScene(sceneID, id, shapeID, f[0], f[1], f[2],
+            vertices, indices, vertexCount / 3, indexCount, f[3], f[4], f[5],
+            f[6], f[7], f[8], f[9]);
+         break;
+
+      case CALL_ATTACH_CONVEX_MESH:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         readFloatList(reader, f, 3);
+         vertices = reader->readFloats(&vertexCount);
+         readFloatList(reader, &f[3], 8);
+         attachConvexMeshInScene(sceneID, id, shapeID, f[0], f[1], f[2],
+            vertices, vertexCount / 3, f[3], f[4], f[5], f[6], f[7], f[8],
+            f[9], f[10]);
+         break;
+
+      case CALL_SET_MESH_CACHE_DIRECTORY:
+         // Meshes are always cooked from scratch, so that the timings don't
+         // depend on what happens to be in the directory
+         reader->readString();
+         break;
+
+      case CALL_PURGE_MESH_CACHE:
+         purgeMeshCache();
+         break;
+
+      case CALL_REMOVE_SHAPE:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         removeShapeInScene(sceneID, id, shapeID);
+         break;
+
+      case CALL_CREATE_ACTOR_SPHERE:
+         id = reader->readUInt();
+         name = reader->readString();
+         readFloatList(reader, f, 3);
+         shapeID = reader->readUInt();
+         readFloatList(reader, &f[3], 5);
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         createActorSphereInScene(sceneID, id, name, f[0], f[1], f[2],
+            shapeID, f[3], f[4], f[5], f[6], f[7], b[0], b[1]);
+         break;
+
+      case CALL_CREATE_ACTOR_BOX:
+         id = reader->readUInt();
+         name = reader->readString();
+         readFloatList(reader, f, 3);
+         shapeID = reader->readUInt();
+         readFloatList(reader, &f[3], 7);
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         createActorBoxInScene(sceneID, id, name, f[0], f[1], f[2], shapeID,
+            f[3], f[4], f[5], f[6], f[7], f[8], f[9], b[0], b[1]);
+         break;
+
+      case CALL_CREATE_ACTOR_CAPSULE:
+         id = reader->readUInt();
+         name = reader->readString();
+         readFloatList(reader, f, 7);
+         shapeID = reader->readUInt();
+         readFloatList(reader, &f[7], 6);
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         createActorCapsuleInScene(sceneID, id, name, f[0], f[1], f[2], f[3],
+            f[4], f[5], f[6], shapeID, f[7], f[8], f[9], f[10], f[11], f[12],
+            b[0], b[1]);
+         break;
+
+      case CALL_CREATE_ACTOR_TRIANGLE_MESH:
+         id = reader->readUInt();
+         name = reader->readString();
+         readFloatList(reader, f, 3);
+         shapeID = reader->readUInt();
+         readFloatList(reader, &f[3], 3);
+         vertices = reader->readFloats(&vertexCount);
+         indices = reader->readInts(&indexCount);
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         createActorTriangleMeshInScene(sceneID, id, name, f[0], f[1], f[2],
+            shapeID, f[3], f[4], f[5], vertices, indices, vertexCount / 3,
+            indexCount, b[0], b[1]);
+         break;
+
+      case CALL_CREATE_ACTOR_CONVEX_MESH:
+         id = reader->readUInt();
+         name = reader->readString();
+         readFloatList(reader, f, 3);
+         shapeID = reader->readUInt();
+         readFloatList(reader, &f[3], 3);
+         vertices = reader->readFloats(&vertexCount);
+         f[6] = reader->readFloat();
+         b[0] = reader->readBool();
+         b[1] = reader->readBool();
+         createActorConvexMeshInScene(sceneID, id, name, f[0], f[1], f[2],
+            shapeID, f[3], f[4], f[5], vertices, vertexCount / 3, f[6], b[0],
+            b[1]);
+         break;
+
+      case CALL_REMOVE_ACTOR:
+         removeActorInScene(sceneID, reader->readUInt());
+         break;
+
+      case CALL_UPDATE_MATERIAL_PROPERTIES:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         readFloatList(reader, f, 3);
+         updateMaterialPropertiesInScene(sceneID, id, shapeID, f[0], f[1],
+            f[2]);
+         break;
+
+      case CALL_GET_ACTOR_MASS:
+         getActorMassInScene(sceneID, reader->readUInt());
+         break;
+
+      case CALL_CLEAR_ALL_FORCES:
+         clearAllForcesInScene(sceneID, reader->readUInt());
+         break;
+
+      case CALL_ADD_FORCE:
+         id = reader->readUInt();
+         readFloatList(reader, f, 3);
+         addForceInScene(sceneID, id, f[0], f[1], f[2]);
+         break;
+
+      case CALL_ADD_TORQUE:
+         id = reader->readUInt();
+         readFloatList(reader, f, 3);
+         addTorqueInScene(sceneID, id, f[0], f[1], f[2]);
+         break;
+
+      case CALL_SET_TRANSFORMATION:
+         id = reader->readUInt();
+         readFloatList(reader, f, 7);
+         setTransformationInScene(sceneID, id, f[0], f[1], f[2], f[3], f[4],
+            f[5], f[6]);
+         break;
+
+      case CALL_SET_POSITION:
+         id = reader->readUInt();
+         position.x = reader->readFloat();
+         position.y = reader->readFloat();
+         position.z = reader->readFloat();
+         setPositionInScene(sceneID, id, position);
+         break;
+
+      case CALL_GET_POSITION:
+         getPositionInScene(sceneID, reader->readUInt());
+         break;
+
+      case CALL_SET_ROTATION:
+         id = reader->readUInt();
+         orientation.x = reader->readFloat();
+         orientation.y = reader->readFloat();
+         orientation.z = reader->readFloat();
+         orientation.w = reader->readFloat();
+         setRotationInScene(sceneID, id, orientation);
+         break;
+
+      case CALL_GET_ROTATION:
+         getRotationInScene(sceneID, reader->readUInt());
+         break;
+
+      case CALL_SET_LINEAR_VELOCITY:
+         id = reader->readUInt();
+         readFloatList(reader, f, 3);
+         setLinearVelocityInScene(sceneID, id, f[0], f[1], f[2]);
+         break;
+
+      case CALL_SET_ANGULAR_VELOCITY:
+         id = reader->readUInt();
+         readFloatList(reader, f, 3);
+         setAngularVelocityInScene(sceneID, id, f[0], f[1], f[2]);
+         break;
+
+      case CALL_SET_GRAVITY:
+         id = reader->readUInt();
+         readFloatList(reader, f, 3);
+         setGravityInScene(sceneID, id, f[0], f[1], f[2]);
+         break;
+
+      case CALL_ENABLE_GRAVITY:
+         id = reader->readUInt();
+         enableGravityInScene(sceneID, id, reader->readBool());
+         break;
+
+      case CALL_SET_LINEAR_DAMPING:
+         id = reader->readUInt();
+         setLinearDampingInScene(sceneID, id, reader->readFloat());
+         break;
+
+      case CALL_SET_ANGULAR_DAMPING:
+         id = reader->readUInt();
+         setAngularDampingInScene(sceneID, id, reader->readFloat());
+         break;
+
+      case CALL_UPDATE_SHAPE_DENSITY:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         updateShapeDensityInScene(sceneID, id, shapeID, reader->readFloat());
+         break;
+
+      case CALL_UPDATE_ACTOR_MASS:
+         id = reader->readUInt();
+         updateActorMassInScene(sceneID, id, reader->readFloat());
+         break;
+
+      case CALL_CREATE_GROUND_PLANE:
+         readFloatList(reader, f, 3);
+         createGroundPlaneInScene(sceneID, f[0], f[1], f[2]);
+         break;
+
+      case CALL_RELEASE_GROUND_PLANE:
+         releaseGroundPlaneInScene(sceneID);
+         break;
+
+      case CALL_SET_HEIGHT_FIELD_TILE_SIZE:
+         setHeightFieldTileSizeInScene(sceneID, reader->readInt());
+         break;
+
+      case CALL_SET_HEIGHT_FIELD:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         i[0] = reader->readInt();
+         i[1] = reader->readInt();
+         readFloatList(reader, f, 2);
+         arrays[0] = reader->readFloats(&arraySize);
+         f[2] = reader->readFloat();
+         setHeightFieldInScene(sceneID, id, shapeID, i[0], i[1], f[0], f[1],
+            arrays[0], f[2]);
+         break;
+
+      case CALL_UPDATE_HEIGHT_FIELD:
+         id = reader->readUInt();
+         for (int j = 0; j < 4; j++)
+            i[j] = reader->readInt();
+         arrays[0] = reader->readFloats(&arraySize);
+         updateHeightFieldInScene(sceneID, id, i[0], i[1], i[2], i[3],
+            arrays[0]);
+         break;
+
+      case CALL_ADD_JOINT:
+         id = reader->readUInt();
+         shapeID = reader->readUInt();
+         otherID = reader->readUInt();
+         for (int j = 0; j < 8; j++)
+            arrays[j] = reader->readFloats(&arraySize);
+         addJointInScene(sceneID, id, shapeID, otherID, arrays[0], arrays[1],
+            arrays[2], arrays[3], arrays[4], arrays[5], arrays[6], arrays[7]);
+         break;
+
+      case CALL_ADD_GLOBAL_FRAME_JOINT:
+         id = reader->readUInt();
+         otherID = reader->readUInt();
+         for (int j = 0; j < 6; j++)
+            arrays[j] = reader->readFloats(&arraySize);
+         addGlobalFrameJointInScene(sceneID, id, otherID, arrays[0],
+            arrays[1], arrays[2], arrays[3], arrays[4], arrays[5]);
+         break;
+
+      case CALL_REMOVE_JOINT:
+         removeJointInScene(sceneID, reader->readUInt());
+         break;
+
+      case CALL_APPLY_COMMANDS:
+         // Make sure that there is room for a result per command
+         data = reader->readData(&dataSize);
+         b[0] = reader->readBool();
+         i[0] = dataSize / (int) sizeof(ActorCommand) + 1;
+         if (b[0] && i[0] > scene->max_command_results)
+         {
+            delete[] scene->command_results;
+            scene->command_results = new unsigned int[i[0]];
+            scene->max_command_results = i[0];
+         }
+         applyCommandsInScene(sceneID, data, dataSize,
+            b[0] ? scene->command_results : NULL);
+         break;
+
+      case CALL_QUEUE_COMMANDS:
+         data = reader->readData(&dataSize);
+         queueCommandsInScene(sceneID, data, dataSize);
+         break;
+
+      case CALL_INIT_COMMAND_FAILURE_UPDATE:
+         i[0] = reader->readInt();
+         delete[] scene->failure_array;
+         scene->failure_array = new CommandFailure[i[0] > 0 ? i[0] : 1];
+         initCommandFailureUpdateInScene(sceneID, scene->failure_array, i[0]);
+         break;
+
+      case CALL_GET_COMMAND_FAILURES:
+         getCommandFailuresInScene(sceneID, &droppedCount);
+         break;
+
+      case CALL_BEGIN_SIMULATE:
+         // The frame starts when the step is handed to PhysX
+         scene->frame_timer->mark();
+         beginSimulateInScene(sceneID, reader->readFloat());
+         break;
+
+      case CALL_POLL_SIMULATE:
+         pollSimulateInScene(sceneID);
+         break;
+
+      case CALL_END_SIMULATE:
+         // Finish the step; a step that wasn't in flight isn't a frame
+         b[0] = reader->readBool();
+         if (endSimulateInScene(sceneID, &entityCount, &collisionCount,
+             b[0] ? &droppedCount : NULL) < 0)
+            break;
+
+         // Collect the timings of the frame
+         scene->frame_timer->mark();
+         getStepTimingsInScene(sceneID, &stepTimings);
+         frame.simulate_time = stepTimings.SimulateTime;
+         frame.fetch_time = stepTimings.FetchTime;
+         frame.update_time = stepTimings.UpdateTime;
+         frame.collision_time = stepTimings.CollisionTime;
+         frame.frame_time = scene->frame_timer->getInterval() * 1000.0f;
+         frame_timings.push_back(frame);
+
+         // Print the frame as it happens, if asked to
+         if (print_frames)
+         {
+            printf("%8u %4u %10.3f %10.3f %10.3f %10.3f %10.3f %7u %7u\n",
+               (unsigned int) frame_timings.size(), sceneID,
+               frame.simulate_time, frame.fetch_time, frame.update_time,
+               frame.collision_time, frame.frame_time, entityCount,
+               collisionCount);
+         }
+         break;
+
+      case CALL_RUN_SCENE_QUERIES:
+         // Make sure that there is room for a result per query, with the
+         // results of the three batches following each other
+         queries[0] = reader->readData(&querySizes[0]);
+         queries[1] = reader->readData(&querySizes[1]);
+         queries[2] = reader->readData(&querySizes[2]);
+         i[0] = querySizes[0] / (int) sizeof(RaycastQuery);
+         i[1] = querySizes[1] / (int) sizeof(SweepQuery);
+         i[2] = querySizes[2] / (int) sizeof(OverlapQuery);
+         i[3] = i[0] + i[1] + i[2] + 1;
+         if (i[3] > scene->max_query_hits)
+         {
+            delete[] scene->query_hits;
+            scene->query_hits = new QueryHit[i[3]];
+            scene->max_query_hits = i[3];
+         }
+         runSceneQueriesInScene(sceneID, (RaycastQuery *) queries[0], i[0],
+            scene->query_hits, (SweepQuery *) queries[1], i[1],
+            &scene->query_hits[i[0]], (OverlapQuery *) queries[2], i[2],
+            &scene->query_hits[i[0] + i[1]]);
+         break;
+
+      default:
+         // A call that this version of the tool doesn't know about; its
+         // arguments are skipped along with the rest of the record
+         printf("Skipping unknown call %u.\n", call);
+         break;
+   }
+}
+
+
+void PhysXReplayer::setPrintFrames(bool printFrames)
+{
+   print_frames = printFrames;
+}
+
+
+int PhysXReplayer::replayLog(const char * path)
+{
+   FILE *              logFile;
+   char                magic[4];
+   unsigned int        version;
+   CallRecordHeader    header;
+   unsigned char *     recordData;
+   unsigned int        recordCapacity;
+   int                 callCount;
+
+   // Open the log and make sure that it has a layout the replayer
+   // understands
+   logFile = fopen(path, "rb");
+   if (logFile == NULL)
+   {
+      printf("Unable to open call log %s.\n", path);
+      return -1;
+   }
+   if (fread(magic, 1, 4, logFile) != 4 ||
+       memcmp(magic, PHYSX_RECORDING_MAGIC, 4) != 0 ||
+       fread(&version, sizeof(version), 1, logFile) != 1 ||
+       version != PHYSX_RECORDING_VERSION)
+   {
+      printf("%s is not a call log of version %d.\n", path,
+         PHYSX_RECORDING_VERSION);
+      fclose(logFile);
+      return -1;
+   }
+
+   // Print the header of the per-frame timings, if asked to
+   if (print_frames)
+   {
+      printf("%8s %4s %10s %10s %10s %10s %10s %7s %7s\n", "frame", "scn",
+         "simulate", "fetch", "update", "collision", "frame", "updates",
+         "collide");
+   }
+
+   // Issue each of the recorded calls in turn
+   recordCapacity = 64 * 1024;
+   recordData = new unsigned char[recordCapacity];
+   callCount = 0;
+   while (fread(&header, sizeof(header), 1, logFile) == 1)
+   {
+      // Make sure that the record fits into the buffer
+      if (header.Size > recordCapacity)
+      {
+         delete[] recordData;
+         while (header.Size > recordCapacity)
+            recordCapacity *= 2;
+         recordData = new unsigned char[recordCapacity];
+      }
+
+      // Read the arguments of the call; a truncated record ends the log,
+      // which happens when the recording process didn't finish its session
+      if (fread(recordData, 1, header.Size, logFile) != header.Size)
+      {
+         printf("The call log ends in a truncated record.\n");
+         break;
+      }
+
+      // Issue the call
+      CallReader   reader(recordData, header.Size);
+      replayCall(header.Call, &reader);
+      callCount++;
+   }
+   fclose(logFile);
+
+   // Clean up the buffer of the records
+   delete[] recordData;
+   return callCount;
+}
+
+
+unsigned int PhysXReplayer::getSceneID(unsigned int recordedID)
+{
+   // Handles that are out of range were never replayed
+   if (recordedID == 0 || recordedID > REPLAY_MAX_SCENES)
+      return 0;
+   return replay_scenes[recordedID].scene_id;
+}
+
+
+const std::vector<FrameTimings> & PhysXReplayer::getFrameTimings()
+{
+   return frame_timings;
+}
+
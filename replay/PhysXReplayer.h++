@@ -0,0 +1,280 @@
+
+// PhysX Wrapper
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library wraps up the native calls to NVIDIA's PhysX API and
+// provides higher-level functions to C# for use.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PHYSX_REPLAYER_H
+#define PHYSX_REPLAYER_H
+
+#include "PhysXLib.h++"
+
+#include "atTimer.h++"
+
+#include <string.h>
+#include <vector>
+
+
+/// The largest scene handle that can appear in a call log.
+#define REPLAY_MAX_SCENES   256
+
+
+/// Struct for the arrays handed to the library on behalf of one recorded
+/// scene, along with the handle that the scene has in the replay.
+///
+struct ReplayScene
+{
+   unsigned int            scene_id;
+   EntityProperties *      update_arrays[2];
+   CollisionProperties *   collision_arrays[2];
+   CollisionArrays         collision_soa[2];
+   CommandFailure *        failure_array;
+   unsigned int *          command_results;
+   int                     max_command_results;
+   QueryHit *              query_hits;
+   int                     max_query_hits;
+   atTimer *               frame_timer;
+};
+
+
+/// Struct for the timings of a single step, in milliseconds.
+///
+struct FrameTimings
+{
+   float   simulate_time;
+   float   fetch_time;
+   float   update_time;
+   float   collision_time;
+   float   frame_time;
+};
+
+
+/// Reads the arguments of a call in the order that they were recorded.
+
+class CallReader
+{
+   protected:
+      unsigned char *   call_data;
+      unsigned int      data_size;
+      unsigned int      read_offset;
+
+      // Returns the next value of four bytes and advances past it
+      unsigned int   readWord()
+      {
+         unsigned int   value;
+
+         // Running off the end of a truncated record yields zeroes
+         value = 0;
+         if (read_offset + 4 <= data_size)
+            memcpy(&value, &call_data[read_offset], 4);
+         read_offset += 4;
+         return value;
+      }
+
+      // Returns the number of bytes of the record that are left to read
+      unsigned int   remaining()
+      {
+         if (read_offset >= data_size)
+            return 0;
+         return data_size - read_offset;
+      }
+
+      // Returns the next block of bytes, padded to four bytes, in place
+      void *   readBlock(unsigned int size)
+      {
+         void *   block;
+
+         // Make sure that the block is actually part of the record; the size
+         // comes from the log, so compare it against what is left rather
+         // than adding it to the offset, which could wrap around
+         if (size > remaining())
+         {
+            read_offset = data_size;
+            return NULL;
+         }
+
+         block = &call_data[read_offset];
+         read_offset += (size + 3) & ~3u;
+         return block;
+      }
+
+   public:
+      CallReader(unsigned char * data, unsigned int size)
+      {
+         call_data = data;
+         data_size = size;
+         read_offset = 0;
+      }
+
+      unsigned int   readUInt() { return readWord(); }
+      int            readInt() { return (int) readWord(); }
+      bool           readBool() { return readWord() != 0; }
+
+      float   readFloat()
+      {
+         unsigned int   word;
+         float          value;
+
+         word = readWord();
+         memcpy(&value, &word, 4);
+         return value;
+      }
+
+      char *   readString()
+      {
+         unsigned int   length;
+
+         // A NULL string has no characters
+         length = readWord();
+         if (length == 0xFFFFFFFF)
+            return NULL;
+         return (char *) readBlock(length + 1);
+      }
+
+      // Returns the next array of words in place, or NULL with a count of
+      // zero if the recorded count doesn't fit in the rest of the record
+      void *   readWords(int * count)
+      {
+         unsigned int   words;
+
+         // A corrupt count, including a negative one, would overflow the
+         // size of the block, so check it before it is multiplied
+         words = readWord();
+         if (words > remaining() / 4)
+         {
+            read_offset = data_size;
+            *count = 0;
+            return NULL;
+         }
+
+         *count = (int) words;
+         return readBlock(words * 4);
+      }
+
+      float *   readFloats(int * count)
+      {
+         return (float *) readWords(count);
+      }
+
+      int *   readInts(int * count)
+      {
+         return (int *) readWords(count);
+      }
+
+      void *   readData(int * size)
+      {
+         unsigned int   count;
+         void *         data;
+
+         // Report an empty block if it doesn't fit in the rest of the record
+         count = readWord();
+         data = readBlock(count);
+         if (data == NULL)
+            count = 0;
+         *size = (int) count;
+         return data;
+      }
+};
+
+
+/// Re-drives the calls of a log written by startRecording() against the
+/// library, on the CPU only and as fast as possible, keeping the timings of
+/// every simulation step.
+///
+/// The library must already be initialized. The arrays handed to the library
+/// on behalf of the recorded scenes belong to the replayer, so the replayed
+/// scenes have to be destroyed, or the library released, before the
+/// replayer is.
+
+class PhysXReplayer
+{
+   protected:
+      /// The state of each recorded scene handle; handles that are out of
+      /// range share the first entry.
+      ///
+      ReplayScene                 replay_scenes[REPLAY_MAX_SCENES + 1];
+
+      /// The timings of every step that was replayed, in order.
+      ///
+      std::vector<FrameTimings>   frame_timings;
+
+      /// Whether the timings of every step are printed as they happen.
+      ///
+      bool                        print_frames;
+
+      /// Returns the replay state of a recorded scene handle.
+      ///
+      /// @param recordedID The handle that the scene had in the log.
+      ///
+      /// @return The state of the scene.
+      ///
+      ReplayScene *   getReplayScene(unsigned int recordedID);
+
+      /// Issues a single recorded call.
+      ///
+      /// @param call The PhysXCall that was recorded.
+      /// @param reader The reader of the recorded arguments.
+      ///
+      void   replayCall(unsigned int call, CallReader * reader);
+
+   public:
+      /// Constructor.
+      ///
+      PhysXReplayer();
+
+      /// Destructor.
+      ///
+      ~PhysXReplayer();
+
+      /// Sets whether the timings of every step are printed as they happen.
+      ///
+      /// @param printFrames True to print every step.
+      ///
+      void   setPrintFrames(bool printFrames);
+
+      /// Issues each of the calls of a log in turn. A truncated record ends
+      /// the log, which happens when the recording process didn't finish its
+      /// session.
+      ///
+      /// @param path The call log.
+      ///
+      /// @return The number of calls that were issued, or -1 if the log
+      /// couldn't be opened or has a layout that isn't understood.
+      ///
+      int   replayLog(const char * path);
+
+      /// Returns the handle that a recorded scene has in the replay.
+      ///
+      /// @param recordedID The handle that the scene had in the log.
+      ///
+      /// @return The handle of the replayed scene, or 0 if the scene doesn't
+      /// exist in the replay.
+      ///
+      unsigned int   getSceneID(unsigned int recordedID);
+
+      /// Returns the timings of every step replayed so far, in order.
+      ///
+      /// @return The timings of the steps.
+      ///
+      const std::vector<FrameTimings> &   getFrameTimings();
+};
+
+#endif
+